@@ -222,12 +222,12 @@ public:
     //==============================================================================
     void getStateInformation (MemoryBlock& destData) override
     {
-        copyXmlToBinary (*apvts.copyState().createXml(), destData);
+        apvts.copyStateToBinary (destData);
     }
 
     void setStateInformation (const void* data, int sizeInBytes) override
     {
-        apvts.replaceState (ValueTree::fromXml (*getXmlFromBinary (data, sizeInBytes)));
+        apvts.replaceStateFromBinary (data, sizeInBytes);
     }
 
     int getCurrentIRSize() const { return irSize; }
@@ -459,6 +459,336 @@ void AudioDataConverters::deinterleaveSamples (const float* source, float** dest
     }
 }
 
+//==============================================================================
+namespace AudioDataVectorHelpers
+{
+   #if JUCE_USE_SSE_INTRINSICS && ! JUCE_BIG_ENDIAN
+    #define JUCE_USE_VECTORISED_SAMPLE_CONVERSION 1
+
+    struct Ops
+    {
+        using IntType   = __m128i;
+        using FloatType = __m128;
+
+        static forcedinline IntType loadInt (const int32* src) noexcept             { return _mm_loadu_si128 ((const __m128i*) src); }
+        static forcedinline void storeInt (int32* dest, IntType v) noexcept         { _mm_storeu_si128 ((__m128i*) dest, v); }
+        static forcedinline FloatType loadFloat (const float* src) noexcept         { return _mm_loadu_ps (src); }
+        static forcedinline void storeFloat (float* dest, FloatType v) noexcept     { _mm_storeu_ps (dest, v); }
+        static forcedinline IntType setInt (int32 a, int32 b, int32 c, int32 d) noexcept        { return _mm_set_epi32 (d, c, b, a); }
+        static forcedinline FloatType setFloat (float a, float b, float c, float d) noexcept    { return _mm_set_ps (d, c, b, a); }
+
+        template <int lane> static forcedinline int32 getInt (IntType v) noexcept        { return _mm_cvtsi128_si32 (_mm_shuffle_epi32 (v, lane)); }
+        template <int lane> static forcedinline float getFloat (FloatType v) noexcept    { return _mm_cvtss_f32 (_mm_shuffle_ps (v, v, lane)); }
+
+        // The integer vectors hold left-justified samples, i.e. the same values as AudioData::Pointer::getAsInt32()
+        static forcedinline IntType loadInt16 (const void* src) noexcept
+        {
+            return _mm_unpacklo_epi16 (_mm_setzero_si128(), _mm_loadl_epi64 ((const __m128i*) src));
+        }
+
+        static forcedinline void storeInt16 (void* dest, IntType v) noexcept
+        {
+            _mm_storel_epi64 ((__m128i*) dest, _mm_packs_epi32 (_mm_srai_epi32 (v, 16), _mm_setzero_si128()));
+        }
+
+        static forcedinline IntType loadInt24 (const void* src) noexcept
+        {
+            int32 lastFourBytes;
+            memcpy (&lastFourBytes, addBytesToPointer (src, 8), 4);
+
+            auto bytes = _mm_or_si128 (_mm_loadl_epi64 ((const __m128i*) src), _mm_slli_si128 (_mm_cvtsi32_si128 (lastFourBytes), 8));
+            auto firstPair  = _mm_unpacklo_epi32 (bytes, _mm_srli_si128 (bytes, 3));
+            auto secondPair = _mm_unpacklo_epi32 (_mm_srli_si128 (bytes, 6), _mm_srli_si128 (bytes, 9));
+
+            return _mm_slli_epi32 (_mm_unpacklo_epi64 (firstPair, secondPair), 8);
+        }
+
+        static forcedinline void storeInt24 (void* dest, IntType v) noexcept
+        {
+            auto samples = _mm_srli_epi32 (v, 8);
+            auto evenLanes = _mm_set_epi32 (0, -1, 0, -1);
+
+            // pack each pair of samples into the bottom 6 bytes of a 64-bit lane, then join the two lanes
+            auto pairs = _mm_or_si128 (_mm_and_si128 (samples, evenLanes), _mm_srli_epi64 (_mm_andnot_si128 (evenLanes, samples), 8));
+            auto packed = _mm_or_si128 (_mm_move_epi64 (pairs), _mm_slli_si128 (_mm_srli_si128 (pairs, 8), 6));
+
+            _mm_storel_epi64 ((__m128i*) dest, packed);
+            auto lastFourBytes = _mm_cvtsi128_si32 (_mm_srli_si128 (packed, 8));
+            memcpy (addBytesToPointer (dest, 8), &lastFourBytes, 4);
+        }
+
+        static forcedinline FloatType intToFloat (IntType v) noexcept
+        {
+            return _mm_mul_ps (_mm_cvtepi32_ps (v), _mm_set1_ps ((float) (1.0 / 2147483648.0)));
+        }
+
+        // This is done in double precision so that it rounds exactly like AudioData::Float32::getAsInt32LE()
+        static forcedinline IntType floatToInt (FloatType v) noexcept
+        {
+            auto convert = [] (__m128d d)
+            {
+                d = _mm_and_pd (d, _mm_cmpord_pd (d, d));
+                d = _mm_max_pd (_mm_min_pd (d, _mm_set1_pd (1.0)), _mm_set1_pd (-1.0));
+                return _mm_cvtpd_epi32 (_mm_mul_pd (d, _mm_set1_pd ((double) 0x7fffffff)));
+            };
+
+            return _mm_unpacklo_epi64 (convert (_mm_cvtps_pd (v)), convert (_mm_cvtps_pd (_mm_movehl_ps (v, v))));
+        }
+    };
+
+   #elif JUCE_USE_ARM_NEON && ! JUCE_BIG_ENDIAN
+    #define JUCE_USE_VECTORISED_SAMPLE_CONVERSION 1
+
+    struct Ops
+    {
+        using IntType   = int32x4_t;
+        using FloatType = float32x4_t;
+
+        static forcedinline IntType loadInt (const int32* src) noexcept             { return vld1q_s32 (src); }
+        static forcedinline void storeInt (int32* dest, IntType v) noexcept         { vst1q_s32 (dest, v); }
+        static forcedinline FloatType loadFloat (const float* src) noexcept         { return vld1q_f32 (src); }
+        static forcedinline void storeFloat (float* dest, FloatType v) noexcept     { vst1q_f32 (dest, v); }
+        static forcedinline IntType setInt (int32 a, int32 b, int32 c, int32 d) noexcept        { const int32 lanes[] = { a, b, c, d }; return vld1q_s32 (lanes); }
+        static forcedinline FloatType setFloat (float a, float b, float c, float d) noexcept    { const float lanes[] = { a, b, c, d }; return vld1q_f32 (lanes); }
+
+        template <int lane> static forcedinline int32 getInt (IntType v) noexcept        { return vgetq_lane_s32 (v, lane); }
+        template <int lane> static forcedinline float getFloat (FloatType v) noexcept    { return vgetq_lane_f32 (v, lane); }
+
+        // The integer vectors hold left-justified samples, i.e. the same values as AudioData::Pointer::getAsInt32()
+        static forcedinline IntType loadInt16 (const void* src) noexcept            { return vshll_n_s16 (vld1_s16 ((const int16*) src), 16); }
+        static forcedinline void storeInt16 (void* dest, IntType v) noexcept        { vst1_s16 ((int16*) dest, vshrn_n_s32 (v, 16)); }
+
+       #if JUCE_64BIT
+        static forcedinline IntType loadInt24 (const void* src) noexcept
+        {
+            static const uint8 shuffle[16] = { 255, 0, 1, 2, 255, 3, 4, 5, 255, 6, 7, 8, 255, 9, 10, 11 };
+
+            uint8 bytes[16] = {};
+            memcpy (bytes, src, 12);
+            return vreinterpretq_s32_u8 (vqtbl1q_u8 (vld1q_u8 (bytes), vld1q_u8 (shuffle)));
+        }
+
+        static forcedinline void storeInt24 (void* dest, IntType v) noexcept
+        {
+            static const uint8 shuffle[16] = { 1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15, 255, 255, 255, 255 };
+
+            uint8 bytes[16];
+            vst1q_u8 (bytes, vqtbl1q_u8 (vreinterpretq_u8_s32 (v), vld1q_u8 (shuffle)));
+            memcpy (dest, bytes, 12);
+        }
+
+        // This is done in double precision so that it rounds exactly like AudioData::Float32::getAsInt32LE()
+        static forcedinline IntType floatToInt (FloatType v) noexcept
+        {
+            auto convert = [] (float64x2_t d)
+            {
+                d = vmaxq_f64 (vminq_f64 (d, vdupq_n_f64 (1.0)), vdupq_n_f64 (-1.0));
+                return vmovn_s64 (vcvtnq_s64_f64 (vmulq_n_f64 (d, (double) 0x7fffffff)));
+            };
+
+            return vcombine_s32 (convert (vcvt_f64_f32 (vget_low_f32 (v))), convert (vcvt_high_f64_f32 (v)));
+        }
+       #else
+        // 32-bit NEON has no table lookups this wide, and no double-precision vectors, so these are done per lane
+        static forcedinline IntType loadInt24 (const void* src) noexcept
+        {
+            int32 lanes[4];
+
+            for (int i = 0; i < 4; ++i)
+                lanes[i] = AudioData::Int24 (const_cast<void*> (addBytesToPointer (src, 3 * i))).getAsInt32LE();
+
+            return loadInt (lanes);
+        }
+
+        static forcedinline void storeInt24 (void* dest, IntType v) noexcept
+        {
+            int32 lanes[4];
+            storeInt (lanes, v);
+
+            for (int i = 0; i < 4; ++i)
+                AudioData::Int24 (addBytesToPointer (dest, 3 * i)).setAsInt32LE (lanes[i]);
+        }
+
+        static forcedinline IntType floatToInt (FloatType v) noexcept
+        {
+            float floats[4];
+            int32 lanes[4];
+            storeFloat (floats, v);
+
+            for (int i = 0; i < 4; ++i)
+                lanes[i] = AudioData::Float32 (floats + i).getAsInt32LE();
+
+            return loadInt (lanes);
+        }
+       #endif
+
+        static forcedinline FloatType intToFloat (IntType v) noexcept
+        {
+            return vmulq_n_f32 (vcvtq_f32_s32 (v), (float) (1.0 / 2147483648.0));
+        }
+    };
+   #endif
+
+   #if JUCE_USE_VECTORISED_SAMPLE_CONVERSION
+    enum { numParallel = 4 };
+
+    static forcedinline Ops::IntType toInt (Ops::IntType v) noexcept          { return v; }
+    static forcedinline Ops::IntType toInt (Ops::FloatType v) noexcept        { return Ops::floatToInt (v); }
+    static forcedinline Ops::FloatType toFloat (Ops::FloatType v) noexcept    { return v; }
+    static forcedinline Ops::FloatType toFloat (Ops::IntType v) noexcept      { return Ops::intToFloat (v); }
+
+    struct Int16Packing
+    {
+        using Format = AudioData::Int16;
+        static forcedinline Ops::IntType load (const void* src) noexcept      { return Ops::loadInt16 (src); }
+        static forcedinline void store (void* dest, Ops::IntType v) noexcept  { Ops::storeInt16 (dest, v); }
+    };
+
+    struct Int24Packing
+    {
+        using Format = AudioData::Int24;
+        static forcedinline Ops::IntType load (const void* src) noexcept      { return Ops::loadInt24 (src); }
+        static forcedinline void store (void* dest, Ops::IntType v) noexcept  { Ops::storeInt24 (dest, v); }
+    };
+
+    struct Int32Packing
+    {
+        using Format = AudioData::Int32;
+        static forcedinline Ops::IntType load (const void* src) noexcept      { return Ops::loadInt ((const int32*) src); }
+        static forcedinline void store (void* dest, Ops::IntType v) noexcept  { Ops::storeInt ((int32*) dest, v); }
+    };
+
+    // Reads and writes numParallel samples at a time. Contiguous samples are moved with vector
+    // loads and stores, and interleaved ones are gathered and scattered one lane at a time.
+    template <class Packing>
+    struct IntSamples
+    {
+        using Format = typename Packing::Format;
+
+        static forcedinline Ops::IntType load (const char* src, int stride) noexcept
+        {
+            if (stride == Format::bytesPerSample)
+                return Packing::load (src);
+
+            return Ops::setInt (getSample (src), getSample (src + stride), getSample (src + 2 * stride), getSample (src + 3 * stride));
+        }
+
+        template <typename VectorType>
+        static forcedinline void store (char* dest, int stride, VectorType v) noexcept
+        {
+            auto ints = toInt (v);
+
+            if (stride == Format::bytesPerSample)
+            {
+                Packing::store (dest, ints);
+                return;
+            }
+
+            setSample (dest,              Ops::getInt<0> (ints));
+            setSample (dest + stride,     Ops::getInt<1> (ints));
+            setSample (dest + 2 * stride, Ops::getInt<2> (ints));
+            setSample (dest + 3 * stride, Ops::getInt<3> (ints));
+        }
+
+    private:
+        static forcedinline int32 getSample (const char* src) noexcept              { return Format (const_cast<char*> (src)).getAsInt32LE(); }
+        static forcedinline void setSample (char* dest, int32 value) noexcept       { Format (dest).setAsInt32LE (value); }
+    };
+
+    struct FloatSamples
+    {
+        static forcedinline Ops::FloatType load (const char* src, int stride) noexcept
+        {
+            if (stride == (int) sizeof (float))
+                return Ops::loadFloat ((const float*) src);
+
+            return Ops::setFloat (getSample (src), getSample (src + stride), getSample (src + 2 * stride), getSample (src + 3 * stride));
+        }
+
+        template <typename VectorType>
+        static forcedinline void store (char* dest, int stride, VectorType v) noexcept
+        {
+            auto floats = toFloat (v);
+
+            if (stride == (int) sizeof (float))
+            {
+                Ops::storeFloat ((float*) dest, floats);
+                return;
+            }
+
+            setSample (dest,              Ops::getFloat<0> (floats));
+            setSample (dest + stride,     Ops::getFloat<1> (floats));
+            setSample (dest + 2 * stride, Ops::getFloat<2> (floats));
+            setSample (dest + 3 * stride, Ops::getFloat<3> (floats));
+        }
+
+    private:
+        static forcedinline float getSample (const char* src) noexcept              { float f; memcpy (&f, src, sizeof (float)); return f; }
+        static forcedinline void setSample (char* dest, float value) noexcept       { memcpy (dest, &value, sizeof (float)); }
+    };
+
+    template <class DestSamples, class SourceSamples>
+    static int convert (void* dest, int destStride, const void* source, int sourceStride, int numSamples) noexcept
+    {
+        auto d = static_cast<char*> (dest);
+        auto s = static_cast<const char*> (source);
+        auto numBlocks = numSamples / numParallel;
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            DestSamples::store (d, destStride, SourceSamples::load (s, sourceStride));
+            d += numParallel * destStride;
+            s += numParallel * sourceStride;
+        }
+
+        return numBlocks * numParallel;
+    }
+
+    template <class DestSamples>
+    static int convertTo (void* dest, int destStride, int sourceFormat, const void* source, int sourceStride, int numSamples) noexcept
+    {
+        switch (sourceFormat)
+        {
+            case AudioData::vectorisedInt16:    return convert<DestSamples, IntSamples<Int16Packing>> (dest, destStride, source, sourceStride, numSamples);
+            case AudioData::vectorisedInt24:    return convert<DestSamples, IntSamples<Int24Packing>> (dest, destStride, source, sourceStride, numSamples);
+            case AudioData::vectorisedInt32:    return convert<DestSamples, IntSamples<Int32Packing>> (dest, destStride, source, sourceStride, numSamples);
+            case AudioData::vectorisedFloat32:  return convert<DestSamples, FloatSamples>             (dest, destStride, source, sourceStride, numSamples);
+            default:                            return 0;
+        }
+    }
+   #endif
+}
+
+int AudioData::convertSamplesVectorised (int destFormat, void* dest, int destStride,
+                                         int sourceFormat, const void* source, int sourceStride,
+                                         int numSamples) noexcept
+{
+   #if JUCE_USE_VECTORISED_SAMPLE_CONVERSION
+    using namespace AudioDataVectorHelpers;
+
+    // Interleaved integer-to-integer conversions are just shuffling bytes around, which the
+    // per-sample loop does as quickly as gathering and scattering the vector lanes would.
+    if (destFormat != vectorisedFloat32 && sourceFormat != vectorisedFloat32)
+    {
+        const int bytesPerSample[] = { 0, 2, 3, 4, 4 };
+
+        if (destStride != bytesPerSample[destFormat] || sourceStride != bytesPerSample[sourceFormat])
+            return 0;
+    }
+
+    switch (destFormat)
+    {
+        case vectorisedInt16:    return convertTo<IntSamples<Int16Packing>> (dest, destStride, sourceFormat, source, sourceStride, numSamples);
+        case vectorisedInt24:    return convertTo<IntSamples<Int24Packing>> (dest, destStride, sourceFormat, source, sourceStride, numSamples);
+        case vectorisedInt32:    return convertTo<IntSamples<Int32Packing>> (dest, destStride, sourceFormat, source, sourceStride, numSamples);
+        case vectorisedFloat32:  return convertTo<FloatSamples>             (dest, destStride, sourceFormat, source, sourceStride, numSamples);
+        default:                 return 0;
+    }
+   #else
+    ignoreUnused (destFormat, dest, destStride, sourceFormat, source, sourceStride, numSamples);
+    return 0;
+   #endif
+}
 
 //==============================================================================
 //==============================================================================
@@ -573,6 +903,143 @@ public:
         }
     };
 
+    //==============================================================================
+    static String getFormatName (const AudioData::Int16*)     { return "Int16"; }
+    static String getFormatName (const AudioData::Int24*)     { return "Int24"; }
+    static String getFormatName (const AudioData::Int32*)     { return "Int32"; }
+    static String getFormatName (const AudioData::Float32*)   { return "Float32"; }
+
+    template <class DestFormat, class SourceFormat>
+    struct VectorisedTest
+    {
+        using Dest   = AudioData::Pointer<DestFormat,   AudioData::LittleEndian, AudioData::Interleaved, AudioData::NonConst>;
+        using Source = AudioData::Pointer<SourceFormat, AudioData::LittleEndian, AudioData::Interleaved, AudioData::Const>;
+
+        // the conversion that convertSamples() used to do for every sample
+        static void convertOneAtATime (Dest d, Source s, int numSamples)
+        {
+            while (--numSamples >= 0)
+            {
+                if (Dest::isFloatingPoint())
+                    d.setAsFloat (s.getAsFloat());
+                else
+                    d.setAsInt32 (s.getAsInt32());
+
+                ++d;
+                ++s;
+            }
+        }
+
+        static void fillWithRandomSamples (MemoryBlock& block, int offset, Random& r)
+        {
+            r.fillBitsRandomly (block.getData(), block.getSize());
+
+            if (Source::isFloatingPoint())
+            {
+                const float specialValues[] = { 0.0f, -0.0f, 1.0f, -1.0f, 1.0e30f, -1.0e30f,
+                                                std::numeric_limits<float>::infinity(),
+                                                -std::numeric_limits<float>::infinity() };
+
+                for (auto i = (size_t) offset; i + sizeof (float) <= block.getSize(); i += sizeof (float))
+                {
+                    auto v = r.nextInt (8) == 0 ? specialValues[r.nextInt (numElementsInArray (specialValues))]
+                                                : r.nextFloat() * 3.0f - 1.5f;
+                    memcpy (addBytesToPointer (block.getData(), i), &v, sizeof (float));
+                }
+            }
+        }
+
+        static void test (UnitTest& unitTest, Random& r)
+        {
+            for (auto numDestChannels : { 1, 2 })
+            {
+                for (auto numSourceChannels : { 1, 3 })
+                {
+                    for (int i = 0; i < 10; ++i)
+                    {
+                        auto numSamples = r.nextInt (300);
+                        auto sourceOffset = r.nextInt (4) + r.nextInt (numSourceChannels) * Source::getBytesPerSample();
+                        auto destOffset   = r.nextInt (4) + r.nextInt (numDestChannels)   * Dest::getBytesPerSample();
+
+                        MemoryBlock source ((size_t) (sourceOffset + numSamples * numSourceChannels * Source::getBytesPerSample()));
+                        MemoryBlock expected ((size_t) (destOffset + numSamples * numDestChannels * Dest::getBytesPerSample()));
+                        fillWithRandomSamples (source, sourceOffset, r);
+                        r.fillBitsRandomly (expected.getData(), expected.getSize());
+                        auto actual = expected;
+
+                        Source s (addBytesToPointer (source.getData(), sourceOffset), numSourceChannels);
+                        convertOneAtATime (Dest (addBytesToPointer (expected.getData(), destOffset), numDestChannels), s, numSamples);
+                        Dest (addBytesToPointer (actual.getData(), destOffset), numDestChannels).convertSamples (s, numSamples);
+
+                        unitTest.expect (actual == expected, getFormatName ((SourceFormat*) nullptr) + " -> " + getFormatName ((DestFormat*) nullptr)
+                                                               + ", " + String (numSourceChannels) + " -> " + String (numDestChannels) + " channels");
+                    }
+                }
+            }
+
+            // narrowing conversions can also be done in-place
+            if (Dest::getBytesPerSample() <= Source::getBytesPerSample())
+            {
+                for (auto numChannels : { 1, 2 })
+                {
+                    auto numSamples = 200 + r.nextInt (100);
+                    MemoryBlock expected ((size_t) (numSamples * numChannels * Source::getBytesPerSample()));
+                    fillWithRandomSamples (expected, 0, r);
+                    auto actual = expected;
+
+                    convertOneAtATime (Dest (expected.getData(), numChannels), Source (expected.getData(), numChannels), numSamples);
+                    Dest (actual.getData(), numChannels).convertSamples (Source (actual.getData(), numChannels), numSamples);
+
+                    unitTest.expect (actual == expected, "In-place " + getFormatName ((SourceFormat*) nullptr) + " -> " + getFormatName ((DestFormat*) nullptr));
+                }
+            }
+        }
+
+        static String benchmark (Random& r)
+        {
+            constexpr int numSamples = 8192, numRepeats = 100, numChannels = 2;
+
+            MemoryBlock source ((size_t) (numSamples * numChannels * Source::getBytesPerSample()));
+            MemoryBlock dest   ((size_t) (numSamples * numChannels * Dest::getBytesPerSample()));
+            fillWithRandomSamples (source, 0, r);
+
+            auto measure = [&] (int numSourceChannels, int numDestChannels, bool oneAtATime)
+            {
+                Source s (source.getData(), numSourceChannels);
+                Dest d (dest.getData(), numDestChannels);
+
+                auto start = Time::getHighResolutionTicks();
+
+                for (int i = 0; i < numRepeats; ++i)
+                {
+                    if (oneAtATime)
+                        convertOneAtATime (d, s, numSamples);
+                    else
+                        d.convertSamples (s, numSamples);
+                }
+
+                return String (Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) * 1000.0, 2);
+            };
+
+            String result (getFormatName ((SourceFormat*) nullptr) + " -> " + getFormatName ((DestFormat*) nullptr) + ":");
+
+            for (auto layout : { std::make_pair (1, 1), std::make_pair (numChannels, 1), std::make_pair (1, numChannels) })
+                result << "  " << layout.first << "->" << layout.second << " channels "
+                       << measure (layout.first, layout.second, true) << " -> " << measure (layout.first, layout.second, false) << " ms";
+
+            return result;
+        }
+    };
+
+    template <class DestFormat>
+    void testVectorisedConversionsTo (Random& r)
+    {
+        VectorisedTest<DestFormat, AudioData::Int16>::test (*this, r);
+        VectorisedTest<DestFormat, AudioData::Int24>::test (*this, r);
+        VectorisedTest<DestFormat, AudioData::Int32>::test (*this, r);
+        VectorisedTest<DestFormat, AudioData::Float32>::test (*this, r);
+    }
+
     void runTest() override
     {
         auto r = getRandom();
@@ -586,11 +1053,48 @@ public:
         Test1 <AudioData::Int32>::test (*this, r);
         beginTest ("Round-trip conversion: Float32");
         Test1 <AudioData::Float32>::test (*this, r);
+
+        beginTest ("Vectorised conversions match per-sample conversions");
+        testVectorisedConversionsTo<AudioData::Int16> (r);
+        testVectorisedConversionsTo<AudioData::Int24> (r);
+        testVectorisedConversionsTo<AudioData::Int32> (r);
+        testVectorisedConversionsTo<AudioData::Float32> (r);
     }
 };
 
 static AudioConversionTests audioConversionUnitTests;
 
+//==============================================================================
+class AudioConversionBenchmark  : public UnitTest
+{
+public:
+    AudioConversionBenchmark()
+        : UnitTest ("Audio data conversion benchmark", UnitTestCategories::benchmarks)
+    {}
+
+    template <class DestFormat>
+    void benchmarkConversionsTo (Random& r)
+    {
+        logMessage (AudioConversionTests::VectorisedTest<DestFormat, AudioData::Int16>::benchmark (r));
+        logMessage (AudioConversionTests::VectorisedTest<DestFormat, AudioData::Int24>::benchmark (r));
+        logMessage (AudioConversionTests::VectorisedTest<DestFormat, AudioData::Int32>::benchmark (r));
+        logMessage (AudioConversionTests::VectorisedTest<DestFormat, AudioData::Float32>::benchmark (r));
+    }
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        beginTest ("Per-sample -> vectorised, 100 x 8192 samples");
+        benchmarkConversionsTo<AudioData::Int16> (r);
+        benchmarkConversionsTo<AudioData::Int24> (r);
+        benchmarkConversionsTo<AudioData::Int32> (r);
+        benchmarkConversionsTo<AudioData::Float32> (r);
+    }
+};
+
+static AudioConversionBenchmark audioConversionBenchmark;
+
 #endif
 
 } // namespace juce
@@ -320,6 +320,25 @@ public:
         static void* toVoidPtr (VoidType* v) noexcept { return const_cast<void*> (v); }
         enum { isConst = 1 };
     };
+
+    //==============================================================================
+    // The formats which Pointer::convertSamples() can convert using SIMD instructions
+    enum VectorisedFormat { notVectorised = 0, vectorisedInt16, vectorisedInt24, vectorisedInt32, vectorisedFloat32 };
+
+    template <class SampleFormatType>
+    static constexpr int getVectorisedFormat (const SampleFormatType*) noexcept  { return notVectorised; }
+    static constexpr int getVectorisedFormat (const Int16*) noexcept             { return vectorisedInt16; }
+    static constexpr int getVectorisedFormat (const Int24*) noexcept             { return vectorisedInt24; }
+    static constexpr int getVectorisedFormat (const Int32*) noexcept             { return vectorisedInt32; }
+    static constexpr int getVectorisedFormat (const Float32*) noexcept           { return vectorisedFloat32; }
+
+    /** Converts as many little-endian samples as it can using SIMD instructions, and returns the number
+        it has converted. Any remaining samples must be converted by the caller, one at a time.
+        The strides are the number of bytes between the start of each sample.
+    */
+    static int convertSamplesVectorised (int destFormat, void* dest, int destStride,
+                                         int sourceFormat, const void* source, int sourceStride,
+                                         int numSamples) noexcept;
   #endif
 
     //==============================================================================
@@ -465,6 +484,16 @@ public:
 
             if (source.getRawData() != getRawData() || source.getNumBytesBetweenSamples() >= getNumBytesBetweenSamples())
             {
+                if (getVectorisedFormat() != notVectorised && OtherPointerType::getVectorisedFormat() != notVectorised)
+                {
+                    auto numConverted = convertSamplesVectorised (getVectorisedFormat(), dest.data.data, dest.getNumBytesBetweenSamples(),
+                                                                  OtherPointerType::getVectorisedFormat(), source.getRawData(),
+                                                                  source.getNumBytesBetweenSamples(), numSamples);
+                    dest += numConverted;
+                    source += numConverted;
+                    numSamples -= numConverted;
+                }
+
                 while (--numSamples >= 0)
                 {
                     Endianness::copyFrom (dest.data, source);
@@ -567,8 +596,15 @@ public:
 
     private:
         //==============================================================================
+        template <typename, typename, typename, typename> friend class Pointer;
+
         SampleFormat data;
 
+        static constexpr int getVectorisedFormat() noexcept
+        {
+            return Endianness::isBigEndian ? (int) notVectorised : AudioData::getVectorisedFormat ((SampleFormat*) nullptr);
+        }
+
         inline void advance() noexcept                          { this->advanceData (data); }
 
         Pointer operator++ (int); // private to force you to use the more efficient pre-increment!
@@ -62,6 +62,7 @@
 #include "utilities/juce_WindowedSincInterpolator.cpp"
 #include "utilities/juce_Interpolators.cpp"
 #include "utilities/juce_SmoothedValue.cpp"
+#include "utilities/juce_AudioWorkerPool.cpp"
 #include "midi/juce_MidiBuffer.cpp"
 #include "midi/juce_MidiFile.cpp"
 #include "midi/juce_MidiKeyboardState.cpp"
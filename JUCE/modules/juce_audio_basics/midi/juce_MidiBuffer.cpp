@@ -70,7 +70,7 @@ namespace MidiBufferHelpers
         return 0;
     }
 
-    static uint8* findEventAfter (uint8* d, uint8* endData, int samplePosition) noexcept
+    static const uint8* findEventAfter (const uint8* d, const uint8* endData, int samplePosition) noexcept
     {
         while (d < endData && getEventTime (d) <= samplePosition)
             d += getEventTotalSize (d);
@@ -106,8 +106,18 @@ MidiBuffer::MidiBuffer (const MidiMessage& message) noexcept
     addEvent (message, 0);
 }
 
-void MidiBuffer::swapWith (MidiBuffer& other) noexcept      { data.swapWith (other.data); }
-void MidiBuffer::clear() noexcept                           { data.clearQuick(); }
+void MidiBuffer::swapWith (MidiBuffer& other) noexcept
+{
+    data.swapWith (other.data);
+    std::swap (lastEventOffset, other.lastEventOffset);
+}
+
+void MidiBuffer::clear() noexcept
+{
+    data.clearQuick();
+    lastEventOffset = -1;
+}
+
 void MidiBuffer::ensureSize (size_t minimumNumBytes)        { data.ensureStorageAllocated ((int) minimumNumBytes); }
 bool MidiBuffer::isEmpty() const noexcept                   { return data.size() == 0; }
 
@@ -117,6 +127,52 @@ void MidiBuffer::clear (int startSample, int numSamples)
     auto end   = MidiBufferHelpers::findEventAfter (start,        data.end(), startSample + numSamples - 1);
 
     data.removeRange ((int) (start - data.begin()), (int) (end - start));
+    lastEventOffset = -1;
+}
+
+int MidiBuffer::getLastEventOffset() const noexcept
+{
+    // The data is public, so check that the cached offset still points at an event that ends the buffer
+    if (lastEventOffset >= 0
+         && lastEventOffset + (int) (sizeof (int32) + sizeof (uint16)) <= data.size()
+         && lastEventOffset + MidiBufferHelpers::getEventTotalSize (data.begin() + lastEventOffset) == data.size())
+        return lastEventOffset;
+
+    return -1;
+}
+
+int MidiBuffer::findInsertionPoint (int startOffset, int sampleNumber) const noexcept
+{
+    auto last = getLastEventOffset();
+
+    if (last >= 0 && MidiBufferHelpers::getEventTime (data.begin() + last) <= sampleNumber)
+        return data.size();
+
+    return (int) (MidiBufferHelpers::findEventAfter (data.begin() + startOffset, data.end(), sampleNumber) - data.begin());
+}
+
+void MidiBuffer::insertEvent (int offset, const void* eventData, int numBytes, int sampleNumber)
+{
+    auto newItemSize = (int) ((size_t) numBytes + sizeof (int32) + sizeof (uint16));
+
+    // This buffer has grown beyond the size it was given with ensureSize(), so it's
+    // going to allocate. If this happens on the audio thread, make the buffer bigger!
+    jassert (! assertOnAllocation || data.size() + newItemSize <= data.getNumAllocated());
+
+    auto last = getLastEventOffset();
+    auto isAppending = (offset == data.size());
+
+    data.insertMultiple (offset, 0, newItemSize);
+
+    auto* d = data.begin() + offset;
+    writeUnaligned<int32>  (d, sampleNumber);
+    d += sizeof (int32);
+    writeUnaligned<uint16> (d, static_cast<uint16> (numBytes));
+    d += sizeof (uint16);
+    memcpy (d, eventData, (size_t) numBytes);
+
+    lastEventOffset = isAppending ? offset
+                                  : (last >= 0 ? last + newItemSize : -1);
 }
 
 void MidiBuffer::addEvent (const MidiMessage& m, int sampleNumber)
@@ -129,24 +185,15 @@ void MidiBuffer::addEvent (const void* newData, int maxBytes, int sampleNumber)
     auto numBytes = MidiBufferHelpers::findActualEventLength (static_cast<const uint8*> (newData), maxBytes);
 
     if (numBytes > 0)
-    {
-        auto newItemSize = (size_t) numBytes + sizeof (int32) + sizeof (uint16);
-        auto offset = (int) (MidiBufferHelpers::findEventAfter (data.begin(), data.end(), sampleNumber) - data.begin());
-
-        data.insertMultiple (offset, 0, (int) newItemSize);
-
-        auto* d = data.begin() + offset;
-        writeUnaligned<int32>  (d, sampleNumber);
-        d += sizeof (int32);
-        writeUnaligned<uint16> (d, static_cast<uint16> (numBytes));
-        d += sizeof (uint16);
-        memcpy (d, newData, (size_t) numBytes);
-    }
+        insertEvent (findInsertionPoint (0, sampleNumber), newData, numBytes, sampleNumber);
 }
 
 void MidiBuffer::addEvents (const MidiBuffer& otherBuffer,
                             int startSample, int numSamples, int sampleDeltaToAdd)
 {
+    // The source events are in order, so each one goes somewhere after the previous one
+    int searchStart = 0;
+
     for (auto i = otherBuffer.findNextSamplePosition (startSample); i != otherBuffer.cend(); ++i)
     {
         const auto metadata = *i;
@@ -154,8 +201,82 @@ void MidiBuffer::addEvents (const MidiBuffer& otherBuffer,
         if (metadata.samplePosition >= startSample + numSamples && numSamples >= 0)
             break;
 
-        addEvent (metadata.data, metadata.numBytes, metadata.samplePosition + sampleDeltaToAdd);
+        auto numBytes = MidiBufferHelpers::findActualEventLength (metadata.data, metadata.numBytes);
+
+        if (numBytes > 0)
+        {
+            auto sampleNumber = metadata.samplePosition + sampleDeltaToAdd;
+            auto offset = findInsertionPoint (searchStart, sampleNumber);
+
+            insertEvent (offset, metadata.data, numBytes, sampleNumber);
+            searchStart = offset + MidiBufferHelpers::getEventTotalSize (data.begin() + offset);
+        }
+    }
+}
+
+void MidiBuffer::mergeFrom (const MidiBuffer* const* sourceBuffers, int numSourceBuffers)
+{
+    clear();
+
+    // Merging more buffers than this at once is unusual, so any others are just added afterwards
+    constexpr int maxBuffersToMerge = 16;
+
+    struct Source
+    {
+        const uint8* next;
+        const uint8* end;
+    };
+
+    Source sources[maxBuffersToMerge];
+    int numSources = 0, totalSize = 0;
+
+    for (int i = 0; i < jmin (numSourceBuffers, maxBuffersToMerge); ++i)
+    {
+        auto& source = *sourceBuffers[i];
+        jassert (&source != this);
+
+        if (! source.isEmpty())
+        {
+            sources[numSources++] = { source.data.begin(), source.data.end() };
+            totalSize += source.data.size();
+        }
+    }
+
+    // This buffer has grown beyond the size it was given with ensureSize(), so it's
+    // going to allocate. If this happens on the audio thread, make the buffer bigger!
+    jassert (! assertOnAllocation || totalSize <= data.getNumAllocated());
+
+    data.resize (totalSize);
+    auto* d = data.begin();
+
+    while (numSources > 0)
+    {
+        // Taking the earliest source on a tie keeps simultaneous events in the order of their buffers
+        int earliest = 0;
+
+        for (int i = 1; i < numSources; ++i)
+            if (MidiBufferHelpers::getEventTime (sources[i].next) < MidiBufferHelpers::getEventTime (sources[earliest].next))
+                earliest = i;
+
+        auto& source = sources[earliest];
+        auto size = MidiBufferHelpers::getEventTotalSize (source.next);
+
+        memcpy (d, source.next, size);
+        lastEventOffset = (int) (d - data.begin());
+        d += size;
+        source.next += size;
+
+        if (source.next >= source.end)
+        {
+            for (int i = earliest + 1; i < numSources; ++i)
+                sources[i - 1] = sources[i];
+
+            --numSources;
+        }
     }
+
+    for (int i = maxBuffersToMerge; i < numSourceBuffers; ++i)
+        addEvents (*sourceBuffers[i], 0, -1, 0);
 }
 
 int MidiBuffer::getNumEvents() const noexcept
@@ -179,6 +300,11 @@ int MidiBuffer::getLastEventTime() const noexcept
     if (data.size() == 0)
         return 0;
 
+    auto last = getLastEventOffset();
+
+    if (last >= 0)
+        return MidiBufferHelpers::getEventTime (data.begin() + last);
+
     auto endData = data.end();
 
     for (auto d = data.begin();;)
@@ -298,6 +424,187 @@ struct MidiBufferTest  : public UnitTest
                 expectEquals (buffer.getNumEvents(), 1);
             }
         }
+
+        beginTest ("Events are kept in order");
+        {
+            Random random (1);
+            MidiBuffer buffer;
+            Array<Event> expected;
+
+            for (int i = 0; i < 500; ++i)
+            {
+                // mostly in order, with some going back in time
+                const auto time = random.nextInt (10) == 0 ? random.nextInt (1000) : 2 * i;
+                const auto message = MidiMessage::noteOn (1, i % 128, (uint8) 100);
+
+                buffer.addEvent (message, time);
+                insertSorted (expected, { time, message });
+
+                if (i % 100 == 50)
+                {
+                    buffer.clear (time, 10);
+                    removeRange (expected, time, 10);
+                }
+            }
+
+            expectEquals (buffer.getLastEventTime(), expected.getLast().time);
+            expectMatches (buffer, expected);
+
+            // changing the raw data must not leave it confused about where the end is
+            buffer.data.clear();
+            buffer.addEvent (MidiMessage::noteOff (1, 3), 5);
+            buffer.addEvent (MidiMessage::noteOff (1, 4), 2);
+            expected.clearQuick();
+            expected.add ({ 2, MidiMessage::noteOff (1, 4) });
+            expected.add ({ 5, MidiMessage::noteOff (1, 3) });
+            expectMatches (buffer, expected);
+            expectEquals (buffer.getLastEventTime(), 5);
+        }
+
+        beginTest ("Adding events from another buffer merges them in");
+        {
+            Random random (2);
+
+            for (int iteration = 0; iteration < 20; ++iteration)
+            {
+                MidiBuffer buffer, other;
+                Array<Event> expected;
+
+                for (auto* b : { &buffer, &other })
+                {
+                    for (int i = 0; i < 100; ++i)
+                    {
+                        const auto time = random.nextInt (200);
+                        b->addEvent (MidiMessage::controllerEvent (1 + (b == &other ? 1 : 0), i, i), time);
+                    }
+                }
+
+                for (const auto metadata : buffer)
+                    expected.add ({ metadata.samplePosition, metadata.getMessage() });
+
+                const auto start = random.nextInt (100), numSamples = random.nextInt (150) - 10, delta = random.nextInt (20) - 10;
+
+                for (const auto metadata : other)
+                    if (metadata.samplePosition >= start && (numSamples < 0 || metadata.samplePosition < start + numSamples))
+                        insertSorted (expected, { metadata.samplePosition + delta, metadata.getMessage() });
+
+                buffer.addEvents (other, start, numSamples, delta);
+                expectMatches (buffer, expected);
+            }
+        }
+
+        beginTest ("Several buffers can be merged at once");
+        {
+            Random random (3);
+
+            for (auto numSources : { 0, 1, 3, 16, 20 })
+            {
+                OwnedArray<MidiBuffer> sources;
+                Array<const MidiBuffer*> sourcePointers;
+                MidiBuffer expectedBuffer;
+
+                for (int i = 0; i < numSources; ++i)
+                {
+                    auto* source = sources.add (new MidiBuffer());
+                    sourcePointers.add (source);
+
+                    for (int n = random.nextInt (50); --n >= 0;)
+                        source->addEvent (MidiMessage::noteOn (1 + i % 16, n, (uint8) 64), random.nextInt (100));
+
+                    expectedBuffer.addEvents (*source, 0, -1, 0);
+                }
+
+                Array<Event> expected;
+
+                for (const auto metadata : expectedBuffer)
+                    expected.add ({ metadata.samplePosition, metadata.getMessage() });
+
+                MidiBuffer merged;
+                merged.addEvent (MidiMessage::allNotesOff (1), 0);
+                merged.mergeFrom (sourcePointers.begin(), sourcePointers.size());
+                expectMatches (merged, expected);
+
+                if (! expected.isEmpty())
+                    expectEquals (merged.getLastEventTime(), expected.getLast().time);
+
+                // and it carries on appending from the right place
+                merged.addEvent (MidiMessage::allNotesOff (2), 1000);
+                expectEquals (merged.getLastEventTime(), 1000);
+            }
+        }
+
+        beginTest ("A copied buffer can be added to");
+        {
+            MidiBuffer buffer;
+            buffer.ensureSize (1024);
+            Array<Event> expected;
+
+            for (int i = 0; i < 10; ++i)
+            {
+                buffer.addEvent (MidiMessage::noteOn (1, i, (uint8) 100), 10 * i);
+                expected.add ({ 10 * i, MidiMessage::noteOn (1, i, (uint8) 100) });
+            }
+
+            // the copy only gets enough storage for its events, so it has to reserve its own
+            auto copy = buffer;
+            expectLessThan (copy.data.getNumAllocated(), 1024);
+
+            copy.ensureSize (1024);
+            const auto* storage = copy.data.begin();
+
+            copy.addEvent (MidiMessage::noteOff (1, 0), 95);
+            copy.addEvent (MidiMessage::noteOff (1, 1), 5);
+            expect (copy.data.begin() == storage);
+
+            expectMatches (buffer, expected);
+            expectEquals (buffer.getLastEventTime(), 90);
+
+            insertSorted (expected, { 95, MidiMessage::noteOff (1, 0) });
+            insertSorted (expected, { 5, MidiMessage::noteOff (1, 1) });
+            expectMatches (copy, expected);
+            expectEquals (copy.getLastEventTime(), 95);
+        }
+    }
+
+private:
+    struct Event
+    {
+        int time;
+        MidiMessage message;
+    };
+
+    // Events at the same time stay in the order they were added
+    static void insertSorted (Array<Event>& events, const Event& event)
+    {
+        int index = 0;
+
+        while (index < events.size() && events.getReference (index).time <= event.time)
+            ++index;
+
+        events.insert (index, event);
+    }
+
+    static void removeRange (Array<Event>& events, int start, int numSamples)
+    {
+        events.removeIf ([&] (const Event& e) { return e.time >= start && e.time < start + numSamples; });
+    }
+
+    void expectMatches (const MidiBuffer& buffer, const Array<Event>& expected)
+    {
+        expectEquals (buffer.getNumEvents(), expected.size());
+
+        int index = 0;
+
+        for (const auto metadata : buffer)
+        {
+            if (index >= expected.size())
+                break;
+
+            const auto& e = expected.getReference (index++);
+            expectEquals (metadata.samplePosition, e.time);
+            expect (metadata.numBytes == e.message.getRawDataSize()
+                     && std::memcmp (metadata.data, e.message.getRawData(), (size_t) metadata.numBytes) == 0);
+        }
     }
 };
 
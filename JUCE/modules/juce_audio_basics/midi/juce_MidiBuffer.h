@@ -184,6 +184,9 @@ public:
         If an event is added whose sample position is the same as one or more events
         already in the buffer, the new event will be placed after the existing ones.
 
+        Adding an event that comes at or after the last one in the buffer is quick, as
+        it's just appended, so it's best to add events in order where possible.
+
         To retrieve events, use a MidiBufferIterator object
     */
     void addEvent (const MidiMessage& midiMessage, int sampleNumber);
@@ -221,12 +224,26 @@ public:
                                     startSample will be taken.
         @param sampleDeltaToAdd     a value which will be added to the source timestamps of the events
                                     that are added to this buffer
+
+        The events are merged into this buffer in a single pass, rather than each one being
+        searched for from the start.
     */
     void addEvents (const MidiBuffer& otherBuffer,
                     int startSample,
                     int numSamples,
                     int sampleDeltaToAdd);
 
+    /** Replaces the contents of this buffer with all the events from several other buffers,
+        merged into order.
+
+        This is much quicker than clearing the buffer and calling addEvents() for each source,
+        as each event only gets copied once. Events that have the same sample position stay
+        in the order of the buffers they came from.
+
+        None of the source buffers can be this buffer.
+    */
+    void mergeFrom (const MidiBuffer* const* sourceBuffers, int numSourceBuffers);
+
     /** Returns the sample number of the first event in the buffer.
         If the buffer's empty, this will just return 0.
     */
@@ -248,9 +265,20 @@ public:
     /** Preallocates some memory for the buffer to use.
         This helps to avoid needing to reallocate space when the buffer has messages
         added to it.
+
+        @see setAssertOnAllocation
     */
     void ensureSize (size_t minimumNumBytes);
 
+    /** Makes the buffer assert if it ever needs to grow beyond the size it was given
+        with ensureSize().
+
+        Turn this on for a buffer that's used on the audio thread, once its size has
+        been reserved in prepareToPlay(), to catch any events that would make it
+        allocate. It has no effect in release builds.
+    */
+    void setAssertOnAllocation (bool shouldAssert) noexcept      { assertOnAllocation = shouldAssert; }
+
     /** Get a read-only iterator pointing to the beginning of this buffer. */
     MidiBufferIterator begin()  const noexcept { return cbegin(); }
 
@@ -340,6 +368,15 @@ public:
     Array<uint8> data;
 
 private:
+    // The offset of the last event, so that events can be appended without searching,
+    // or -1 if it isn't known
+    int lastEventOffset = -1;
+    bool assertOnAllocation = false;
+
+    int getLastEventOffset() const noexcept;
+    void insertEvent (int offset, const void* eventData, int numBytes, int sampleNumber);
+    int findInsertionPoint (int startOffset, int sampleNumber) const noexcept;
+
     JUCE_LEAK_DETECTOR (MidiBuffer)
 };
 
@@ -261,12 +261,14 @@ void MPESynthesiser::addVoice (MPESynthesiserVoice* const newVoice)
     const ScopedLock sl (voicesLock);
     newVoice->setCurrentSampleRate (getSampleRate());
     voices.add (newVoice);
+    prepareParallelRendering();
 }
 
 void MPESynthesiser::clearVoices()
 {
     const ScopedLock sl (voicesLock);
     voices.clear();
+    prepareParallelRendering();
 }
 
 MPESynthesiserVoice* MPESynthesiser::getVoice (const int index) const
@@ -279,6 +281,7 @@ void MPESynthesiser::removeVoice (const int index)
 {
     const ScopedLock sl (voicesLock);
     voices.remove (index);
+    prepareParallelRendering();
 }
 
 void MPESynthesiser::reduceNumVoices (const int newNumVoices)
@@ -313,10 +316,59 @@ void MPESynthesiser::turnOffAllVoices (bool allowTailOff)
 }
 
 //==============================================================================
+void MPESynthesiser::setParallelVoiceRendering (int numWorkerThreads, int maximumBlockSize, int maximumNumChannels)
+{
+    jassert (numWorkerThreads >= 0 && maximumBlockSize > 0 && maximumNumChannels > 0);
+
+    std::unique_ptr<AudioWorkerPool> newPool;
+
+    if (numWorkerThreads > 0)
+        newPool.reset (new AudioWorkerPool (numWorkerThreads));
+
+    {
+        const ScopedLock sl (voicesLock);
+        std::swap (workerPool, newPool);
+        parallelBlockSize = maximumBlockSize;
+        parallelNumChannels = maximumNumChannels;
+        prepareParallelRendering();
+    }
+
+    // (the old pool's threads are stopped outside the lock)
+}
+
+void MPESynthesiser::prepareParallelRendering()
+{
+    if (workerPool != nullptr)
+    {
+        workerPool->prepareScratchBuffers (voices.size(), parallelNumChannels, parallelBlockSize);
+        voicesToRender.ensureStorageAllocated (voices.size());
+    }
+}
+
+template <typename floatType>
+bool MPESynthesiser::renderVoicesInParallel (AudioBuffer<floatType>& buffer, int startSample, int numSamples)
+{
+    // (the storage was allocated by prepareParallelRendering)
+    voicesToRender.clearQuick();
+
+    for (auto* voice : voices)
+        if (voice->isActive())
+            voicesToRender.add (voice);
+
+    return workerPool->renderAndMix (buffer, startSample, numSamples, voicesToRender.size(),
+                                     [this] (int index, AudioBuffer<floatType>& scratch)
+                                     {
+                                         voicesToRender.getUnchecked (index)->renderNextBlock (scratch, 0, scratch.getNumSamples());
+                                     });
+}
+
 void MPESynthesiser::renderNextSubBlock (AudioBuffer<float>& buffer, int startSample, int numSamples)
 {
     const ScopedLock sl (voicesLock);
 
+    if (workerPool != nullptr && renderVoicesInParallel (buffer, startSample, numSamples))
+        return;
+
     for (auto* voice : voices)
     {
         if (voice->isActive())
@@ -328,6 +380,9 @@ void MPESynthesiser::renderNextSubBlock (AudioBuffer<double>& buffer, int startS
 {
     const ScopedLock sl (voicesLock);
 
+    if (workerPool != nullptr && renderVoicesInParallel (buffer, startSample, numSamples))
+        return;
+
     for (auto* voice : voices)
     {
         if (voice->isActive())
@@ -127,6 +127,33 @@ public:
     /** Returns true if note-stealing is enabled. */
     bool isVoiceStealingEnabled() const noexcept                { return shouldStealVoices; }
 
+    //==============================================================================
+    /** Enables rendering the voices in parallel, on a pool of worker threads.
+
+        Every active voice is rendered into its own scratch buffer by one of the threads,
+        and the scratch buffers are then added to the output in the order of the voices,
+        so the result doesn't depend on the scheduling. Nothing is allocated and no lock
+        is taken on the audio thread.
+
+        Several voices are rendered at the same time in this mode, so they mustn't share
+        any state which isn't thread-safe, or call the synthesiser back from renderNextBlock().
+
+        This allocates memory, so shouldn't be called from the audio thread.
+
+        @param numWorkerThreads     the number of threads helping the audio thread, or 0
+                                    to render the voices serially again
+        @param maximumBlockSize     the size of the scratch buffers. Larger blocks are
+                                    rendered in several parts
+        @param maximumNumChannels   the number of channels of the scratch buffers. Buffers
+                                    with more channels are rendered serially
+
+        @see Synthesiser::setParallelVoiceRendering
+    */
+    void setParallelVoiceRendering (int numWorkerThreads, int maximumBlockSize, int maximumNumChannels = 2);
+
+    /** Returns true if the voices are rendered on a pool of worker threads. */
+    bool isParallelVoiceRenderingEnabled() const noexcept       { return workerPool != nullptr; }
+
     //==============================================================================
     /** Tells the synthesiser what the sample rate is for the audio it's being used to render.
 
@@ -306,6 +333,15 @@ private:
     bool shouldStealVoices = false;
     uint32 lastNoteOnCounter = 0;
 
+    std::unique_ptr<AudioWorkerPool> workerPool;
+    Array<MPESynthesiserVoice*> voicesToRender;
+    int parallelBlockSize = 0, parallelNumChannels = 0;
+
+    void prepareParallelRendering();
+
+    template <typename floatType>
+    bool renderVoicesInParallel (AudioBuffer<floatType>&, int startSample, int numSamples);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MPESynthesiser)
 };
 
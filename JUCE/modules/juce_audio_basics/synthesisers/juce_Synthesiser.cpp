@@ -94,19 +94,23 @@ void Synthesiser::clearVoices()
 {
     const ScopedLock sl (lock);
     voices.clear();
+    prepareParallelRendering();
 }
 
 SynthesiserVoice* Synthesiser::addVoice (SynthesiserVoice* const newVoice)
 {
     const ScopedLock sl (lock);
     newVoice->setCurrentPlaybackSampleRate (sampleRate);
-    return voices.add (newVoice);
+    voices.add (newVoice);
+    prepareParallelRendering();
+    return newVoice;
 }
 
 void Synthesiser::removeVoice (const int index)
 {
     const ScopedLock sl (lock);
     voices.remove (index);
+    prepareParallelRendering();
 }
 
 void Synthesiser::clearSounds()
@@ -139,6 +143,35 @@ void Synthesiser::setMinimumRenderingSubdivisionSize (int numSamples, bool shoul
     subBlockSubdivisionIsStrict = shouldBeStrict;
 }
 
+void Synthesiser::setParallelVoiceRendering (int numWorkerThreads, int maximumBlockSize, int maximumNumChannels)
+{
+    jassert (numWorkerThreads >= 0 && maximumBlockSize > 0 && maximumNumChannels > 0);
+
+    std::unique_ptr<AudioWorkerPool> newPool;
+
+    if (numWorkerThreads > 0)
+        newPool.reset (new AudioWorkerPool (numWorkerThreads));
+
+    {
+        const ScopedLock sl (lock);
+        std::swap (workerPool, newPool);
+        parallelBlockSize = maximumBlockSize;
+        parallelNumChannels = maximumNumChannels;
+        prepareParallelRendering();
+    }
+
+    // (the old pool's threads are stopped outside the lock)
+}
+
+void Synthesiser::prepareParallelRendering()
+{
+    if (workerPool != nullptr)
+    {
+        workerPool->prepareScratchBuffers (voices.size(), parallelNumChannels, parallelBlockSize);
+        voicesToRender.ensureStorageAllocated (voices.size());
+    }
+}
+
 //==============================================================================
 void Synthesiser::setCurrentPlaybackSampleRate (const double newRate)
 {
@@ -230,16 +263,39 @@ void Synthesiser::renderNextBlock (AudioBuffer<double>& outputAudio, const MidiB
 
 void Synthesiser::renderVoices (AudioBuffer<float>& buffer, int startSample, int numSamples)
 {
+    if (workerPool != nullptr && renderVoicesInParallel (buffer, startSample, numSamples))
+        return;
+
     for (auto* voice : voices)
         voice->renderNextBlock (buffer, startSample, numSamples);
 }
 
 void Synthesiser::renderVoices (AudioBuffer<double>& buffer, int startSample, int numSamples)
 {
+    if (workerPool != nullptr && renderVoicesInParallel (buffer, startSample, numSamples))
+        return;
+
     for (auto* voice : voices)
         voice->renderNextBlock (buffer, startSample, numSamples);
 }
 
+template <typename floatType>
+bool Synthesiser::renderVoicesInParallel (AudioBuffer<floatType>& buffer, int startSample, int numSamples)
+{
+    // (the storage was allocated by prepareParallelRendering)
+    voicesToRender.clearQuick();
+
+    for (auto* voice : voices)
+        if (voice->isVoiceActive())
+            voicesToRender.add (voice);
+
+    return workerPool->renderAndMix (buffer, startSample, numSamples, voicesToRender.size(),
+                                     [this] (int index, AudioBuffer<floatType>& scratch)
+                                     {
+                                         voicesToRender.getUnchecked (index)->renderNextBlock (scratch, 0, scratch.getNumSamples());
+                                     });
+}
+
 void Synthesiser::handleMidiEvent (const MidiMessage& m)
 {
     const int channel = m.getChannel();
@@ -582,4 +638,168 @@ SynthesiserVoice* Synthesiser::findVoiceToSteal (SynthesiserSound* soundToPlay,
     return low;
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SynthesiserParallelRenderingTests  : public UnitTest
+{
+public:
+    SynthesiserParallelRenderingTests()
+        : UnitTest ("Synthesiser parallel rendering", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Parallel rendering matches serial rendering");
+        {
+            constexpr int blockSize = 512;
+
+            Synthesiser serial, parallel;
+            parallel.setParallelVoiceRendering (3, 200);
+
+            for (auto* synth : { &serial, &parallel })
+                prepareSynth (*synth, 24, 4);
+
+            expect (! serial.isParallelVoiceRenderingEnabled());
+            expect (parallel.isParallelVoiceRenderingEnabled());
+
+            Random random (42);
+            AudioBuffer<float> serialOut (2, blockSize), parallelOut (2, blockSize);
+            AudioBuffer<double> serialOutDouble (2, blockSize), parallelOutDouble (2, blockSize);
+            auto identical = true;
+
+            for (int block = 0; block < 40; ++block)
+            {
+                MidiBuffer midi;
+
+                for (int i = 0; i < 6; ++i)
+                {
+                    auto note = 40 + random.nextInt (40);
+                    auto position = random.nextInt (blockSize);
+
+                    if (random.nextBool())
+                        midi.addEvent (MidiMessage::noteOn (1, note, 0.1f + 0.8f * random.nextFloat()), position);
+                    else
+                        midi.addEvent (MidiMessage::noteOff (1, note), position);
+                }
+
+                if (block % 2 == 0)
+                {
+                    serialOut.clear();
+                    parallelOut.clear();
+                    serial.renderNextBlock (serialOut, midi, 0, blockSize);
+                    parallel.renderNextBlock (parallelOut, midi, 0, blockSize);
+
+                    for (int ch = 0; ch < 2; ++ch)
+                        for (int i = 0; i < blockSize; ++i)
+                            identical = identical && serialOut.getSample (ch, i) == parallelOut.getSample (ch, i);
+                }
+                else
+                {
+                    serialOutDouble.clear();
+                    parallelOutDouble.clear();
+                    serial.renderNextBlock (serialOutDouble, midi, 0, blockSize);
+                    parallel.renderNextBlock (parallelOutDouble, midi, 0, blockSize);
+
+                    for (int ch = 0; ch < 2; ++ch)
+                        for (int i = 0; i < blockSize; ++i)
+                            identical = identical && serialOutDouble.getSample (ch, i) == parallelOutDouble.getSample (ch, i);
+                }
+            }
+
+            expect (identical);
+            expectGreaterThan (serialOut.getMagnitude (0, blockSize), 0.0f);
+        }
+    }
+
+private:
+    struct TestSound  : public SynthesiserSound
+    {
+        bool appliesToNote (int) override       { return true; }
+        bool appliesToChannel (int) override    { return true; }
+    };
+
+    // An additive voice, with a short release
+    struct TestVoice  : public SynthesiserVoice
+    {
+        explicit TestVoice (int harmonics)  : numHarmonics (harmonics) {}
+
+        bool canPlaySound (SynthesiserSound*) override      { return true; }
+        void pitchWheelMoved (int) override                 {}
+        void controllerMoved (int, int) override            {}
+
+        void startNote (int note, float velocity, SynthesiserSound*, int) override
+        {
+            phase = 0.0;
+            delta = MathConstants<double>::twoPi * MidiMessage::getMidiNoteInHertz (note) / getSampleRate();
+            level = velocity * 0.1;
+            tail = 0.0;
+        }
+
+        void stopNote (float, bool allowTailOff) override
+        {
+            if (allowTailOff)
+                tail = 1.0;
+            else
+                clearCurrentNote();
+        }
+
+        void renderNextBlock (AudioBuffer<float>& buffer, int startSample, int numSamples) override    { render (buffer, startSample, numSamples); }
+        void renderNextBlock (AudioBuffer<double>& buffer, int startSample, int numSamples) override   { render (buffer, startSample, numSamples); }
+
+        template <typename FloatType>
+        void render (AudioBuffer<FloatType>& buffer, int startSample, int numSamples)
+        {
+            if (! isVoiceActive())
+                return;
+
+            for (int i = startSample; i < startSample + numSamples; ++i)
+            {
+                auto value = 0.0;
+
+                for (int h = 1; h <= numHarmonics; ++h)
+                    value += std::sin (phase * h) / h;
+
+                phase += delta;
+                value *= level;
+
+                if (tail > 0.0)
+                {
+                    value *= tail;
+                    tail *= 0.99;
+
+                    if (tail < 0.005)
+                    {
+                        clearCurrentNote();
+                        break;
+                    }
+                }
+
+                for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                    buffer.addSample (ch, i, (FloatType) value);
+            }
+        }
+
+        const int numHarmonics;
+        double phase = 0.0, delta = 0.0, level = 0.0, tail = 0.0;
+    };
+
+    static void prepareSynth (Synthesiser& synth, int numVoices, int numHarmonics)
+    {
+        synth.clearVoices();
+        synth.clearSounds();
+
+        for (int i = 0; i < numVoices; ++i)
+            synth.addVoice (new TestVoice (numHarmonics));
+
+        synth.addSound (new TestSound());
+        synth.setCurrentPlaybackSampleRate (44100.0);
+    }
+};
+
+static SynthesiserParallelRenderingTests synthesiserParallelRenderingTests;
+
+#endif
+
 } // namespace juce
@@ -557,6 +557,33 @@ public:
     */
     void setMinimumRenderingSubdivisionSize (int numSamples, bool shouldBeStrict = false) noexcept;
 
+    /** Enables rendering the voices in parallel, on a pool of worker threads.
+
+        Every active voice is rendered into its own scratch buffer by one of the threads,
+        and the scratch buffers are then added to the output in the order of the voices,
+        so the result doesn't depend on the scheduling. Nothing is allocated and no lock
+        is taken on the audio thread.
+
+        In this mode, only the voices for which isVoiceActive() returns true are rendered,
+        and several of them are rendered at the same time, so they mustn't share any state
+        which isn't thread-safe, or call the synthesiser back from renderNextBlock().
+
+        This allocates memory, so shouldn't be called from the audio thread.
+
+        @param numWorkerThreads     the number of threads helping the audio thread, or 0
+                                    to render the voices serially again
+        @param maximumBlockSize     the size of the scratch buffers. Larger blocks are
+                                    rendered in several parts
+        @param maximumNumChannels   the number of channels of the scratch buffers. Buffers
+                                    with more channels are rendered serially
+    */
+    void setParallelVoiceRendering (int numWorkerThreads, int maximumBlockSize, int maximumNumChannels = 2);
+
+    /** Returns true if the voices are rendered on a pool of worker threads.
+        @see setParallelVoiceRendering
+    */
+    bool isParallelVoiceRenderingEnabled() const noexcept       { return workerPool != nullptr; }
+
 protected:
     //==============================================================================
     /** This is used to control access to the rendering callback and the note trigger methods. */
@@ -628,9 +655,18 @@ private:
     bool shouldStealNotes = true;
     BigInteger sustainPedalsDown;
 
+    std::unique_ptr<AudioWorkerPool> workerPool;
+    Array<SynthesiserVoice*> voicesToRender;
+    int parallelBlockSize = 0, parallelNumChannels = 0;
+
     template <typename floatType>
     void processNextBlock (AudioBuffer<floatType>&, const MidiBuffer&, int startSample, int numSamples);
 
+    void prepareParallelRendering();
+
+    template <typename floatType>
+    bool renderVoicesInParallel (AudioBuffer<floatType>&, int startSample, int numSamples);
+
    #if JUCE_CATCH_DEPRECATED_CODE_MISUSE
     // Note the new parameters for these methods.
     virtual int findFreeVoice (const bool) const { return 0; }
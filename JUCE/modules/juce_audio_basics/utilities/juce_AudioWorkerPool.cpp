@@ -0,0 +1,263 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+class AudioWorkerPool::Worker  : public Thread
+{
+public:
+    Worker (AudioWorkerPool& p, int index)
+        : Thread ("Audio worker " + String (index + 1)), pool (p)
+    {
+    }
+
+    ~Worker() override
+    {
+        signalThreadShouldExit();
+        wakeUp.signal();
+        stopThread (4000);
+    }
+
+    void wakeUpIfSleeping() noexcept
+    {
+        if (sleeping.load())
+            wakeUp.signal();
+    }
+
+    void run() override
+    {
+        auto lastGeneration = getGeneration (pool.batchState.load());
+        auto spinStart = Time::getMillisecondCounterHiRes();
+
+        while (! threadShouldExit())
+        {
+            auto generation = getGeneration (pool.batchState.load());
+
+            if (generation != lastGeneration)
+            {
+                lastGeneration = generation;
+                pool.runAvailableJobs (generation);
+                spinStart = Time::getMillisecondCounterHiRes();
+                continue;
+            }
+
+            // Keep polling for a while, as the next sub-block will follow shortly
+            if (Time::getMillisecondCounterHiRes() - spinStart < spinTimeMs)
+            {
+                Thread::yield();
+                continue;
+            }
+
+            // The flag is set before checking the state one last time, and runJobs
+            // publishes the state before checking the flag, so a batch can't be missed
+            sleeping = true;
+
+            if (getGeneration (pool.batchState.load()) == lastGeneration && ! threadShouldExit())
+                wakeUp.wait (-1);
+
+            sleeping = false;
+            spinStart = Time::getMillisecondCounterHiRes();
+        }
+    }
+
+private:
+    static constexpr double spinTimeMs = 1.0;
+
+    AudioWorkerPool& pool;
+    WaitableEvent wakeUp;
+    std::atomic<bool> sleeping { false };
+
+    JUCE_DECLARE_NON_COPYABLE (Worker)
+};
+
+//==============================================================================
+AudioWorkerPool::AudioWorkerPool (int numWorkerThreads, int threadPriority)
+{
+    jassert (numWorkerThreads >= 0);
+
+    for (int i = 0; i < numWorkerThreads; ++i)
+        workers.add (new Worker (*this, i))->startThread (threadPriority);
+}
+
+AudioWorkerPool::~AudioWorkerPool()
+{
+    workers.clear();
+}
+
+//==============================================================================
+void AudioWorkerPool::runJobs (int numJobs, JobFunction jobFunction, void* context) noexcept
+{
+    // The number of jobs must fit in the 16 bits of the batch state
+    jassert (numJobs <= 0xffff);
+
+    if (numJobs <= 0)
+        return;
+
+    if (workers.isEmpty() || numJobs == 1)
+    {
+        for (int i = 0; i < numJobs; ++i)
+            jobFunction (context, i);
+
+        return;
+    }
+
+    currentFunction = jobFunction;
+    currentContext = context;
+    numJobsFinished = 0;
+
+    auto generation = getGeneration (batchState.load()) + 1;
+    batchState = ((uint64) generation << 32) | ((uint64) numJobs << 16);
+
+    for (auto* worker : workers)
+        worker->wakeUpIfSleeping();
+
+    runAvailableJobs (generation);
+
+    // Waiting for the jobs which are still running on the workers
+    for (int i = 20; numJobsFinished.load() < numJobs;)
+        if (--i < 0)
+            Thread::yield();
+}
+
+void AudioWorkerPool::runAvailableJobs (uint32 generation) noexcept
+{
+    for (;;)
+    {
+        auto state = batchState.load();
+
+        if (getGeneration (state) != generation || getNextJob (state) >= getNumJobs (state))
+            return;
+
+        if (batchState.compare_exchange_weak (state, state + 1))
+        {
+            currentFunction (currentContext, getNextJob (state));
+            ++numJobsFinished;
+        }
+    }
+}
+
+//==============================================================================
+void AudioWorkerPool::prepareScratchBuffers (int maximumNumSources, int maximumNumChannels, int maximumBlockSize)
+{
+    // AudioBuffer would have to allocate to refer to more channels than that
+    jassert (maximumNumChannels <= maxNumScratchChannels);
+
+    maxSources   = jmax (0, maximumNumSources);
+    maxChannels  = jlimit (0, maxNumScratchChannels, maximumNumChannels);
+    maxBlockSize = jmax (1, maximumBlockSize);
+
+    // (allocated as doubles, so that it can hold either sample type)
+    scratchMemory.malloc ((size_t) (maxSources * maxChannels * maxBlockSize));
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AudioWorkerPoolTests  : public UnitTest
+{
+public:
+    AudioWorkerPoolTests()
+        : UnitTest ("AudioWorkerPool", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Every job runs once");
+        {
+            for (auto numWorkers : { 0, 1, 3 })
+            {
+                AudioWorkerPool pool (numWorkers, 0);
+                std::atomic<int> counts[100];
+                auto allOnce = true;
+
+                for (int batch = 0; batch < 500; ++batch)
+                {
+                    auto numJobs = 1 + batch % 100;
+
+                    for (auto& c : counts)
+                        c = 0;
+
+                    pool.runJobs (numJobs, [&] (int job) { ++counts[job]; });
+
+                    for (int i = 0; i < 100; ++i)
+                        allOnce = allOnce && counts[i].load() == (i < numJobs ? 1 : 0);
+
+                    // Letting the workers go to sleep now and then
+                    if (batch % 100 == 99)
+                        Thread::sleep (5);
+                }
+
+                expect (allOnce);
+            }
+        }
+
+        beginTest ("Render and mix");
+        {
+            AudioWorkerPool pool (2, 0);
+            pool.prepareScratchBuffers (8, 2, 64);
+
+            AudioBuffer<float> output (2, 200), expected (2, 200);
+            output.clear();
+            expected.clear();
+
+            for (int source = 0; source < 8; ++source)
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < 200; ++i)
+                        expected.addSample (ch, i, (float) (source * 1000 + ch * 100 + i));
+
+            int positions[8] = {};
+
+            auto rendered = pool.renderAndMix (output, 0, 200, 8, [&] (int source, AudioBuffer<float>& scratch)
+            {
+                for (int i = 0; i < scratch.getNumSamples(); ++i)
+                {
+                    for (int ch = 0; ch < 2; ++ch)
+                        scratch.addSample (ch, i, (float) (source * 1000 + ch * 100 + positions[source]));
+
+                    ++positions[source];
+                }
+            });
+
+            expect (rendered);
+
+            auto maxError = 0.0f;
+
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < 200; ++i)
+                    maxError = jmax (maxError, std::abs (output.getSample (ch, i) - expected.getSample (ch, i)));
+
+            expectEquals (maxError, 0.0f);
+
+            AudioBuffer<float> tooManyChannels (3, 200);
+            expect (! pool.renderAndMix (tooManyChannels, 0, 200, 8, [] (int, AudioBuffer<float>&) {}));
+        }
+    }
+};
+
+static AudioWorkerPoolTests audioWorkerPoolTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,181 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A pool of worker threads which can run batches of jobs on behalf of the audio
+    thread, for example to render the voices of a synthesiser in parallel.
+
+    runJobs() doesn't allocate or wait on a lock: the jobs are handed out through an
+    atomic counter, and the calling thread renders jobs itself until they have all
+    been taken, then spins until the last ones have finished. The workers spin for a
+    short while after each batch so that the sub-blocks of a callback don't need to
+    wake them up, and go to sleep when the audio thread is idle, in which case the
+    next batch signals their events.
+
+    The pool can also hold scratch buffers, so that several sources can be rendered
+    separately and mixed together in a deterministic order, see renderAndMix().
+
+    @tags{Audio}
+*/
+class JUCE_API  AudioWorkerPool
+{
+public:
+    //==============================================================================
+    /** Creates a pool, and starts its worker threads.
+
+        The thread calling runJobs() always takes part in the work, so a pool with
+        N worker threads renders with N + 1 threads.
+    */
+    explicit AudioWorkerPool (int numWorkerThreads,
+                              int threadPriority = Thread::realtimeAudioPriority);
+
+    /** Destructor. Stops the worker threads. */
+    ~AudioWorkerPool();
+
+    /** Returns the number of worker threads, not counting the thread calling runJobs(). */
+    int getNumWorkerThreads() const noexcept        { return workers.size(); }
+
+    //==============================================================================
+    /** A function called by the pool to run one job of a batch. */
+    using JobFunction = void (*) (void* context, int jobIndex);
+
+    /** Calls jobFunction for every job index between 0 and numJobs - 1, spreading
+        the jobs between the worker threads and the calling thread, and returns once
+        they have all finished.
+
+        The jobs can run in any order and on any of the threads, so they mustn't share
+        any state which isn't thread-safe. This mustn't be called by several threads
+        at the same time.
+    */
+    void runJobs (int numJobs, JobFunction jobFunction, void* context) noexcept;
+
+    /** Calls a function object for every job index between 0 and numJobs - 1.
+        @see runJobs
+    */
+    template <typename Callback>
+    void runJobs (int numJobs, Callback&& callback) noexcept
+    {
+        using CallbackType = typename std::remove_reference<Callback>::type;
+
+        runJobs (numJobs,
+                 [] (void* context, int jobIndex) { (*static_cast<CallbackType*> (context)) (jobIndex); },
+                 (void*) std::addressof (callback));
+    }
+
+    //==============================================================================
+    /** Allocates the scratch buffers used by renderAndMix(). This allocates memory,
+        so shouldn't be called from the audio thread.
+    */
+    void prepareScratchBuffers (int maximumNumSources, int maximumNumChannels, int maximumBlockSize);
+
+    /** Renders some sources in parallel, each one into its own cleared scratch buffer,
+        and then adds the scratch buffers to the output in the order of the sources,
+        so that the result doesn't depend on which thread rendered what.
+
+        The render function is called as renderSource (int sourceIndex, AudioBuffer<FloatType>& scratch),
+        possibly several times per source when numSamples is larger than the maximum
+        block size of the scratch buffers, and should add the output of the source to
+        the buffer.
+
+        Returns false without rendering anything if the scratch buffers are too small
+        for the number of sources or channels, in which case the caller should render
+        the sources itself.
+    */
+    template <typename FloatType, typename RenderFunction>
+    bool renderAndMix (AudioBuffer<FloatType>& output, int startSample, int numSamples,
+                       int numSources, RenderFunction&& renderSource) noexcept
+    {
+        auto numChannels = output.getNumChannels();
+
+        if (numSources > maxSources || numChannels > maxChannels)
+            return false;
+
+        while (numSamples > 0)
+        {
+            auto numThisTime = jmin (numSamples, maxBlockSize);
+
+            runJobs (numSources, [&] (int source)
+            {
+                FloatType* channels[maxNumScratchChannels];
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    channels[ch] = getScratchChannel<FloatType> (source, ch);
+
+                AudioBuffer<FloatType> scratch (channels, numChannels, numThisTime);
+                scratch.clear();
+                renderSource (source, scratch);
+            });
+
+            for (int source = 0; source < numSources; ++source)
+                for (int ch = 0; ch < numChannels; ++ch)
+                    output.addFrom (ch, startSample, getScratchChannel<FloatType> (source, ch), numThisTime);
+
+            startSample += numThisTime;
+            numSamples  -= numThisTime;
+        }
+
+        return true;
+    }
+
+private:
+    //==============================================================================
+    class Worker;
+    friend class Worker;
+
+    // AudioBuffer can refer to this number of channels without allocating
+    static constexpr int maxNumScratchChannels = 31;
+
+    // The state of the current batch is packed into a single atomic, so that a worker
+    // can never take a job from a batch which has already finished:
+    // generation (32 bits) | number of jobs (16 bits) | next job to run (16 bits)
+    static uint32 getGeneration (uint64 state) noexcept     { return (uint32) (state >> 32); }
+    static int getNumJobs (uint64 state) noexcept           { return (int) ((state >> 16) & 0xffff); }
+    static int getNextJob (uint64 state) noexcept           { return (int) (state & 0xffff); }
+
+    void runAvailableJobs (uint32 generation) noexcept;
+
+    template <typename FloatType>
+    FloatType* getScratchChannel (int source, int channel) const noexcept
+    {
+        return reinterpret_cast<FloatType*> (scratchMemory.get()) + (source * maxChannels + channel) * maxBlockSize;
+    }
+
+    //==============================================================================
+    OwnedArray<Worker> workers;
+
+    std::atomic<uint64> batchState { 0 };
+    std::atomic<int> numJobsFinished { 0 };
+    JobFunction currentFunction = nullptr;
+    void* currentContext = nullptr;
+
+    HeapBlock<double> scratchMemory;
+    int maxSources = 0, maxChannels = 0, maxBlockSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioWorkerPool)
+};
+
+} // namespace juce
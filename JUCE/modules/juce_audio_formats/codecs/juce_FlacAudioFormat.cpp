@@ -247,8 +247,29 @@ public:
             {
                 if (startSampleInFile >= lengthInSamples)
                 {
+                    // (this leaves reservoirStart at the decoder's current position)
+                    reservoirStart += samplesInReservoir;
                     samplesInReservoir = 0;
                 }
+                else if (seekTable != nullptr)
+                {
+                    auto seekPoint = seekTable->getSeekPointBefore (startSampleInFile);
+
+                    // only jump if the target is behind us, or further ahead than the next seek point
+                    if (startSampleInFile < reservoirStart || seekPoint.sampleNumber > reservoirStart + samplesInReservoir)
+                    {
+                        input->setPosition (seekPoint.byteOffset);
+                        FLAC__stream_decoder_flush (decoder);
+                        reservoirStart = seekPoint.sampleNumber;
+                    }
+                    else
+                    {
+                        reservoirStart += samplesInReservoir;
+                    }
+
+                    samplesInReservoir = 0;
+                    FLAC__stream_decoder_process_single (decoder);
+                }
                 else if (startSampleInFile < reservoirStart
                           || startSampleInFile > reservoirStart + jmax (samplesInReservoir, (int64) 511))
                 {
@@ -280,6 +301,72 @@ public:
         return true;
     }
 
+    AudioFormatSeekTable::Ptr createSeekTable (int samplesPerEntry) override
+    {
+        if (! ok || lengthInSamples <= 0)
+            return {};
+
+        // every frame is a seek point, so this just skips from one frame header to the
+        // next, and remembers where each one was found
+        Array<AudioFormatSeekTable::SeekPoint> seekPoints;
+        int64 frameStart = 0;
+        bool wasInterrupted = false;
+
+        FLAC__stream_decoder_reset (decoder);
+        FLAC__stream_decoder_process_until_end_of_metadata (decoder);
+
+        for (;;)
+        {
+            if (Thread::currentThreadShouldExit())
+            {
+                wasInterrupted = true;
+                break;
+            }
+
+            FlacNamespace::FLAC__uint64 bytePosition = 0;
+
+            if (! FLAC__stream_decoder_get_decode_position (decoder, &bytePosition)
+                 || ! FLAC__stream_decoder_skip_single_frame (decoder)
+                 || FLAC__stream_decoder_get_state (decoder) != FlacNamespace::FLAC__STREAM_DECODER_SEARCH_FOR_FRAME_SYNC)
+                break;
+
+            auto blockSize = (int64) FLAC__stream_decoder_get_blocksize (decoder);
+
+            if (blockSize <= 0)
+                break;
+
+            seekPoints.add ({ frameStart, (int64) bytePosition });
+            frameStart += blockSize;
+        }
+
+        restartDecoder();
+
+        if (wasInterrupted || frameStart != lengthInSamples)
+            return {};
+
+        return new AudioFormatSeekTable (seekPoints, lengthInSamples, samplesPerEntry);
+    }
+
+    bool setSeekTable (AudioFormatSeekTable::Ptr newTable) override
+    {
+        if (newTable != nullptr && (newTable->isEmpty() || newTable->getLengthInSamples() != lengthInSamples))
+            return false;
+
+        seekTable = newTable;
+        return true;
+    }
+
+    void restartDecoder()
+    {
+        auto length = lengthInSamples;
+        FLAC__stream_decoder_reset (decoder);
+        FLAC__stream_decoder_process_until_end_of_metadata (decoder);
+        lengthInSamples = length;
+
+        reservoirStart = 0;
+        samplesInReservoir = 0;
+    }
+
     void useSamples (const FlacNamespace::FLAC__int32* const buffer[], int numSamples)
     {
         if (scanningForLength)
@@ -369,6 +456,7 @@ private:
     AudioBuffer<float> reservoir;
     int64 reservoirStart = 0, samplesInReservoir = 0;
     bool ok = false, scanningForLength = false;
+    AudioFormatSeekTable::Ptr seekTable;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlacReader)
 };
@@ -532,6 +620,7 @@ public:
     bool ok = false;
 
 private:
+    //==============================================================================
     FlacNamespace::FLAC__StreamEncoder* encoder;
     int64 streamStartPos;
 
@@ -594,6 +683,73 @@ StringArray FlacAudioFormat::getQualityOptions()
     return { "0 (Fastest)", "1", "2", "3", "4", "5 (Default)","6", "7", "8 (Highest quality)" };
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct FlacAudioFormatTests  : public UnitTest
+{
+    FlacAudioFormatTests()
+        : UnitTest ("FLAC audio format tests", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Encoded files decode to the source");
+        {
+            Random random (1234);
+
+            for (auto numChannels : { 1, 2 })
+            {
+                for (auto numSamples : { 0, 1000, 65536, 100000 })
+                {
+                    auto source = AudioFormatTestHelpers::createTestSignal (random, numChannels, numSamples);
+
+                    for (auto quality : { 0, 5, 8 })
+                    {
+                        FlacAudioFormat format;
+                        auto encoded = encode (source, 24, quality);
+                        std::unique_ptr<AudioFormatReader> reader (format.createReaderFor (new MemoryInputStream (encoded, false), true));
+
+                        expect (reader != nullptr);
+
+                        if (reader != nullptr)
+                        {
+                            expectEquals ((int) reader->lengthInSamples, numSamples);
+
+                            AudioBuffer<float> decoded (numChannels, numSamples);
+                            reader->read (&decoded, 0, numSamples, 0, true, true);
+                            expect (AudioFormatTestHelpers::buffersMatch (decoded, 0, source, 0, numSamples));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    static MemoryBlock encode (const AudioBuffer<float>& source, int bitsPerSample, int quality)
+    {
+        MemoryBlock block;
+        FlacAudioFormat format;
+
+        {
+            std::unique_ptr<AudioFormatWriter> writer (format.createWriterFor (new MemoryOutputStream (block, false), 44100.0,
+                                                                               (unsigned int) source.getNumChannels(),
+                                                                               bitsPerSample, {}, quality));
+
+            // odd-sized writes, so that the frames don't line up with them
+            for (int start = 0; start < source.getNumSamples(); start += 1000)
+                writer->writeFromAudioSampleBuffer (source, start, jmin (1000, source.getNumSamples() - start));
+        }
+
+        return block;
+    }
+};
+
+static const FlacAudioFormatTests flacAudioFormatTests;
+
+#endif
+
 #endif
 
 } // namespace juce
@@ -190,7 +190,7 @@ public:
                 samplesInReservoir = reservoir.getNumSamples();
 
                 if (reservoirStart != (int) ov_pcm_tell (&ovFile))
-                    ov_pcm_seek (&ovFile, reservoirStart);
+                    seekTo (reservoirStart);
 
                 int bitStream = 0;
                 int offset = 0;
@@ -228,6 +228,163 @@ public:
         return true;
     }
 
+    void seekTo (int64 samplePosition)
+    {
+        if (seekTable != nullptr)
+        {
+            auto seekPoint = seekTable->getSeekPointBefore (samplePosition);
+            auto currentPosition = (int64) ov_pcm_tell (&ovFile);
+
+            // only jump if the target is behind us, or further ahead than the next seek point
+            if (currentPosition > samplePosition || currentPosition < seekPoint.sampleNumber)
+                currentPosition = ov_raw_seek (&ovFile, seekPoint.byteOffset) == 0 ? skipPacketsBefore (samplePosition) : -1;
+
+            if (currentPosition >= 0 && currentPosition <= samplePosition)
+            {
+                // decode up to the sample we want from the nearest seek point
+                while (currentPosition < samplePosition)
+                {
+                    float** dataIn = nullptr;
+                    int bitStream = 0;
+                    auto samps = ov_read_float (&ovFile, &dataIn, (int) jmin ((int64) 4096, samplePosition - currentPosition), &bitStream);
+
+                    if (samps <= 0)
+                        break;
+
+                    currentPosition += samps;
+                }
+
+                return;
+            }
+        }
+
+        ov_pcm_seek (&ovFile, samplePosition);
+    }
+
+    // Called straight after ov_raw_seek(), this drops the packets that don't overlap the
+    // target position without synthesising them. This is the same thing that ov_pcm_seek()
+    // does after finding the right page, and it saves decoding most of a page after each
+    // jump. Returns the new position, or -1 if the stream needs to be re-seeked.
+    int64 skipPacketsBefore (int64 samplePosition)
+    {
+       #if JUCE_INCLUDE_OGGVORBIS_CODE || ! defined (JUCE_INCLUDE_OGGVORBIS_CODE)
+        using namespace OggVorbisNamespace;
+
+        if (ovFile.ready_state == INITSET && ovFile.pcm_offset >= 0 && ovFile.pcm_offset <= samplePosition)
+        {
+            auto* info = ovFile.vi + ovFile.current_link;
+            auto longBlockSize = vorbis_info_blocksize (info, 1);
+            int lastBlockSize = 0;
+
+            for (;;)
+            {
+                ogg_packet packet;
+                auto result = ogg_stream_packetpeek (&ovFile.os, &packet);
+
+                if (result == 0)
+                {
+                    // the packets that were skipped can only be accounted for once the next
+                    // one has been seen, so carry on into the next page of this stream
+                    ogg_page page;
+
+                    if (_get_next_page (&ovFile, &page, -1) < 0
+                         || ogg_page_bos (&page)
+                         || ogg_page_serialno (&page) != ovFile.current_serialno)
+                        return -1;
+
+                    ogg_stream_pagein (&ovFile.os, &page);
+                    continue;
+                }
+
+                if (result < 0)
+                    return -1;
+
+                auto blockSize = vorbis_packet_blocksize (info, &packet);
+
+                if (blockSize < 0)
+                {
+                    ogg_stream_packetout (&ovFile.os, nullptr);
+                    continue;
+                }
+
+                if (lastBlockSize != 0)
+                    ovFile.pcm_offset += (lastBlockSize + blockSize) >> 2;
+
+                if (ovFile.pcm_offset + ((blockSize + longBlockSize) >> 2) >= samplePosition)
+                    break;
+
+                ogg_stream_packetout (&ovFile.os, nullptr);
+                vorbis_synthesis_trackonly (&ovFile.vb, &packet);
+                vorbis_synthesis_blockin (&ovFile.vd, &ovFile.vb);
+
+                if (packet.granulepos > -1)
+                {
+                    ovFile.pcm_offset = jmax ((ogg_int64_t) 0, packet.granulepos - ovFile.pcmlengths[ovFile.current_link * 2]);
+
+                    for (int i = 0; i < ovFile.current_link; ++i)
+                        ovFile.pcm_offset += ovFile.pcmlengths[i * 2 + 1];
+                }
+
+                lastBlockSize = blockSize;
+            }
+        }
+       #else
+        ignoreUnused (samplePosition);
+       #endif
+
+        return (int64) ov_pcm_tell (&ovFile);
+    }
+
+    AudioFormatSeekTable::Ptr createSeekTable (int samplesPerEntry) override
+    {
+        if (lengthInSamples <= 0 || ! ov_seekable (&ovFile))
+            return {};
+
+        // vorbisfile can work out exactly which sample it'll resume from after seeking to
+        // any byte position, so this just tries enough positions to fill the table. It can
+        // only resume at the start of a page, so the table can't be any finer than that.
+        auto totalBytes = (int64) ov_raw_total (&ovFile, -1);
+        auto bytesPerProbe = jmax ((int64) 1024, (int64) ((double) totalBytes * samplesPerEntry / (double) lengthInSamples));
+
+        Array<AudioFormatSeekTable::SeekPoint> seekPoints;
+        seekPoints.add ({ 0, 0 });
+        bool wasInterrupted = false;
+
+        for (auto bytePosition = bytesPerProbe; bytePosition < totalBytes; bytePosition += bytesPerProbe)
+        {
+            if (Thread::currentThreadShouldExit())
+            {
+                wasInterrupted = true;
+                break;
+            }
+
+            if (ov_raw_seek (&ovFile, bytePosition) != 0)
+                continue;
+
+            auto samplePosition = (int64) ov_pcm_tell (&ovFile);
+
+            if (samplePosition > seekPoints.getLast().sampleNumber && samplePosition < lengthInSamples)
+                seekPoints.add ({ samplePosition, bytePosition });
+        }
+
+        ov_pcm_seek (&ovFile, 0);
+        samplesInReservoir = 0;
+
+        if (wasInterrupted)
+            return {};
+
+        return new AudioFormatSeekTable (seekPoints, lengthInSamples, samplesPerEntry);
+    }
+
+    bool setSeekTable (AudioFormatSeekTable::Ptr newTable) override
+    {
+        if (newTable != nullptr && (newTable->isEmpty() || newTable->getLengthInSamples() != lengthInSamples))
+            return false;
+
+        seekTable = newTable;
+        return true;
+    }
+
     //==============================================================================
     static size_t oggReadCallback (void* ptr, size_t size, size_t nmemb, void* datasource)
     {
@@ -262,6 +419,7 @@ private:
     OggVorbisNamespace::ov_callbacks callbacks;
     AudioBuffer<float> reservoir;
     int64 reservoirStart = 0, samplesInReservoir = 0;
+    AudioFormatSeekTable::Ptr seekTable;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OggReader)
 };
@@ -0,0 +1,534 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+namespace juce
+{
+
+struct AudioFormatBatchDecoder::Task
+{
+    RequestID requestID;
+    Request request;
+    int64 numSamplesDecoded = 0;
+    int numChannelsDecoded = 0;
+    std::atomic<bool> shouldCancel { false };
+};
+
+//==============================================================================
+AudioFormatBatchDecoder::AudioFormatBatchDecoder (AudioFormatManager& manager, int numberOfThreads)
+    : formatManager (manager), threadPool (jmax (1, numberOfThreads))
+{
+}
+
+AudioFormatBatchDecoder::~AudioFormatBatchDecoder()
+{
+    cancelAll();
+    threadPool.removeAllJobs (false, -1);
+}
+
+//==============================================================================
+AudioFormatBatchDecoder::RequestID AudioFormatBatchDecoder::addRequest (const Request& request)
+{
+    // you need to give it somewhere to put the audio!
+    jassert (request.destination != nullptr);
+
+    std::unique_ptr<Task> task (new Task());
+    task->request = request;
+
+    {
+        const ScopedLock sl (lock);
+        task->requestID = nextRequestID++;
+
+        // keep the queue sorted by priority, with equal priorities in the order they were added
+        int index = 0;
+
+        while (index < pendingTasks.size() && pendingTasks.getUnchecked (index)->request.priority >= request.priority)
+            ++index;
+
+        pendingTasks.insert (index, task.get());
+    }
+
+    auto requestID = task.release()->requestID;
+
+    // each job decodes whichever request is at the front of the queue when it starts
+    threadPool.addJob ([this] { decodeNextTask(); });
+
+    return requestID;
+}
+
+AudioFormatBatchDecoder::Status AudioFormatBatchDecoder::getStatus (RequestID requestID) const
+{
+    const ScopedLock sl (lock);
+
+    for (auto* task : runningTasks)
+        if (task->requestID == requestID)
+            return Status::decoding;
+
+    for (auto* task : pendingTasks)
+        if (task->requestID == requestID)
+            return Status::pending;
+
+    auto found = finishedRequests.find (requestID);
+    return found != finishedRequests.end() ? found->second : Status::unknown;
+}
+
+bool AudioFormatBatchDecoder::cancel (RequestID requestID)
+{
+    Task* taskToFinish = nullptr;
+
+    {
+        const ScopedLock sl (lock);
+
+        for (auto* task : runningTasks)
+        {
+            if (task->requestID == requestID)
+            {
+                task->shouldCancel = true;
+                return true;
+            }
+        }
+
+        for (auto* task : pendingTasks)
+        {
+            if (task->requestID == requestID)
+            {
+                // move it out of the queue so that no worker thread can pick it up
+                taskToFinish = task;
+                pendingTasks.removeObject (task, false);
+                runningTasks.add (task);
+                break;
+            }
+        }
+    }
+
+    if (taskToFinish == nullptr)
+        return false;
+
+    finishTask (*taskToFinish, Status::cancelled);
+    return true;
+}
+
+void AudioFormatBatchDecoder::cancelAll()
+{
+    Array<RequestID> requestIDs;
+
+    {
+        const ScopedLock sl (lock);
+
+        for (auto* tasks : { &pendingTasks, &runningTasks })
+            for (auto* task : *tasks)
+                requestIDs.add (task->requestID);
+    }
+
+    for (auto requestID : requestIDs)
+        cancel (requestID);
+}
+
+int AudioFormatBatchDecoder::getNumOutstandingRequests() const
+{
+    const ScopedLock sl (lock);
+    return pendingTasks.size() + runningTasks.size();
+}
+
+bool AudioFormatBatchDecoder::waitUntilFinished (int timeOutMilliseconds) const
+{
+    auto startTime = Time::getMillisecondCounter();
+
+    while (getNumOutstandingRequests() > 0)
+    {
+        if (timeOutMilliseconds >= 0 && Time::getMillisecondCounter() >= startTime + (uint32) timeOutMilliseconds)
+            return false;
+
+        taskFinished.wait (2);
+    }
+
+    return true;
+}
+
+//==============================================================================
+AudioFormatBatchDecoder::Statistics AudioFormatBatchDecoder::getStatistics() const
+{
+    const ScopedLock sl (lock);
+    return statistics;
+}
+
+void AudioFormatBatchDecoder::resetStatistics()
+{
+    const ScopedLock sl (lock);
+    statistics = {};
+    finishedRequests.clear();
+    hasStarted = ! runningTasks.isEmpty();
+    firstStartTime = Time::getMillisecondCounterHiRes();
+}
+
+//==============================================================================
+void AudioFormatBatchDecoder::decodeNextTask()
+{
+    Task* task = nullptr;
+
+    {
+        const ScopedLock sl (lock);
+
+        if (pendingTasks.isEmpty())
+            return; // (the request that this job was started for must have been cancelled)
+
+        task = pendingTasks.removeAndReturn (0);
+        runningTasks.add (task);
+
+        if (! hasStarted)
+        {
+            hasStarted = true;
+            firstStartTime = Time::getMillisecondCounterHiRes();
+        }
+    }
+
+    auto startTime = Time::getMillisecondCounterHiRes();
+    auto status = decode (*task);
+
+    {
+        const ScopedLock sl (lock);
+        statistics.decodingSeconds += (Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+    }
+
+    finishTask (*task, status);
+}
+
+AudioFormatBatchDecoder::Status AudioFormatBatchDecoder::decode (Task& task)
+{
+    auto& request = task.request;
+    std::unique_ptr<AudioFormatReader> reader (formatManager.createReaderFor (request.file));
+
+    if (reader == nullptr)
+        return Status::failed;
+
+    auto startSample = jlimit ((int64) 0, reader->lengthInSamples, request.startSampleInFile);
+    auto numSamples = reader->lengthInSamples - startSample;
+
+    if (request.numSamples >= 0)
+        numSamples = jmin (numSamples, request.numSamples);
+
+    auto& destination = *request.destination;
+    auto destStartSample = 0;
+
+    if (request.resizeDestination)
+    {
+        if (numSamples > std::numeric_limits<int>::max())
+            return Status::failed;
+
+        destination.setSize ((int) reader->numChannels, (int) numSamples, false, false, true);
+    }
+    else
+    {
+        destStartSample = request.destStartSample;
+
+        if (destStartSample < 0 || destStartSample + numSamples > destination.getNumSamples())
+            return Status::failed;
+    }
+
+    // read in chunks so that cancelling doesn't have to wait for the whole file
+    const int samplesPerChunk = 65536;
+
+    for (int64 done = 0; done < numSamples;)
+    {
+        if (task.shouldCancel)
+            return Status::cancelled;
+
+        auto numThisTime = (int) jmin ((int64) samplesPerChunk, numSamples - done);
+        reader->read (&destination, destStartSample + (int) done, numThisTime, startSample + done, true, true);
+        done += numThisTime;
+    }
+
+    task.numSamplesDecoded = numSamples;
+    task.numChannelsDecoded = destination.getNumChannels();
+    return Status::finished;
+}
+
+void AudioFormatBatchDecoder::finishTask (Task& task, Status status)
+{
+    // the task stays in the running list until its callback has returned, so that
+    // waitUntilFinished() doesn't return too early
+    if (task.request.onFinished != nullptr)
+        task.request.onFinished (task.requestID, status);
+
+    {
+        const ScopedLock sl (lock);
+        std::unique_ptr<Task> deleter (runningTasks.removeAndReturn (runningTasks.indexOf (&task)));
+        finishedRequests[task.requestID] = status;
+
+        switch (status)
+        {
+            case Status::finished:
+                ++statistics.numFilesDecoded;
+                statistics.numSamplesDecoded += task.numSamplesDecoded;
+                statistics.numBytesDecoded += task.numSamplesDecoded * task.numChannelsDecoded * (int64) sizeof (float);
+                break;
+
+            case Status::failed:        ++statistics.numFilesFailed; break;
+            case Status::cancelled:     ++statistics.numFilesCancelled; break;
+            case Status::pending:
+            case Status::decoding:
+            case Status::unknown:
+            default:                    jassertfalse; break;
+        }
+
+        if (hasStarted)
+            statistics.elapsedSeconds = (Time::getMillisecondCounterHiRes() - firstStartTime) * 0.001;
+    }
+
+    taskFinished.signal();
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct AudioFormatBatchDecoderTests  : public UnitTest
+{
+    AudioFormatBatchDecoderTests()
+        : UnitTest ("Audio format batch decoder", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        auto folder = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("BatchDecoderTests", {});
+        folder.createDirectory();
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        Array<File> files;
+        OwnedArray<AudioBuffer<float>> sources;
+
+        Random random (1);
+
+        for (int i = 0; i < 8; ++i)
+        {
+            auto numChannels = 1 + i % 2;
+            auto numSamples = 1000 + 20000 * i;
+            sources.add (new AudioBuffer<float> (AudioFormatTestHelpers::createTestSignal (random, numChannels, numSamples)));
+            auto file = folder.getChildFile ("test" + String (i) + (i % 3 == 0 ? ".flac" : ".wav"));
+            files.add (AudioFormatTestHelpers::writeFile (formatManager, file, *sources.getLast()));
+        }
+
+        beginTest ("Files are decoded into the destination buffers");
+        {
+            AudioFormatBatchDecoder decoder (formatManager, 3);
+            OwnedArray<AudioBuffer<float>> destinations;
+            Array<AudioFormatBatchDecoder::RequestID> requestIDs;
+
+            for (auto& file : files)
+            {
+                AudioFormatBatchDecoder::Request request;
+                request.file = file;
+                request.destination = destinations.add (new AudioBuffer<float>());
+                requestIDs.add (decoder.addRequest (request));
+            }
+
+            expect (decoder.waitUntilFinished (20000));
+
+            for (int i = 0; i < files.size(); ++i)
+            {
+                expect (decoder.getStatus (requestIDs[i]) == AudioFormatBatchDecoder::Status::finished);
+                expect (AudioFormatTestHelpers::buffersMatch (*destinations[i], 0, *sources[i], 0, sources[i]->getNumSamples()));
+            }
+
+            auto stats = decoder.getStatistics();
+            expectEquals (stats.numFilesDecoded, files.size());
+            expectEquals (stats.numFilesFailed, 0);
+
+            int64 totalSamples = 0, totalBytes = 0;
+
+            for (auto* source : sources)
+            {
+                totalSamples += source->getNumSamples();
+                totalBytes += source->getNumSamples() * source->getNumChannels() * (int64) sizeof (float);
+            }
+
+            expectEquals (stats.numSamplesDecoded, totalSamples);
+            expectEquals (stats.numBytesDecoded, totalBytes);
+            expect (stats.getBytesPerSecond() > 0);
+        }
+
+        beginTest ("Files can be decoded into existing memory");
+        {
+            // two stereo files, one after the other, in a single block of memory
+            auto& first = *sources[1];
+            auto& second = *sources[3];
+            auto totalLength = first.getNumSamples() + second.getNumSamples();
+
+            HeapBlock<float> memory ((size_t) (2 * totalLength), true);
+            float* channels[] = { memory.get(), memory.get() + totalLength };
+            AudioBuffer<float> destination (channels, 2, totalLength);
+
+            AudioFormatBatchDecoder decoder (formatManager, 2);
+            AudioFormatBatchDecoder::Request request;
+            request.destination = &destination;
+            request.resizeDestination = false;
+
+            request.file = files[1];
+            auto firstID = decoder.addRequest (request);
+
+            request.file = files[3];
+            request.destStartSample = first.getNumSamples();
+            auto secondID = decoder.addRequest (request);
+
+            request.destStartSample = first.getNumSamples() + 1;
+            auto tooLongID = decoder.addRequest (request);
+
+            expect (decoder.waitUntilFinished (20000));
+            expect (decoder.getStatus (firstID) == AudioFormatBatchDecoder::Status::finished);
+            expect (decoder.getStatus (secondID) == AudioFormatBatchDecoder::Status::finished);
+            expect (decoder.getStatus (tooLongID) == AudioFormatBatchDecoder::Status::failed);
+            expect (destination.getReadPointer (0) == memory.get());
+
+            expect (AudioFormatTestHelpers::buffersMatch (destination, 0, first, 0, first.getNumSamples()));
+            expect (AudioFormatTestHelpers::buffersMatch (destination, first.getNumSamples(), second, 0, second.getNumSamples()));
+        }
+
+        beginTest ("Part of a file can be decoded");
+        {
+            AudioFormatBatchDecoder decoder (formatManager, 1);
+            AudioBuffer<float> destination;
+
+            AudioFormatBatchDecoder::Request request;
+            request.file = files[4];
+            request.destination = &destination;
+            request.startSampleInFile = 12345;
+            request.numSamples = 5000;
+            decoder.addRequest (request);
+
+            expect (decoder.waitUntilFinished (20000));
+            expectEquals (destination.getNumSamples(), 5000);
+            expect (AudioFormatTestHelpers::buffersMatch (destination, 0, *sources[4], 12345, 5000));
+        }
+
+        beginTest ("Requests are started in order of priority");
+        {
+            AudioFormatBatchDecoder decoder (formatManager, 1);
+            OwnedArray<AudioBuffer<float>> destinations;
+            Array<int> finishingOrder;
+            CriticalSection orderLock;
+            WaitableEvent allRequestsAdded;
+
+            const int priorities[] = { 10, 0, 5, 2, 5, 7 };
+
+            for (int i = 0; i < numElementsInArray (priorities); ++i)
+            {
+                AudioFormatBatchDecoder::Request request;
+                request.file = files[i];
+                request.destination = destinations.add (new AudioBuffer<float>());
+                request.priority = priorities[i];
+                request.onFinished = [&, i] (AudioFormatBatchDecoder::RequestID, AudioFormatBatchDecoder::Status)
+                {
+                    {
+                        const ScopedLock sl (orderLock);
+                        finishingOrder.add (i);
+                    }
+
+                    // hold on to the only thread until everything has been queued
+                    if (i == 0)
+                        allRequestsAdded.wait (20000);
+                };
+
+                decoder.addRequest (request);
+            }
+
+            allRequestsAdded.signal();
+            expect (decoder.waitUntilFinished (20000));
+            expect (finishingOrder == Array<int> (0, 5, 2, 4, 3, 1));
+        }
+
+        beginTest ("Requests can be cancelled");
+        {
+            AudioFormatBatchDecoder decoder (formatManager, 1);
+            OwnedArray<AudioBuffer<float>> destinations;
+            Array<AudioFormatBatchDecoder::RequestID> requestIDs;
+            std::atomic<int> numCancelledCallbacks { 0 };
+            WaitableEvent requestsCancelled;
+
+            for (int i = 0; i < files.size(); ++i)
+            {
+                AudioFormatBatchDecoder::Request request;
+                request.file = files[i];
+                request.destination = destinations.add (new AudioBuffer<float>());
+                request.priority = -i;
+                request.onFinished = [&, i] (AudioFormatBatchDecoder::RequestID, AudioFormatBatchDecoder::Status status)
+                {
+                    if (status == AudioFormatBatchDecoder::Status::cancelled)
+                        ++numCancelledCallbacks;
+
+                    if (i == 0)
+                        requestsCancelled.wait (20000);
+                };
+
+                requestIDs.add (decoder.addRequest (request));
+            }
+
+            while (decoder.getStatus (requestIDs.getFirst()) == AudioFormatBatchDecoder::Status::pending)
+                Thread::sleep (1);
+
+            // the first request's callback is holding up the only thread, so the rest are still pending
+            expect (decoder.cancel (requestIDs.getLast()));
+            expect (decoder.getStatus (requestIDs.getLast()) == AudioFormatBatchDecoder::Status::cancelled);
+            expect (destinations.getLast()->getNumSamples() == 0);
+            expect (! decoder.cancel (requestIDs.getLast()));
+            expect (! decoder.cancel (12345));
+            expect (decoder.getStatus (12345) == AudioFormatBatchDecoder::Status::unknown);
+
+            decoder.cancelAll();
+            requestsCancelled.signal();
+            expect (decoder.waitUntilFinished (20000));
+
+            auto stats = decoder.getStatistics();
+            expectEquals (stats.numFilesDecoded, 1);
+            expectEquals (stats.numFilesCancelled, files.size() - 1);
+            expectEquals (numCancelledCallbacks.load(), files.size() - 1);
+
+            decoder.resetStatistics();
+            expectEquals (decoder.getStatistics().numFilesCancelled, 0);
+            expect (decoder.getStatus (requestIDs.getLast()) == AudioFormatBatchDecoder::Status::unknown);
+        }
+
+        beginTest ("Missing files fail");
+        {
+            AudioFormatBatchDecoder decoder (formatManager, 1);
+            AudioBuffer<float> destination;
+
+            AudioFormatBatchDecoder::Request request;
+            request.file = folder.getChildFile ("nonexistent.wav");
+            request.destination = &destination;
+            auto requestID = decoder.addRequest (request);
+
+            expect (decoder.waitUntilFinished (20000));
+            expect (decoder.getStatus (requestID) == AudioFormatBatchDecoder::Status::failed);
+            expectEquals (decoder.getStatistics().numFilesFailed, 1);
+        }
+
+        folder.deleteRecursively();
+    }
+};
+
+static AudioFormatBatchDecoderTests audioFormatBatchDecoderTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,192 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+namespace juce
+{
+
+//==============================================================================
+/**
+    Opens and decodes many audio files at once, using a pool of worker threads.
+
+    This is intended for things like sample-library loading, where a long list of
+    files all need to be read into memory as quickly as possible. You add a Request
+    for each file, and the requests are carried out by the worker threads, highest
+    priority first. Each file is decoded into an AudioBuffer that you supply, which
+    can either be resized to fit the file or can refer to memory that you've already
+    allocated, such as a MemoryMappedFile.
+
+    Requests can be cancelled at any time, and getStatistics() will tell you how
+    quickly the decoding is going.
+
+    The AudioFormatManager is used from the worker threads, so you mustn't register
+    any formats with it while the decoder is running.
+
+    @see AudioFormatManager, AudioFormatReader
+
+    @tags{Audio}
+*/
+class JUCE_API  AudioFormatBatchDecoder
+{
+public:
+    //==============================================================================
+    /** Creates a decoder.
+
+        @param formatManager    the manager to use to open the files. This must not be
+                                deleted before the decoder
+        @param numberOfThreads  the number of files that can be decoded at once
+    */
+    AudioFormatBatchDecoder (AudioFormatManager& formatManager,
+                             int numberOfThreads = SystemStats::getNumCpus());
+
+    /** Destructor. Any requests that haven't finished are cancelled. */
+    ~AudioFormatBatchDecoder();
+
+    //==============================================================================
+    /** A unique ID that is given to each request. */
+    using RequestID = int;
+
+    /** The states that a request can be in. */
+    enum class Status
+    {
+        pending,    /**< The request is waiting for a worker thread. */
+        decoding,   /**< The file is being decoded. */
+        finished,   /**< The file was decoded successfully. */
+        failed,     /**< The file couldn't be opened, or was too long to fit in the destination. */
+        cancelled,  /**< The request was cancelled before it finished. */
+        unknown     /**< The ID doesn't belong to a request made by this decoder. */
+    };
+
+    /** Describes a file to decode and where to put the result. */
+    struct Request
+    {
+        /** The file to decode. */
+        File file;
+
+        /** The buffer to decode the file into. This must stay alive until the request
+            has finished or been cancelled, and you shouldn't touch it until then.
+        */
+        AudioBuffer<float>* destination = nullptr;
+
+        /** If true, the destination is resized to fit the file's channels and samples,
+            and destStartSample is ignored. If false, the file is read into the buffer's
+            existing channels starting at destStartSample, and the request fails if it
+            won't fit. Use that to decode into memory that you've allocated yourself,
+            with an AudioBuffer that refers to it.
+        */
+        bool resizeDestination = true;
+
+        /** The position in the destination at which to start writing, if it's not resized. */
+        int destStartSample = 0;
+
+        /** The first sample of the file to read. */
+        int64 startSampleInFile = 0;
+
+        /** The number of samples to read, or -1 to read to the end of the file. */
+        int64 numSamples = -1;
+
+        /** Requests with higher priorities are started first. Requests with the same
+            priority are started in the order they were added.
+        */
+        int priority = 0;
+
+        /** If this is set, it is called when the request finishes, fails, or is cancelled.
+            It's called on a worker thread, or if a request is cancelled before it
+            started, on the thread that cancelled it.
+        */
+        std::function<void (RequestID, Status)> onFinished;
+    };
+
+    /** Adds a request to the queue, and returns its ID. */
+    RequestID addRequest (const Request& request);
+
+    /** Returns the current status of a request. */
+    Status getStatus (RequestID requestID) const;
+
+    /** Cancels a request. A request that is already being decoded will stop soon
+        afterwards, leaving its destination partially filled.
+        Returns false if the request had already finished.
+    */
+    bool cancel (RequestID requestID);
+
+    /** Cancels all the requests that haven't finished yet. */
+    void cancelAll();
+
+    /** Returns the number of requests that are pending or being decoded. */
+    int getNumOutstandingRequests() const;
+
+    /** Waits until all the requests have finished or been cancelled.
+        Returns false if the timeout expired first. A timeout of less than 0 means
+        wait forever.
+    */
+    bool waitUntilFinished (int timeOutMilliseconds = -1) const;
+
+    //==============================================================================
+    /** Describes how much work the decoder has done. */
+    struct Statistics
+    {
+        int numFilesDecoded = 0;        /**< The number of requests that finished successfully. */
+        int numFilesFailed = 0;         /**< The number of requests that failed. */
+        int numFilesCancelled = 0;      /**< The number of requests that were cancelled. */
+        int64 numSamplesDecoded = 0;    /**< The total number of samples, per channel, that were decoded. */
+        int64 numBytesDecoded = 0;      /**< The total size of the decoded audio, in 32-bit floats. */
+        double decodingSeconds = 0;     /**< The time the worker threads spent on requests, added together. */
+        double elapsedSeconds = 0;      /**< The time since the first request was started, up to the last one finishing. */
+
+        /** Returns the number of decoded bytes per second of elapsed time. */
+        double getBytesPerSecond() const noexcept    { return elapsedSeconds > 0 ? (double) numBytesDecoded / elapsedSeconds : 0.0; }
+    };
+
+    /** Returns statistics about all the requests that have finished so far. */
+    Statistics getStatistics() const;
+
+    /** Clears the statistics, and the statuses of all the requests that have finished. */
+    void resetStatistics();
+
+private:
+    //==============================================================================
+    struct Task;
+
+    void decodeNextTask();
+    Status decode (Task&);
+    void finishTask (Task&, Status);
+
+    AudioFormatManager& formatManager;
+    CriticalSection lock;
+    OwnedArray<Task> pendingTasks, runningTasks;
+    std::map<RequestID, Status> finishedRequests;
+    RequestID nextRequestID = 1;
+    int nextSequenceNumber = 0;
+
+    Statistics statistics;
+    double firstStartTime = 0;
+    bool hasStarted = false;
+    WaitableEvent taskFinished;
+
+    // (declared last so that its threads are stopped before anything else is deleted)
+    ThreadPool threadPool;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioFormatBatchDecoder)
+};
+
+} // namespace juce
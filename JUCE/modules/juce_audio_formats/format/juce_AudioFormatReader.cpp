@@ -390,6 +390,16 @@ AudioChannelSet AudioFormatReader::getChannelLayout()
     return AudioChannelSet::canonicalChannelSet (static_cast<int> (numChannels));
 }
 
+AudioFormatSeekTable::Ptr AudioFormatReader::createSeekTable (int)
+{
+    return {};
+}
+
+bool AudioFormatReader::setSeekTable (AudioFormatSeekTable::Ptr)
+{
+    return false;
+}
+
 //==============================================================================
 MemoryMappedAudioFormatReader::MemoryMappedAudioFormatReader (const File& f, const AudioFormatReader& reader,
                                                               int64 start, int64 length, int frameSize)
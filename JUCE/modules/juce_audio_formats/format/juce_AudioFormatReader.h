@@ -247,6 +247,29 @@ public:
     /** Get the channel layout of the audio stream. */
     virtual AudioChannelSet getChannelLayout();
 
+    //==============================================================================
+    /** Scans the whole stream to build a table that lets the reader seek quickly.
+
+        Compressed formats such as FLAC and Ogg-Vorbis have to search the stream to
+        find a given sample, so random access into a long file is slow. A reader that
+        has been given a seek table with setSeekTable() can jump straight to the right
+        part of the stream instead.
+
+        This reads the entire stream, so it'll take a while, and should be called on a
+        background thread. If the calling thread is asked to stop, it will give up and
+        return nullptr. It also returns nullptr if the format doesn't need a seek table.
+
+        @see AudioFormatSeekTableCache
+    */
+    virtual AudioFormatSeekTable::Ptr createSeekTable (int samplesPerEntry = 4096);
+
+    /** Gives the reader a seek table that was made with createSeekTable() for the same
+        stream, and returns true if it'll be used.
+
+        Pass nullptr to go back to seeking in the format's default way.
+    */
+    virtual bool setSeekTable (AudioFormatSeekTable::Ptr seekTable);
+
     //==============================================================================
     /** Subclasses must implement this method to perform the low-level read operation.
 
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+namespace juce
+{
+
+AudioFormatSeekTable::AudioFormatSeekTable (const Array<SeekPoint>& seekPoints, int64 length, int spacing)
+    : lengthInSamples (length),
+      samplesPerEntry (jmax (1, spacing))
+{
+    if (seekPoints.isEmpty() || lengthInSamples <= 0)
+        return;
+
+    // the seek points must be in order, and the first one must be at the start of the stream
+    jassert (seekPoints.getFirst().sampleNumber <= 0);
+
+    auto numEntries = (int) ((lengthInSamples + samplesPerEntry - 1) / samplesPerEntry);
+    entries.ensureStorageAllocated (numEntries);
+
+    for (int i = 0, pointIndex = 0; i < numEntries; ++i)
+    {
+        auto entryStart = (int64) i * samplesPerEntry;
+
+        while (pointIndex + 1 < seekPoints.size() && seekPoints.getReference (pointIndex + 1).sampleNumber <= entryStart)
+        {
+            jassert (seekPoints.getReference (pointIndex + 1).sampleNumber >= seekPoints.getReference (pointIndex).sampleNumber);
+            ++pointIndex;
+        }
+
+        entries.add (seekPoints.getReference (pointIndex));
+    }
+}
+
+AudioFormatSeekTable::~AudioFormatSeekTable()
+{
+}
+
+static int getSeekTableMagicHeader() noexcept
+{
+    return (int) ByteOrder::littleEndianInt ("SkTb");
+}
+
+void AudioFormatSeekTable::writeToStream (OutputStream& output) const
+{
+    output.writeInt (getSeekTableMagicHeader());
+    output.writeInt64 (lengthInSamples);
+    output.writeInt (samplesPerEntry);
+    output.writeInt (entries.size());
+
+    for (auto& entry : entries)
+    {
+        output.writeInt64 (entry.sampleNumber);
+        output.writeInt64 (entry.byteOffset);
+    }
+}
+
+bool AudioFormatSeekTable::readFromStream (InputStream& input)
+{
+    entries.clear();
+
+    if (input.readInt() != getSeekTableMagicHeader())
+        return false;
+
+    lengthInSamples = input.readInt64();
+    samplesPerEntry = input.readInt();
+    auto numEntries = input.readInt();
+
+    if (lengthInSamples <= 0 || samplesPerEntry <= 0
+         || numEntries != (int) ((lengthInSamples + samplesPerEntry - 1) / samplesPerEntry))
+        return false;
+
+    auto numBytesRemaining = input.getNumBytesRemaining();
+
+    if (numBytesRemaining >= 0 && numBytesRemaining < (int64) numEntries * 16)
+        return false;
+
+    entries.ensureStorageAllocated (numEntries);
+
+    for (int i = 0; i < numEntries; ++i)
+    {
+        SeekPoint entry;
+        entry.sampleNumber = input.readInt64();
+        entry.byteOffset = input.readInt64();
+
+        entries.add (entry);
+    }
+
+    return true;
+}
+
+} // namespace juce
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+namespace juce
+{
+
+//==============================================================================
+/**
+    A table that maps sample positions in a compressed audio stream to the byte
+    positions that a decoder can start from.
+
+    Formats such as FLAC and Ogg-Vorbis can't work out where a sample is stored
+    without searching the stream for it, so jumping around in a long file is slow.
+    A seek table is built once by scanning the whole stream with
+    AudioFormatReader::createSeekTable(), and can then be given to any reader that
+    opens the same file, so that it can jump straight to a point just before the
+    sample it needs.
+
+    The table holds one entry per block of samplesPerEntry samples, so looking up
+    a position takes constant time.
+
+    @see AudioFormatReader::createSeekTable, AudioFormatSeekTableCache
+
+    @tags{Audio}
+*/
+class JUCE_API  AudioFormatSeekTable  : public ReferenceCountedObject
+{
+public:
+    //==============================================================================
+    /** A position in the stream from which a decoder can start reading. */
+    struct SeekPoint
+    {
+        /** The index of the first sample that will be decoded from this point. */
+        int64 sampleNumber;
+
+        /** The byte offset in the stream at which to start decoding. */
+        int64 byteOffset;
+    };
+
+    //==============================================================================
+    /** Creates an empty table. */
+    AudioFormatSeekTable() = default;
+
+    /** Creates a table from a list of seek points.
+
+        @param seekPoints           all the points in the stream that the decoder could start
+                                    from, in order. The first one should be at sample 0
+        @param lengthInSamples      the length of the stream
+        @param samplesPerEntry      the spacing of the table's entries. Each entry will hold
+                                    the last seek point before the start of its block
+    */
+    AudioFormatSeekTable (const Array<SeekPoint>& seekPoints, int64 lengthInSamples, int samplesPerEntry);
+
+    /** Destructor. */
+    ~AudioFormatSeekTable() override;
+
+    //==============================================================================
+    /** Returns a seek point at or before the given sample.
+
+        When decoding starts from this point, the sample will be reached within
+        roughly getSamplesPerEntry() samples.
+    */
+    SeekPoint getSeekPointBefore (int64 sampleNumber) const noexcept
+    {
+        jassert (! isEmpty());
+        auto index = (int) jlimit ((int64) 0, (int64) entries.size() - 1, sampleNumber / samplesPerEntry);
+
+        // the next entry's point may start before its block does, and be a closer one
+        if (index + 1 < entries.size() && entries.getReference (index + 1).sampleNumber <= sampleNumber)
+            return entries.getReference (index + 1);
+
+        return entries.getReference (index);
+    }
+
+    /** Returns true if the table has no entries. */
+    bool isEmpty() const noexcept                       { return entries.isEmpty(); }
+
+    /** Returns the number of entries in the table. */
+    int getNumEntries() const noexcept                  { return entries.size(); }
+
+    /** Returns the spacing of the table's entries, in samples. */
+    int getSamplesPerEntry() const noexcept             { return samplesPerEntry; }
+
+    /** Returns the length of the stream that the table was made for. */
+    int64 getLengthInSamples() const noexcept           { return lengthInSamples; }
+
+    //==============================================================================
+    /** Writes the table to a stream, so that it can be re-loaded with readFromStream(). */
+    void writeToStream (OutputStream& output) const;
+
+    /** Replaces the contents of the table with data written by writeToStream().
+        Returns false if the data wasn't valid, in which case the table will be left empty.
+    */
+    bool readFromStream (InputStream& input);
+
+    /** A convenient typedef for a pointer to an AudioFormatSeekTable. */
+    using Ptr = ReferenceCountedObjectPtr<AudioFormatSeekTable>;
+
+private:
+    //==============================================================================
+    Array<SeekPoint> entries;
+    int64 lengthInSamples = 0;
+    int samplesPerEntry = 1;
+
+    JUCE_LEAK_DETECTOR (AudioFormatSeekTable)
+};
+
+} // namespace juce
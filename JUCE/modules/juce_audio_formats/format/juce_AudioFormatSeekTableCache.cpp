@@ -0,0 +1,434 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+namespace juce
+{
+
+class AudioFormatSeekTableCache::Builder  : public TimeSliceClient
+{
+public:
+    Builder (AudioFormatSeekTableCache& c) : owner (c) {}
+
+    int useTimeSlice() override
+    {
+        return owner.buildNextTable() ? 0 : 100;
+    }
+
+private:
+    AudioFormatSeekTableCache& owner;
+
+    JUCE_DECLARE_NON_COPYABLE (Builder)
+};
+
+//==============================================================================
+AudioFormatSeekTableCache::AudioFormatSeekTableCache (AudioFormatManager& manager, int maxNumTables, int spacing)
+    : formatManager (manager),
+      thread ("seek table cache"),
+      builder (new Builder (*this)),
+      maxNumTablesToStore (maxNumTables),
+      samplesPerEntry (spacing)
+{
+    jassert (maxNumTablesToStore > 0 && samplesPerEntry > 0);
+    thread.startThread (2);
+}
+
+AudioFormatSeekTableCache::~AudioFormatSeekTableCache()
+{
+    // a scan that's in progress will give up when the thread is asked to stop
+    thread.stopThread (10000);
+    thread.removeTimeSliceClient (builder.get());
+}
+
+int64 AudioFormatSeekTableCache::getHashCode (const File& file)
+{
+    return file.hashCode64() ^ file.getLastModificationTime().toMilliseconds() ^ (file.getSize() << 24);
+}
+
+AudioFormatSeekTableCache::CacheEntry* AudioFormatSeekTableCache::findEntryFor (int64 hash) const
+{
+    for (int i = entries.size(); --i >= 0;)
+        if (entries.getUnchecked (i)->hash == hash)
+            return entries.getUnchecked (i);
+
+    return nullptr;
+}
+
+//==============================================================================
+AudioFormatReader* AudioFormatSeekTableCache::createReaderFor (const File& file)
+{
+    auto* reader = formatManager.createReaderFor (file);
+
+    if (reader != nullptr)
+        if (auto table = getSeekTable (file))
+            reader->setSeekTable (table);
+
+    return reader;
+}
+
+AudioFormatSeekTable::Ptr AudioFormatSeekTableCache::getSeekTable (const File& file, bool buildIfMissing)
+{
+    const ScopedLock sl (lock);
+
+    if (auto* entry = findEntryFor (getHashCode (file)))
+    {
+        entry->lastUsed = Time::getMillisecondCounter();
+        return entry->table;
+    }
+
+    if (buildIfMissing && ! filesToBuild.contains (file))
+    {
+        filesToBuild.add (file);
+        thread.addTimeSliceClient (builder.get());
+    }
+
+    return {};
+}
+
+int AudioFormatSeekTableCache::getNumTablesWaitingToBeBuilt() const
+{
+    const ScopedLock sl (lock);
+    return filesToBuild.size();
+}
+
+bool AudioFormatSeekTableCache::buildNextTable()
+{
+    File file;
+
+    {
+        const ScopedLock sl (lock);
+
+        if (filesToBuild.isEmpty())
+            return false;
+
+        file = filesToBuild.getFirst();
+    }
+
+    auto hash = getHashCode (file);
+    auto table = loadNewSeekTable (hash);
+
+    if (table == nullptr)
+    {
+        std::unique_ptr<AudioFormatReader> reader (formatManager.createReaderFor (file));
+
+        if (reader != nullptr)
+            table = reader->createSeekTable (samplesPerEntry);
+
+        if (thread.threadShouldExit())
+            return false;
+
+        if (table != nullptr)
+            saveNewlyBuiltSeekTable (*table, hash);
+    }
+
+    // files that don't need a table are stored too, so that they aren't scanned again
+    storeTable (hash, table);
+
+    const ScopedLock sl (lock);
+    filesToBuild.removeFirstMatchingValue (file);
+    return ! filesToBuild.isEmpty();
+}
+
+void AudioFormatSeekTableCache::storeTable (int64 hash, AudioFormatSeekTable::Ptr table)
+{
+    const ScopedLock sl (lock);
+    auto* entry = findEntryFor (hash);
+
+    if (entry == nullptr)
+    {
+        entry = new CacheEntry();
+        entry->hash = hash;
+
+        if (entries.size() < maxNumTablesToStore)
+        {
+            entries.add (entry);
+        }
+        else
+        {
+            int oldest = 0;
+
+            for (int i = entries.size(); --i > 0;)
+                if (entries.getUnchecked (i)->lastUsed < entries.getUnchecked (oldest)->lastUsed)
+                    oldest = i;
+
+            entries.set (oldest, entry);
+        }
+    }
+
+    entry->lastUsed = Time::getMillisecondCounter();
+    entry->table = table;
+}
+
+void AudioFormatSeekTableCache::clear()
+{
+    const ScopedLock sl (lock);
+    entries.clear();
+}
+
+void AudioFormatSeekTableCache::removeSeekTable (const File& file)
+{
+    const ScopedLock sl (lock);
+    auto hash = getHashCode (file);
+
+    for (int i = entries.size(); --i >= 0;)
+        if (entries.getUnchecked (i)->hash == hash)
+            entries.remove (i);
+}
+
+//==============================================================================
+static int getSeekTableCacheFileMagicHeader() noexcept
+{
+    return (int) ByteOrder::littleEndianInt ("SkTC");
+}
+
+bool AudioFormatSeekTableCache::readFromStream (InputStream& source)
+{
+    if (source.readInt() != getSeekTableCacheFileMagicHeader())
+        return false;
+
+    const ScopedLock sl (lock);
+    clear();
+    auto numTables = source.readInt();
+
+    for (int i = 0; i < numTables && ! source.isExhausted(); ++i)
+    {
+        auto hash = source.readInt64();
+        AudioFormatSeekTable::Ptr table (new AudioFormatSeekTable());
+
+        if (! table->readFromStream (source))
+            return false;
+
+        if (entries.size() < maxNumTablesToStore)
+            storeTable (hash, table);
+    }
+
+    return true;
+}
+
+void AudioFormatSeekTableCache::writeToStream (OutputStream& out)
+{
+    const ScopedLock sl (lock);
+
+    int numTables = 0;
+
+    for (auto* entry : entries)
+        if (entry->table != nullptr)
+            ++numTables;
+
+    out.writeInt (getSeekTableCacheFileMagicHeader());
+    out.writeInt (numTables);
+
+    for (auto* entry : entries)
+    {
+        if (entry->table != nullptr)
+        {
+            out.writeInt64 (entry->hash);
+            entry->table->writeToStream (out);
+        }
+    }
+}
+
+void AudioFormatSeekTableCache::saveNewlyBuiltSeekTable (const AudioFormatSeekTable&, int64)
+{
+}
+
+AudioFormatSeekTable::Ptr AudioFormatSeekTableCache::loadNewSeekTable (int64)
+{
+    return {};
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct AudioFormatSeekTableCacheTests  : public UnitTest
+{
+    AudioFormatSeekTableCacheTests()
+        : UnitTest ("Audio format seek table cache", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        auto folder = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("SeekTableTests", {});
+        folder.createDirectory();
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        const int numSamples = 44100 * 8;
+        Random random (1);
+        auto source = AudioFormatTestHelpers::createTestSignal (random, 2, numSamples);
+
+        Array<File> files;
+
+        for (auto extension : { ".flac", ".ogg", ".wav" })
+            files.add (AudioFormatTestHelpers::writeFile (formatManager, folder.getChildFile (String ("test") + extension), source));
+
+        auto& flacFile = files.getReference (0);
+        auto& oggFile = files.getReference (1);
+        auto& wavFile = files.getReference (2);
+
+        AudioFormatSeekTableCache cache (formatManager, 10);
+
+        beginTest ("Tables are built in the background");
+        {
+            for (auto& file : files)
+                expect (cache.getSeekTable (file) == nullptr);
+
+            expect (waitForTables (cache));
+
+            for (auto& file : { flacFile, oggFile })
+            {
+                auto table = cache.getSeekTable (file, false);
+                expect (table != nullptr);
+
+                if (table != nullptr)
+                {
+                    expectEquals (table->getLengthInSamples(), (int64) numSamples);
+                    expectEquals (table->getSamplesPerEntry(), 4096);
+                    expectEquals (table->getNumEntries(), (numSamples + 4095) / 4096);
+
+                    // a flac stream can be entered at any frame, but an ogg stream only at the start of a page
+                    auto maxDistance = file == flacFile ? 4096 + 4608 : 44100;
+                    bool allInRange = true;
+
+                    for (int64 i = 0; i < numSamples; i += 1000)
+                    {
+                        auto point = table->getSeekPointBefore (i);
+                        allInRange = allInRange && point.sampleNumber <= i && point.sampleNumber > i - maxDistance;
+                    }
+
+                    expect (allInRange, file.getFileName());
+                }
+            }
+
+            // wav files can already seek quickly, so they don't get a table
+            expect (cache.getSeekTable (wavFile) == nullptr);
+            expectEquals (cache.getNumTablesWaitingToBeBuilt(), 0);
+        }
+
+        beginTest ("Random access reads match sequential reads");
+        {
+            for (auto& file : { flacFile, oggFile })
+            {
+                std::unique_ptr<AudioFormatReader> sequentialReader (formatManager.createReaderFor (file));
+                AudioBuffer<float> expected (2, numSamples);
+                sequentialReader->read (&expected, 0, numSamples, 0, true, true);
+
+                std::unique_ptr<AudioFormatReader> reader (cache.createReaderFor (file));
+                expect (reader != nullptr);
+
+                Random fileRandom (file.getSize());
+                AudioBuffer<float> block (2, 2000);
+                bool allMatched = true;
+
+                for (int i = 0; i < 300; ++i)
+                {
+                    // include some reads that run past the end, and some that are close together
+                    auto start = i % 10 == 0 ? numSamples - fileRandom.nextInt (1000)
+                                             : fileRandom.nextInt (numSamples);
+                    auto length = 1 + fileRandom.nextInt (block.getNumSamples() - 1);
+
+                    reader->read (&block, 0, length, start, true, true);
+                    allMatched = AudioFormatTestHelpers::buffersMatch (block, 0, expected, start, length) && allMatched;
+
+                    auto nextStart = start + length + fileRandom.nextInt (300);
+                    reader->read (&block, 0, 100, nextStart, true, true);
+                    allMatched = AudioFormatTestHelpers::buffersMatch (block, 0, expected, nextStart, 100) && allMatched;
+                }
+
+                expect (allMatched, file.getFileName());
+            }
+        }
+
+        beginTest ("Readers only accept tables that fit their stream");
+        {
+            std::unique_ptr<AudioFormatReader> flacReader (formatManager.createReaderFor (flacFile));
+            std::unique_ptr<AudioFormatReader> wavReader (formatManager.createReaderFor (wavFile));
+
+            Array<AudioFormatSeekTable::SeekPoint> seekPoints;
+            seekPoints.add ({ 0, 0 });
+
+            AudioFormatSeekTable::Ptr wrongLength (new AudioFormatSeekTable (seekPoints, numSamples - 1, 4096));
+            AudioFormatSeekTable::Ptr empty (new AudioFormatSeekTable());
+
+            expect (! flacReader->setSeekTable (wrongLength));
+            expect (! flacReader->setSeekTable (empty));
+            expect (flacReader->setSeekTable (cache.getSeekTable (flacFile)));
+            expect (flacReader->setSeekTable (nullptr));
+            expect (! wavReader->setSeekTable (cache.getSeekTable (flacFile)));
+        }
+
+        beginTest ("Tables can be saved and re-loaded");
+        {
+            MemoryOutputStream out;
+            cache.writeToStream (out);
+
+            AudioFormatSeekTableCache reloaded (formatManager, 10);
+            MemoryInputStream in (out.getData(), out.getDataSize(), false);
+            expect (reloaded.readFromStream (in));
+
+            for (auto& file : { flacFile, oggFile })
+            {
+                auto original = cache.getSeekTable (file, false);
+                auto copy = reloaded.getSeekTable (file, false);
+                expect (copy != nullptr);
+
+                if (copy != nullptr)
+                {
+                    expectEquals (copy->getNumEntries(), original->getNumEntries());
+                    bool allMatched = true;
+
+                    for (int64 i = 0; i < numSamples; i += 777)
+                        allMatched = allMatched && copy->getSeekPointBefore (i).byteOffset == original->getSeekPointBefore (i).byteOffset;
+
+                    expect (allMatched);
+                }
+            }
+
+            MemoryInputStream truncated (out.getData(), out.getDataSize() / 2, false);
+            expect (! reloaded.readFromStream (truncated));
+        }
+
+        folder.deleteRecursively();
+    }
+
+private:
+    static bool waitForTables (AudioFormatSeekTableCache& cache)
+    {
+        for (int i = 0; i < 3000; ++i)
+        {
+            if (cache.getNumTablesWaitingToBeBuilt() == 0)
+                return true;
+
+            Thread::sleep (10);
+        }
+
+        return false;
+    }
+};
+
+static AudioFormatSeekTableCacheTests audioFormatSeekTableCacheTests;
+
+#endif
+
+} // namespace juce
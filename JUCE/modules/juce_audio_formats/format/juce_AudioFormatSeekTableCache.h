@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+namespace juce
+{
+
+//==============================================================================
+/**
+    Builds and keeps the seek tables for a set of audio files.
+
+    Readers for compressed formats such as FLAC and Ogg-Vorbis can only jump to a
+    position in a file quickly if they've been given an AudioFormatSeekTable, and
+    making one means scanning the whole file. This class does that on a background
+    thread, the first time each file is asked for, and keeps the results so that
+    any reader that's opened for the same file later can use them.
+
+    The tables can be saved and re-loaded with writeToStream() and readFromStream(),
+    or you can override saveNewlyBuiltSeekTable() and loadNewSeekTable() to keep them
+    somewhere else, in the same way as an AudioThumbnailCache.
+
+    @see AudioFormatSeekTable, AudioFormatReader::createSeekTable
+
+    @tags{Audio}
+*/
+class JUCE_API  AudioFormatSeekTableCache
+{
+public:
+    //==============================================================================
+    /** Creates a cache.
+
+        @param formatManager        the formats to open files with. This must outlive the cache
+        @param maxNumTablesToStore  the number of tables to keep in memory at once
+        @param samplesPerEntry      the spacing of the entries in the tables that are built.
+                                    The smaller this is, the less a reader has to decode after
+                                    each jump, but the more memory the tables take up
+    */
+    AudioFormatSeekTableCache (AudioFormatManager& formatManager,
+                               int maxNumTablesToStore,
+                               int samplesPerEntry = 4096);
+
+    /** Destructor. */
+    virtual ~AudioFormatSeekTableCache();
+
+    //==============================================================================
+    /** Creates a reader for a file, giving it the file's seek table if there is one.
+
+        If the file hasn't been scanned yet, this starts building its table on the
+        background thread, and the reader that's returned will seek in the normal way.
+        Returns nullptr if none of the formats can open the file.
+    */
+    AudioFormatReader* createReaderFor (const File& file);
+
+    /** Returns the seek table for a file, or nullptr if it hasn't been built yet, or if
+        the file's format doesn't need one.
+
+        If the file isn't in the cache and buildIfMissing is true, this starts building
+        its table on the background thread.
+    */
+    AudioFormatSeekTable::Ptr getSeekTable (const File& file, bool buildIfMissing = true);
+
+    /** Returns the number of files that are waiting to be scanned. */
+    int getNumTablesWaitingToBeBuilt() const;
+
+    /** Clears out all the stored tables. */
+    void clear();
+
+    /** Tells the cache to forget about the table for a file. */
+    void removeSeekTable (const File& file);
+
+    //==============================================================================
+    /** Attempts to re-load a saved set of tables from a stream.
+        The data must have been written by the writeToStream() method. This will
+        replace all the tables that are currently loaded.
+    */
+    bool readFromStream (InputStream& source);
+
+    /** Writes all the currently-loaded tables to a stream.
+        The resulting data can be re-loaded with readFromStream().
+    */
+    void writeToStream (OutputStream& stream);
+
+    /** Returns the key that a file's table is stored under. This changes when the file
+        is modified.
+    */
+    static int64 getHashCode (const File& file);
+
+    /** Returns the thread that the tables are built on. */
+    TimeSliceThread& getTimeSliceThread() noexcept      { return thread; }
+
+protected:
+    /** This can be overridden to provide a custom callback for saving tables once
+        they have been built.
+    */
+    virtual void saveNewlyBuiltSeekTable (const AudioFormatSeekTable&, int64 hashCode);
+
+    /** This can be overridden to load tables that were saved earlier, to save the
+        cache the trouble of scanning the file again.
+    */
+    virtual AudioFormatSeekTable::Ptr loadNewSeekTable (int64 hashCode);
+
+private:
+    //==============================================================================
+    struct CacheEntry
+    {
+        int64 hash;
+        uint32 lastUsed;
+        AudioFormatSeekTable::Ptr table;
+    };
+
+    class Builder;
+
+    AudioFormatManager& formatManager;
+    TimeSliceThread thread;
+    std::unique_ptr<Builder> builder;
+    OwnedArray<CacheEntry> entries;
+    Array<File> filesToBuild;
+    CriticalSection lock;
+    int maxNumTablesToStore, samplesPerEntry;
+
+    CacheEntry* findEntryFor (int64 hash) const;
+    void storeTable (int64 hash, AudioFormatSeekTable::Ptr);
+    bool buildNextTable();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioFormatSeekTableCache)
+};
+
+} // namespace juce
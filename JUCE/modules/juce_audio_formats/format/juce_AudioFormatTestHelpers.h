@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+// Fixtures shared by the unit tests of this module.
+struct AudioFormatTestHelpers
+{
+    // A sine wave per channel with a little noise on top, so that the
+    // encoders have something to do and every sample is different
+    static AudioBuffer<float> createTestSignal (Random& random, int numChannels, int numSamples)
+    {
+        AudioBuffer<float> buffer (numChannels, numSamples);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (ch, i, 0.5f * std::sin ((float) i * 0.01f * (float) (ch + 1))
+                                          + 0.1f * (random.nextFloat() - 0.5f));
+
+        return buffer;
+    }
+
+    // Writes the buffer to a file of the format that matches its extension,
+    // in 24 bits, or 16 for Ogg Vorbis
+    static File writeFile (AudioFormatManager& formatManager, const File& file, const AudioBuffer<float>& source)
+    {
+        auto* format = formatManager.findFormatForFileExtension (file.getFileExtension());
+        auto bitDepth = file.hasFileExtension ("ogg") ? 16 : 24;
+
+        std::unique_ptr<AudioFormatWriter> writer (format->createWriterFor (file.createOutputStream().release(), 44100.0,
+                                                                            (unsigned int) source.getNumChannels(), bitDepth, {}, 0));
+        writer->writeFromAudioSampleBuffer (source, 0, source.getNumSamples());
+        return file;
+    }
+
+    // Compares a range of decoded samples with the source they came from. 24-bit
+    // files aren't an exact copy of the original floats, so this allows for that,
+    // and samples past the end of the source are expected to be silent.
+    static bool buffersMatch (const AudioBuffer<float>& decoded, int decodedStart,
+                              const AudioBuffer<float>& source, int sourceStart, int numSamples)
+    {
+        if (decoded.getNumChannels() < source.getNumChannels() || decoded.getNumSamples() < decodedStart + numSamples)
+            return false;
+
+        for (int ch = 0; ch < source.getNumChannels(); ++ch)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto expected = sourceStart + i < source.getNumSamples() ? source.getSample (ch, sourceStart + i) : 0.0f;
+
+                if (std::abs (decoded.getSample (ch, decodedStart + i) - expected) > 1.0e-6f)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+};
+
+} // namespace juce
@@ -52,14 +52,22 @@
 #endif
 
 //==============================================================================
+#if JUCE_UNIT_TESTS
+ #include "format/juce_AudioFormatTestHelpers.h"
+#endif
+
 #include "format/juce_AudioFormat.cpp"
 #include "format/juce_AudioFormatManager.cpp"
 #include "format/juce_AudioFormatReader.cpp"
+#include "format/juce_AudioFormatSeekTable.cpp"
 #include "format/juce_AudioFormatReaderSource.cpp"
 #include "format/juce_AudioFormatWriter.cpp"
 #include "format/juce_AudioSubsectionReader.cpp"
 #include "format/juce_BufferingAudioFormatReader.cpp"
+#include "format/juce_AudioFormatBatchDecoder.cpp"
+#include "format/juce_AudioFormatSeekTableCache.cpp"
 #include "sampler/juce_Sampler.cpp"
+#include "sampler/juce_StreamingSampler.cpp"
 #include "codecs/juce_AiffAudioFormat.cpp"
 #include "codecs/juce_CoreAudioFormat.cpp"
 #include "codecs/juce_FlacAudioFormat.cpp"
@@ -110,14 +110,17 @@
 #endif
 
 //==============================================================================
+#include "format/juce_AudioFormatSeekTable.h"
 #include "format/juce_AudioFormatReader.h"
 #include "format/juce_AudioFormatWriter.h"
 #include "format/juce_MemoryMappedAudioFormatReader.h"
 #include "format/juce_AudioFormat.h"
 #include "format/juce_AudioFormatManager.h"
+#include "format/juce_AudioFormatSeekTableCache.h"
 #include "format/juce_AudioFormatReaderSource.h"
 #include "format/juce_AudioSubsectionReader.h"
 #include "format/juce_BufferingAudioFormatReader.h"
+#include "format/juce_AudioFormatBatchDecoder.h"
 #include "codecs/juce_AiffAudioFormat.h"
 #include "codecs/juce_CoreAudioFormat.h"
 #include "codecs/juce_FlacAudioFormat.h"
@@ -127,3 +130,4 @@
 #include "codecs/juce_WavAudioFormat.h"
 #include "codecs/juce_WindowsMediaAudioFormat.h"
 #include "sampler/juce_Sampler.h"
+#include "sampler/juce_StreamingSampler.h"
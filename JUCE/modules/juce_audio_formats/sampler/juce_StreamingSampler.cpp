@@ -0,0 +1,670 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+namespace juce
+{
+
+class SampleStreamScheduler::ReaderThread  : public Thread
+{
+public:
+    ReaderThread (SampleStreamScheduler& s, int index)
+        : Thread ("Sample streaming " + String (index)), owner (s)
+    {
+        streamsToFill.ensureStorageAllocated (owner.streams.size());
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+            if (! owner.fillStreams (streamsToFill))
+                wait (1);
+    }
+
+private:
+    SampleStreamScheduler& owner;
+    StreamQueue streamsToFill;
+
+    JUCE_DECLARE_NON_COPYABLE (ReaderThread)
+};
+
+//==============================================================================
+SampleStreamScheduler::SampleStreamScheduler (int maxNumStreams, int samplesPerStream, int numThreads)
+{
+    jassert (maxNumStreams > 0 && samplesPerStream > 1);
+
+    for (int i = 0; i < maxNumStreams; ++i)
+        streams.add (new Stream (samplesPerStream));
+
+    streamsToFill.ensureStorageAllocated (maxNumStreams);
+
+    for (int i = 0; i < numThreads; ++i)
+    {
+        auto* thread = threads.add (new ReaderThread (*this, i));
+        thread->startThread (6);
+    }
+}
+
+SampleStreamScheduler::~SampleStreamScheduler()
+{
+    for (auto* thread : threads)
+        thread->signalThreadShouldExit();
+
+    for (auto* thread : threads)
+        thread->stopThread (4000);
+
+    // all the voices that use this scheduler must be deleted before it is!
+    for (auto* stream : streams)
+        jassert (stream->state.load() != streamPlaying);
+}
+
+int SampleStreamScheduler::getNumActiveStreams() const noexcept
+{
+    int num = 0;
+
+    for (auto* stream : streams)
+        if (stream->state.load() != streamFree)
+            ++num;
+
+    return num;
+}
+
+//==============================================================================
+bool SampleStreamScheduler::fillStreams()
+{
+    return fillStreams (streamsToFill);
+}
+
+bool SampleStreamScheduler::fillStreams (StreamQueue& queue)
+{
+    queue.clearQuick();
+
+    for (auto* stream : streams)
+    {
+        auto state = stream->state.load();
+
+        if (state == streamReleased)
+        {
+            recycleStream (*stream);
+        }
+        else if (state == streamPlaying)
+        {
+            // the urgency is roughly the time the voice has left before it runs dry
+            auto rate = jmax (1.0e-3, (double) stream->playbackRate.load());
+            queue.add ({ stream->fifo.getNumReady() / rate, stream });
+        }
+    }
+
+    std::sort (queue.begin(), queue.end(),
+               [] (const std::pair<double, Stream*>& a, const std::pair<double, Stream*>& b) { return a.first < b.first; });
+
+    bool anythingRead = false;
+
+    for (auto& s : queue)
+        anythingRead = fillStream (*s.second) || anythingRead;
+
+    return anythingRead;
+}
+
+bool SampleStreamScheduler::fillStream (Stream& stream)
+{
+    bool expected = false;
+
+    if (! stream.isBeingFilled.compare_exchange_strong (expected, true))
+        return false;
+
+    bool didRead = false;
+
+    if (stream.state.load() == streamPlaying)
+    {
+        auto& sound = *stream.sound;
+        auto& fifo = stream.fifo;
+        auto numLeftInFile = sound.length - stream.nextReadPosition;
+        auto chunkSize = (int) jmin ((int64) readChunkSize.load(), (int64) fifo.getTotalSize() - 1, numLeftInFile);
+        auto numToRead = jmin (chunkSize, fifo.getFreeSpace());
+
+        // only read whole chunks, unless it's the last one in the file
+        if (numToRead > 0 && numToRead == chunkSize)
+        {
+            int start1, size1, start2, size2;
+            fifo.prepareToWrite (numToRead, start1, size1, start2, size2);
+
+            sound.readIntoStream (stream.buffer, start1, stream.nextReadPosition, size1);
+            sound.readIntoStream (stream.buffer, start2, stream.nextReadPosition + size1, size2);
+
+            stream.nextReadPosition += size1 + size2;
+            fifo.finishedWrite (size1 + size2);
+            didRead = true;
+        }
+    }
+
+    stream.isBeingFilled = false;
+    return didRead;
+}
+
+void SampleStreamScheduler::recycleStream (Stream& stream)
+{
+    bool expected = false;
+
+    if (stream.isBeingFilled.compare_exchange_strong (expected, true))
+    {
+        if (stream.state.load() == streamReleased)
+        {
+            // the sound is released here rather than on the audio thread, in case this
+            // was the last reference to it
+            stream.sound = nullptr;
+            stream.state = streamFree;
+        }
+
+        stream.isBeingFilled = false;
+    }
+}
+
+SampleStreamScheduler::Stream* SampleStreamScheduler::claimStream (StreamingSamplerSound& sound, double playbackRate) noexcept
+{
+    for (auto* stream : streams)
+    {
+        int expected = streamFree;
+
+        if (stream->state.compare_exchange_strong (expected, streamClaimed))
+        {
+            stream->sound = &sound;
+            stream->fifo.reset();
+            stream->nextReadPosition = sound.headLength;
+            stream->playbackRate = (float) playbackRate;
+            stream->state = streamPlaying;
+            return stream;
+        }
+    }
+
+    return nullptr;
+}
+
+void SampleStreamScheduler::releaseStream (Stream* stream) noexcept
+{
+    jassert (stream != nullptr && stream->state.load() == streamPlaying);
+    stream->state = streamReleased;
+}
+
+//==============================================================================
+StreamingSamplerSound::StreamingSamplerSound (const String& soundName,
+                                              AudioFormatManager& formatManager,
+                                              const File& file,
+                                              const BigInteger& notes,
+                                              int midiNoteForNormalPitch,
+                                              double attackTimeSecs,
+                                              double releaseTimeSecs,
+                                              int numSamplesToPreload)
+    : name (soundName),
+      midiNotes (notes),
+      midiRootNote (midiNoteForNormalPitch)
+{
+    AudioFormatReader* source = nullptr;
+
+    if (auto* format = formatManager.findFormatForFileExtension (file.getFileExtension()))
+    {
+        std::unique_ptr<MemoryMappedAudioFormatReader> mappedReader (format->createMemoryMappedReader (file));
+
+        if (mappedReader != nullptr && mappedReader->mapEntireFile())
+        {
+            source = mappedReader.release();
+            memoryMapped = true;
+        }
+    }
+
+    if (source == nullptr)
+        source = formatManager.createReaderFor (file);
+
+    initialise (source, attackTimeSecs, releaseTimeSecs, numSamplesToPreload);
+}
+
+StreamingSamplerSound::StreamingSamplerSound (const String& soundName,
+                                              AudioFormatReader* source,
+                                              const BigInteger& notes,
+                                              int midiNoteForNormalPitch,
+                                              double attackTimeSecs,
+                                              double releaseTimeSecs,
+                                              int numSamplesToPreload)
+    : name (soundName),
+      midiNotes (notes),
+      midiRootNote (midiNoteForNormalPitch)
+{
+    initialise (source, attackTimeSecs, releaseTimeSecs, numSamplesToPreload);
+}
+
+StreamingSamplerSound::~StreamingSamplerSound()
+{
+}
+
+void StreamingSamplerSound::initialise (AudioFormatReader* source, double attackTimeSecs,
+                                        double releaseTimeSecs, int numSamplesToPreload)
+{
+    reader.reset (source);
+
+    if (reader != nullptr && reader->sampleRate > 0 && reader->lengthInSamples > 0)
+    {
+        sourceSampleRate = reader->sampleRate;
+        length = reader->lengthInSamples;
+        numChannels = jmin (2, (int) reader->numChannels);
+        headLength = (int) jmin ((int64) jmax (0, numSamplesToPreload), length);
+
+        head.setSize (numChannels, jmax (1, headLength));
+        head.clear();
+        reader->read (&head, 0, headLength, 0, true, true);
+
+        params.attack  = static_cast<float> (attackTimeSecs);
+        params.release = static_cast<float> (releaseTimeSecs);
+    }
+    else
+    {
+        reader.reset();
+        memoryMapped = false;
+    }
+}
+
+void StreamingSamplerSound::readIntoStream (AudioBuffer<float>& destination, int destStartSample,
+                                            int64 startSample, int numSamples)
+{
+    if (numSamples > 0)
+    {
+        const ScopedLock sl (readerLock);
+        reader->read (&destination, destStartSample, numSamples, startSample, true, true);
+    }
+}
+
+bool StreamingSamplerSound::appliesToNote (int midiNoteNumber)
+{
+    return midiNotes[midiNoteNumber];
+}
+
+bool StreamingSamplerSound::appliesToChannel (int /*midiChannel*/)
+{
+    return true;
+}
+
+//==============================================================================
+StreamingSamplerVoice::StreamingSamplerVoice (SampleStreamScheduler& s) : scheduler (s) {}
+
+StreamingSamplerVoice::~StreamingSamplerVoice()
+{
+    releaseStream();
+}
+
+bool StreamingSamplerVoice::canPlaySound (SynthesiserSound* sound)
+{
+    return dynamic_cast<const StreamingSamplerSound*> (sound) != nullptr;
+}
+
+void StreamingSamplerVoice::startNote (int midiNoteNumber, float velocity, SynthesiserSound* s, int /*currentPitchWheelPosition*/)
+{
+    if (auto* sound = dynamic_cast<StreamingSamplerSound*> (s))
+    {
+        releaseStream();
+
+        pitchRatio = std::pow (2.0, (midiNoteNumber - sound->midiRootNote) / 12.0)
+                        * sound->sourceSampleRate / getSampleRate();
+
+        sourceSamplePosition = 0.0;
+        lgain = velocity;
+        rgain = velocity;
+
+        // if there are no streams left, the voice will just play the preloaded part
+        if (sound->length > sound->headLength)
+        {
+            stream = scheduler.claimStream (*sound, pitchRatio);
+            streamStart = sound->headLength;
+        }
+
+        adsr.setSampleRate (sound->sourceSampleRate);
+        adsr.setParameters (sound->params);
+
+        adsr.noteOn();
+    }
+    else
+    {
+        jassertfalse; // this object can only play StreamingSamplerSounds!
+    }
+}
+
+void StreamingSamplerVoice::stopNote (float /*velocity*/, bool allowTailOff)
+{
+    if (allowTailOff)
+    {
+        adsr.noteOff();
+    }
+    else
+    {
+        clearCurrentNote();
+        adsr.reset();
+        releaseStream();
+    }
+}
+
+void StreamingSamplerVoice::releaseStream() noexcept
+{
+    if (stream != nullptr)
+    {
+        scheduler.releaseStream (stream);
+        stream = nullptr;
+    }
+}
+
+void StreamingSamplerVoice::pitchWheelMoved (int /*newValue*/) {}
+void StreamingSamplerVoice::controllerMoved (int /*controllerNumber*/, int /*newValue*/) {}
+
+//==============================================================================
+void StreamingSamplerVoice::renderNextBlock (AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    if (auto* playingSound = static_cast<StreamingSamplerSound*> (getCurrentlyPlayingSound().get()))
+    {
+        auto& head = playingSound->head;
+        const float* const headL = head.getReadPointer (0);
+        const float* const headR = head.getNumChannels() > 1 ? head.getReadPointer (1) : nullptr;
+
+        const float* ringL = nullptr;
+        const float* ringR = nullptr;
+        int ringStart = 0, ringSize = 1, numReady = 0;
+
+        if (stream != nullptr)
+        {
+            int size1, start2, size2;
+            stream->fifo.prepareToRead (stream->fifo.getNumReady(), ringStart, size1, start2, size2);
+            numReady = size1 + size2;
+            ringSize = stream->fifo.getTotalSize();
+            ringL = stream->buffer.getReadPointer (0);
+            ringR = stream->buffer.getReadPointer (1);
+        }
+
+        const auto headLength = (int64) playingSound->headLength;
+        const auto length = playingSound->length;
+        auto streamEnd = streamStart + numReady;
+
+        auto getSample = [&] (const float* headData, const float* ringData, int64 index) noexcept
+        {
+            if (index < headLength)
+                return headData[index];
+
+            if (index >= length)
+                return 0.0f;
+
+            auto ringIndex = ringStart + (int) (index - streamStart);
+            return ringData[ringIndex < ringSize ? ringIndex : ringIndex - ringSize];
+        };
+
+        float* outL = outputBuffer.getWritePointer (0, startSample);
+        float* outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getWritePointer (1, startSample) : nullptr;
+
+        while (--numSamples >= 0)
+        {
+            auto pos = (int64) sourceSamplePosition;
+            auto lastNeeded = jmin (pos + 1, length - 1);
+
+            if (lastNeeded >= headLength && lastNeeded >= streamEnd)
+            {
+                if (stream != nullptr)
+                {
+                    // the reader may have caught up since the start of the block
+                    numReady = stream->fifo.getNumReady();
+                    streamEnd = streamStart + numReady;
+                }
+
+                if (lastNeeded >= streamEnd)
+                {
+                    if (stream == nullptr)
+                    {
+                        // there was no stream for this voice, so it stops at the end of the preloaded audio
+                        stopNote (0.0f, false);
+                    }
+                    else
+                    {
+                        // the stream hasn't been filled far enough, so wait for it without moving on
+                        ++scheduler.numUnderruns;
+                    }
+
+                    break;
+                }
+            }
+
+            auto alpha = (float) (sourceSamplePosition - (double) pos);
+            auto invAlpha = 1.0f - alpha;
+
+            // just using a very simple linear interpolation here..
+            float l = (getSample (headL, ringL, pos) * invAlpha + getSample (headL, ringL, pos + 1) * alpha);
+            float r = (headR != nullptr) ? (getSample (headR, ringR, pos) * invAlpha + getSample (headR, ringR, pos + 1) * alpha)
+                                         : l;
+
+            auto envelopeValue = adsr.getNextSample();
+
+            l *= lgain * envelopeValue;
+            r *= rgain * envelopeValue;
+
+            if (outR != nullptr)
+            {
+                *outL++ += l;
+                *outR++ += r;
+            }
+            else
+            {
+                *outL++ += (l + r) * 0.5f;
+            }
+
+            sourceSamplePosition += pitchRatio;
+
+            if (sourceSamplePosition > (double) length || ! adsr.isActive())
+            {
+                stopNote (0.0f, false);
+                break;
+            }
+        }
+
+        // hand back the part of the stream that the playhead has moved past
+        if (stream != nullptr)
+        {
+            auto numFinished = (int) jlimit ((int64) 0, (int64) numReady, (int64) sourceSamplePosition - streamStart);
+            stream->fifo.finishedRead (numFinished);
+            streamStart += numFinished;
+        }
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct StreamingSamplerTests  : public UnitTest
+{
+    StreamingSamplerTests()
+        : UnitTest ("Streaming sampler", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        auto folder = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("StreamingSamplerTests", {});
+        folder.createDirectory();
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        Random random (1);
+        auto stereoFile = AudioFormatTestHelpers::writeFile (formatManager, folder.getChildFile ("stereo.wav"),
+                                                             AudioFormatTestHelpers::createTestSignal (random, 2, 60000));
+        auto monoFile   = AudioFormatTestHelpers::writeFile (formatManager, folder.getChildFile ("mono.flac"),
+                                                             AudioFormatTestHelpers::createTestSignal (random, 1, 30000));
+
+        BigInteger allNotes;
+        allNotes.setRange (0, 128, true);
+
+        beginTest ("Streaming voices play the same audio as SamplerVoices");
+        {
+            for (auto& file : { stereoFile, monoFile })
+            {
+                Synthesiser reference;
+                std::unique_ptr<AudioFormatReader> reader (formatManager.createReaderFor (file));
+                reference.addSound (new SamplerSound ("reference", *reader, allNotes, 60, 0.01, 0.1, 100.0));
+
+                SampleStreamScheduler scheduler (4, 8192, 0);
+                Synthesiser streaming;
+                auto* sound = new StreamingSamplerSound ("streaming", formatManager, file, allNotes, 60, 0.01, 0.1, 4096);
+                streaming.addSound (sound);
+
+                expect (sound->isValid());
+                expect (sound->isMemoryMapped() == file.hasFileExtension ("wav"));
+                expectEquals (sound->getNumPreloadedSamples(), 4096);
+
+                for (int i = 0; i < 2; ++i)
+                {
+                    reference.addVoice (new SamplerVoice());
+                    streaming.addVoice (new StreamingSamplerVoice (scheduler));
+                }
+
+                auto expected = render (reference, { 60, 67 }, 80000, [] {});
+                auto actual = render (streaming, { 60, 67 }, 80000, [&] { while (scheduler.fillStreams()) {} });
+
+                expect (AudioFormatTestHelpers::buffersMatch (actual, 0, expected, 0, expected.getNumSamples()));
+                expect (actual.getMagnitude (0, 20000) > 0.1f);
+                expectEquals (scheduler.getNumUnderruns(), 0);
+
+                scheduler.fillStreams();
+                expectEquals (scheduler.getNumActiveStreams(), 0);
+            }
+        }
+
+        beginTest ("A voice waits for its stream when it runs out of audio");
+        {
+            SampleStreamScheduler scheduler (1, 8192, 0);
+            Synthesiser synth;
+            synth.addSound (new StreamingSamplerSound ("streaming", formatManager, stereoFile, allNotes, 60, 0.0, 0.1, 1024));
+            auto* voice = dynamic_cast<StreamingSamplerVoice*> (synth.addVoice (new StreamingSamplerVoice (scheduler)));
+            synth.setCurrentPlaybackSampleRate (44100.0);
+
+            AudioBuffer<float> block (2, 512);
+            MidiBuffer midi;
+            midi.addEvent (MidiMessage::noteOn (1, 60, 1.0f), 0);
+
+            for (int i = 0; i < 4; ++i)
+            {
+                block.clear();
+                synth.renderNextBlock (block, midi, 0, block.getNumSamples());
+                midi.clear();
+            }
+
+            expect (scheduler.getNumUnderruns() > 0);
+            expect (voice->isStreaming());
+            expectEquals (block.getMagnitude (0, block.getNumSamples()), 0.0f);
+
+            while (scheduler.fillStreams()) {}
+
+            block.clear();
+            synth.renderNextBlock (block, midi, 0, block.getNumSamples());
+            expect (block.getMagnitude (0, block.getNumSamples()) > 0.1f);
+            expectEquals (voice->getCurrentlyPlayingNote(), 60);
+        }
+
+        beginTest ("Voices without a stream stop at the end of the preloaded audio");
+        {
+            SampleStreamScheduler scheduler (1, 8192, 0);
+            Synthesiser synth;
+            synth.addSound (new StreamingSamplerSound ("streaming", formatManager, stereoFile, allNotes, 60, 0.0, 0.1, 4096));
+
+            for (int i = 0; i < 2; ++i)
+                synth.addVoice (new StreamingSamplerVoice (scheduler));
+
+            render (synth, { 60, 62 }, 8000, [&] { while (scheduler.fillStreams()) {} });
+
+            int numStreaming = 0, numPlaying = 0;
+
+            for (int i = 0; i < synth.getNumVoices(); ++i)
+            {
+                auto* voice = dynamic_cast<StreamingSamplerVoice*> (synth.getVoice (i));
+                numStreaming += voice->isStreaming() ? 1 : 0;
+                numPlaying += voice->isVoiceActive() ? 1 : 0;
+            }
+
+            expectEquals (numStreaming, 1);
+            expectEquals (numPlaying, 1);
+            expectEquals (scheduler.getNumActiveStreams(), 1);
+        }
+
+        beginTest ("Streams are filled by the scheduler's thread");
+        {
+            Synthesiser reference;
+            std::unique_ptr<AudioFormatReader> reader (formatManager.createReaderFor (stereoFile));
+            reference.addSound (new SamplerSound ("reference", *reader, allNotes, 60, 0.01, 0.1, 100.0));
+            reference.addVoice (new SamplerVoice());
+
+            SampleStreamScheduler scheduler (4, 16384, 1);
+            Synthesiser streaming;
+            streaming.addSound (new StreamingSamplerSound ("streaming", formatManager, stereoFile, allNotes, 60, 0.01, 0.1, 8192));
+            streaming.addVoice (new StreamingSamplerVoice (scheduler));
+
+            auto expected = render (reference, { 60 }, 70000, [] {});
+            auto actual = render (streaming, { 60 }, 70000, [] { Thread::sleep (1); });
+
+            // the output can only match if the thread kept up, which can't be guaranteed on a busy machine
+            if (scheduler.getNumUnderruns() == 0)
+                expect (AudioFormatTestHelpers::buffersMatch (actual, 0, expected, 0, expected.getNumSamples()));
+            else
+                logMessage ("The scheduler's thread fell behind " + String (scheduler.getNumUnderruns()) + " times");
+
+            expect (actual.getMagnitude (0, 20000) > 0.1f);
+        }
+
+        folder.deleteRecursively();
+    }
+
+private:
+    static AudioBuffer<float> render (Synthesiser& synth, std::initializer_list<int> notes,
+                                      int numSamples, std::function<void()> beforeEachBlock)
+    {
+        const int blockSize = 512;
+        synth.setCurrentPlaybackSampleRate (48000.0);
+
+        AudioBuffer<float> output (2, numSamples);
+        output.clear();
+
+        for (int pos = 0; pos < numSamples; pos += blockSize)
+        {
+            auto numThisTime = jmin (blockSize, numSamples - pos);
+            MidiBuffer midi;
+
+            if (pos == 0)
+                for (auto note : notes)
+                    midi.addEvent (MidiMessage::noteOn (1, note, 0.5f), 0);
+
+            // release the notes part of the way through a block
+            if (pos <= 40000 && 40000 < pos + numThisTime)
+                for (auto note : notes)
+                    midi.addEvent (MidiMessage::noteOff (1, note), 40000 - pos);
+
+            beforeEachBlock();
+            synth.renderNextBlock (output, midi, pos, numThisTime);
+        }
+
+        return output;
+    }
+};
+
+static StreamingSamplerTests streamingSamplerTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,300 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+namespace juce
+{
+
+class StreamingSamplerSound;
+class StreamingSamplerVoice;
+
+//==============================================================================
+/**
+    Reads ahead from disk for all the StreamingSamplerVoice objects that share it.
+
+    Each playing voice that needs more audio than its sound keeps in memory is given
+    one of the scheduler's streams, which is a lock-free ring buffer that the
+    scheduler's threads keep topped up from the sound's file. The streams whose voices
+    will run out of audio soonest are always filled first, so a single scheduler can
+    keep hundreds of voices going.
+
+    All the memory the streams need is allocated when the scheduler is created, and
+    voices claim and release streams without locking, so starting and stopping notes
+    is safe on the audio thread.
+
+    The scheduler must outlive all the voices that use it.
+
+    @see StreamingSamplerVoice, StreamingSamplerSound
+
+    @tags{Audio}
+*/
+class JUCE_API  SampleStreamScheduler
+{
+public:
+    //==============================================================================
+    /** Creates a scheduler.
+
+        @param maxNumStreams        the number of voices that can stream at the same time
+        @param samplesPerStream     the size of each stream's ring buffer, in samples. This
+                                    needs to cover the time that it might take to read a
+                                    chunk from the disk, multiplied by the fastest rate that
+                                    voices will play at
+        @param numThreads           the number of threads to read with. If this is 0, no
+                                    threads are started, and you'll need to call fillStreams()
+                                    yourself
+    */
+    SampleStreamScheduler (int maxNumStreams = 256,
+                           int samplesPerStream = 32768,
+                           int numThreads = 1);
+
+    /** Destructor. */
+    ~SampleStreamScheduler();
+
+    //==============================================================================
+    /** Reads the next chunk for each stream that has room for one, most urgent first,
+        and recycles any streams that voices have finished with.
+
+        This is called repeatedly by the scheduler's threads, but if you created it with no
+        threads you can call it yourself, as long as you only call it from one thread at a
+        time. Returns true if it read anything.
+    */
+    bool fillStreams();
+
+    /** Returns the number of streams that are currently in use. */
+    int getNumActiveStreams() const noexcept;
+
+    /** Returns the number of times that a voice has run out of audio to play. */
+    int getNumUnderruns() const noexcept        { return numUnderruns.load(); }
+
+    /** Sets the size of the chunks that are read from disk, in samples. */
+    void setReadChunkSize (int numSamples) noexcept     { readChunkSize = jmax (1, numSamples); }
+
+private:
+    //==============================================================================
+    friend class StreamingSamplerVoice;
+
+    enum StreamState
+    {
+        streamFree,         // available to be claimed by a voice
+        streamClaimed,      // being set up by a voice
+        streamPlaying,      // being filled by the scheduler and read by a voice
+        streamReleased      // finished with, and waiting to be recycled by the scheduler
+    };
+
+    struct Stream
+    {
+        explicit Stream (int numSamples) : fifo (numSamples), buffer (2, numSamples) {}
+
+        std::atomic<int> state { streamFree };
+        std::atomic<bool> isBeingFilled { false };
+        std::atomic<float> playbackRate { 1.0f };
+
+        ReferenceCountedObjectPtr<StreamingSamplerSound> sound;
+        AbstractFifo fifo;
+        AudioBuffer<float> buffer;
+        int64 nextReadPosition = 0;
+    };
+
+    // The streams that are playing, with the time their voices have left, so that
+    // each caller of fillStreams() can sort them without allocating
+    using StreamQueue = Array<std::pair<double, Stream*>>;
+
+    Stream* claimStream (StreamingSamplerSound&, double playbackRate) noexcept;
+    void releaseStream (Stream*) noexcept;
+    bool fillStreams (StreamQueue&);
+    bool fillStream (Stream&);
+    void recycleStream (Stream&);
+
+    class ReaderThread;
+
+    OwnedArray<Stream> streams;
+    OwnedArray<ReaderThread> threads;
+    StreamQueue streamsToFill;
+    std::atomic<int> numUnderruns { 0 };
+    std::atomic<int> readChunkSize { 4096 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SampleStreamScheduler)
+};
+
+//==============================================================================
+/**
+    A SynthesiserSound that plays a sample straight from disk.
+
+    The start of the sample is loaded into memory, so that voices can start playing
+    it immediately, and the rest is streamed by a SampleStreamScheduler as it's needed.
+    Where the file's format allows it, the file is memory-mapped.
+
+    @see StreamingSamplerVoice, SampleStreamScheduler, SamplerSound
+
+    @tags{Audio}
+*/
+class JUCE_API  StreamingSamplerSound    : public SynthesiserSound
+{
+public:
+    //==============================================================================
+    /** Creates a sound that streams from a file.
+
+        @param name                 a name for the sample
+        @param formatManager        the formats to try opening the file with
+        @param file                 the audio file to play
+        @param midiNotes            the set of midi keys that this sound should be played on
+        @param midiNoteForNormalPitch   the midi note at which the sample should be played
+                                        with its natural rate
+        @param attackTimeSecs       the attack (fade-in) time, in seconds
+        @param releaseTimeSecs      the decay (fade-out) time, in seconds
+        @param numSamplesToPreload  the number of samples at the start of the file to keep
+                                    in memory. This must cover the time it takes to start
+                                    streaming a voice, at the fastest rate it will be played
+    */
+    StreamingSamplerSound (const String& name,
+                           AudioFormatManager& formatManager,
+                           const File& file,
+                           const BigInteger& midiNotes,
+                           int midiNoteForNormalPitch,
+                           double attackTimeSecs,
+                           double releaseTimeSecs,
+                           int numSamplesToPreload = 32768);
+
+    /** Creates a sound that streams from an AudioFormatReader, which it will delete when
+        it's no longer needed.
+    */
+    StreamingSamplerSound (const String& name,
+                           AudioFormatReader* source,
+                           const BigInteger& midiNotes,
+                           int midiNoteForNormalPitch,
+                           double attackTimeSecs,
+                           double releaseTimeSecs,
+                           int numSamplesToPreload = 32768);
+
+    /** Destructor. */
+    ~StreamingSamplerSound() override;
+
+    //==============================================================================
+    /** Returns the sample's name */
+    const String& getName() const noexcept                  { return name; }
+
+    /** Returns true if the file could be opened. */
+    bool isValid() const noexcept                           { return reader != nullptr; }
+
+    /** Returns the length of the sample, in samples. */
+    int64 getLengthInSamples() const noexcept               { return length; }
+
+    /** Returns the number of samples that are kept in memory. */
+    int getNumPreloadedSamples() const noexcept             { return headLength; }
+
+    /** Returns true if the file is being read through a MemoryMappedAudioFormatReader. */
+    bool isMemoryMapped() const noexcept                    { return memoryMapped; }
+
+    /** Changes the parameters of the ADSR envelope which will be applied to the sample. */
+    void setEnvelopeParameters (ADSR::Parameters parametersToUse)    { params = parametersToUse; }
+
+    //==============================================================================
+    bool appliesToNote (int midiNoteNumber) override;
+    bool appliesToChannel (int midiChannel) override;
+
+    /** A convenient typedef for a pointer to a StreamingSamplerSound. */
+    using Ptr = ReferenceCountedObjectPtr<StreamingSamplerSound>;
+
+private:
+    //==============================================================================
+    friend class StreamingSamplerVoice;
+    friend class SampleStreamScheduler;
+
+    void initialise (AudioFormatReader*, double attackTimeSecs, double releaseTimeSecs, int numSamplesToPreload);
+    void readIntoStream (AudioBuffer<float>& destination, int destStartSample, int64 startSample, int numSamples);
+
+    String name;
+    std::unique_ptr<AudioFormatReader> reader;
+    CriticalSection readerLock;
+    AudioBuffer<float> head;
+    double sourceSampleRate = 0;
+    BigInteger midiNotes;
+    int64 length = 0;
+    int headLength = 0, numChannels = 0, midiRootNote = 0;
+    bool memoryMapped = false;
+
+    ADSR::Parameters params;
+
+    JUCE_LEAK_DETECTOR (StreamingSamplerSound)
+};
+
+//==============================================================================
+/**
+    A SynthesiserVoice that plays a StreamingSamplerSound.
+
+    This plays a sound in the same way as a SamplerVoice, taking the start of the
+    sample from memory, and the rest from a stream that it claims from a
+    SampleStreamScheduler. If the scheduler has no streams left, the voice stops at
+    the end of the preloaded audio. If the stream hasn't been read far enough, the
+    voice waits for it, and the scheduler counts an underrun. The voice checks the
+    stream again when it runs out of audio, so a stream that catches up during a block
+    is picked up straight away, but once the voice has had to wait, the rest of that
+    block is silent and playback resumes from the same position in the next block.
+
+    @see StreamingSamplerSound, SampleStreamScheduler, SamplerVoice
+
+    @tags{Audio}
+*/
+class JUCE_API  StreamingSamplerVoice    : public SynthesiserVoice
+{
+public:
+    //==============================================================================
+    /** Creates a voice that streams using the given scheduler, which must outlive it. */
+    explicit StreamingSamplerVoice (SampleStreamScheduler& scheduler);
+
+    /** Destructor. */
+    ~StreamingSamplerVoice() override;
+
+    //==============================================================================
+    bool canPlaySound (SynthesiserSound*) override;
+
+    void startNote (int midiNoteNumber, float velocity, SynthesiserSound*, int pitchWheel) override;
+    void stopNote (float velocity, bool allowTailOff) override;
+
+    void pitchWheelMoved (int newValue) override;
+    void controllerMoved (int controllerNumber, int newValue) override;
+
+    void renderNextBlock (AudioBuffer<float>&, int startSample, int numSamples) override;
+    using SynthesiserVoice::renderNextBlock;
+
+    /** Returns true if the voice currently has a stream from the scheduler. */
+    bool isStreaming() const noexcept       { return stream != nullptr; }
+
+private:
+    //==============================================================================
+    void releaseStream() noexcept;
+
+    SampleStreamScheduler& scheduler;
+    SampleStreamScheduler::Stream* stream = nullptr;
+    int64 streamStart = 0;
+
+    double pitchRatio = 0;
+    double sourceSamplePosition = 0;
+    float lgain = 0, rgain = 0;
+
+    ADSR adsr;
+
+    JUCE_LEAK_DETECTOR (StreamingSamplerVoice)
+};
+
+} // namespace juce
@@ -2654,6 +2654,7 @@ public:
 
                         if (auto* param = comPluginInstance->getParamForVSTParamID (vstParamID))
                         {
+                            addParameterChangesToAutomation (*param, *paramQueue);
                             param->setValue (floatValue);
 
                             inParameterChangedCallback = true;
@@ -2665,6 +2666,26 @@ public:
         }
     }
 
+    void addParameterChangesToAutomation (AudioProcessorParameter& param, Vst::IParamValueQueue& paramQueue)
+    {
+        auto parameterIndex = param.getParameterIndex();
+
+        if (parameterIndex < 0)
+            return;
+
+        // The parameter still holds its value from the end of the previous block, which is where the ramp starts
+        auto startValue = param.getValue();
+
+        for (Steinberg::int32 i = 0; i < paramQueue.getPointCount(); ++i)
+        {
+            Steinberg::int32 offsetSamples = 0;
+            double value = 0.0;
+
+            if (paramQueue.getPoint (i, offsetSamples, value) == kResultTrue)
+                parameterAutomation.addPoint (parameterIndex, startValue, (int) offsetSamples, static_cast<float> (value));
+        }
+    }
+
     void addParameterChangeToMidiBuffer (const Steinberg::int32 offsetSamples, const Vst::ParamID id, const double value)
     {
         // If the parameter is mapped to a MIDI CC message then insert it into the midiBuffer.
@@ -2709,6 +2730,7 @@ public:
         }
 
         midiBuffer.clear();
+        parameterAutomation.clear();
 
         if (data.inputParameterChanges != nullptr)
             processParameterChanges (*data.inputParameterChanges);
@@ -2907,10 +2929,14 @@ private:
                 if (totalInputChans == pluginInstance->getTotalNumInputChannels()
                  && totalOutputChans == pluginInstance->getTotalNumOutputChannels())
                 {
+                    pluginInstance->setParameterAutomation (parameterAutomation.isEmpty() ? nullptr : &parameterAutomation);
+
                     if (isBypassed())
                         pluginInstance->processBlockBypassed (buffer, midiBuffer);
                     else
                         pluginInstance->processBlock (buffer, midiBuffer);
+
+                    pluginInstance->setParameterAutomation (nullptr);
                 }
             }
 
@@ -2982,6 +3008,9 @@ private:
 
         midiBuffer.ensureSize (2048);
         midiBuffer.clear();
+
+        parameterAutomation.ensureSize (2048);
+        parameterAutomation.clear();
     }
 
     //==============================================================================
@@ -3003,6 +3032,7 @@ private:
     Vst::ProcessSetup processSetup;
 
     MidiBuffer midiBuffer;
+    ParameterAutomationBuffer parameterAutomation;
     Array<float*> channelListFloat;
     Array<double*> channelListDouble;
 
@@ -243,6 +243,7 @@ struct AutoResizingNSViewComponentWithParent  : public AutoResizingNSViewCompone
 #include "scanning/juce_PluginDirectoryScanner.cpp"
 #include "scanning/juce_PluginListComponent.cpp"
 #include "processors/juce_AudioProcessorParameterGroup.cpp"
+#include "processors/juce_ParameterAutomationBuffer.cpp"
 #include "utilities/juce_AudioProcessorParameterWithID.cpp"
 #include "utilities/juce_RangedAudioParameter.cpp"
 #include "utilities/juce_AudioParameterFloat.cpp"
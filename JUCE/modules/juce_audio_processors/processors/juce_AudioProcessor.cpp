@@ -910,6 +910,39 @@ std::unique_ptr<XmlElement> AudioProcessor::getXmlFromBinary (const void* data,
     return {};
 }
 
+// magic number and format version for memory blocks that we've stored as a ValueTree
+const uint32 magicValueTreeNumber = 0x21324357;
+const int valueTreeBinaryVersion = 1;
+
+void AudioProcessor::copyValueTreeToBinary (const ValueTree& tree, juce::MemoryBlock& destData)
+{
+    MemoryOutputStream out (destData, false);
+    out.writeInt ((int) magicValueTreeNumber);
+    out.writeInt (valueTreeBinaryVersion);
+    tree.writeToStream (out);
+}
+
+ValueTree AudioProcessor::getValueTreeFromBinary (const void* data, const int sizeInBytes)
+{
+    if (sizeInBytes > 8 && ByteOrder::littleEndianInt (data) == magicValueTreeNumber)
+    {
+        // This data was written by a newer version of this function
+        if ((int) ByteOrder::littleEndianInt (addBytesToPointer (data, 4)) > valueTreeBinaryVersion)
+        {
+            jassertfalse;
+            return {};
+        }
+
+        MemoryInputStream in (addBytesToPointer (data, 8), (size_t) sizeInBytes - 8, false);
+        return ValueTree::readFromStream (in);
+    }
+
+    if (auto xml = getXmlFromBinary (data, sizeInBytes))
+        return ValueTree::fromXml (*xml);
+
+    return {};
+}
+
 bool AudioProcessor::canApplyBusCountChange (bool isInput, bool isAdding,
                                              AudioProcessor::BusProperties& outProperties)
 {
@@ -711,6 +711,22 @@ public:
     */
     AudioPlayHead* getPlayHead() const noexcept                 { return playHead; }
 
+    /** Returns the sample-accurate automation for the block currently being processed.
+
+        Like getPlayHead(), you can ONLY call this from your processBlock() method,
+        and mustn't keep the pointer after it returns.
+
+        Hosts that know exactly where in the block a parameter changes will fill
+        this in, so that you can render smooth per-sample curves with
+        ParameterAutomationBuffer::getValues(). The parameter objects themselves
+        still get set to their values at the end of the block before processBlock()
+        is called, so processors that ignore this will carry on working as before.
+
+        If the host has no sample-accurate automation for this block, this will
+        return nullptr.
+    */
+    const ParameterAutomationBuffer* getParameterAutomation() const noexcept   { return parameterAutomation; }
+
     //==============================================================================
     /** Returns the total number of input channels.
 
@@ -1132,6 +1148,17 @@ public:
     */
     virtual void setPlayHead (AudioPlayHead* newPlayHead);
 
+    /** Tells the processor about the sample-accurate automation for the next call to
+        processBlock().
+
+        This is intended for hosts, which should call it on the audio thread just before
+        processBlock() and set it back to nullptr afterwards. The processor doesn't take
+        ownership of the buffer.
+
+        @see getParameterAutomation
+    */
+    void setParameterAutomation (const ParameterAutomationBuffer* newAutomation) noexcept   { parameterAutomation = newAutomation; }
+
     //==============================================================================
     /** This is called by the processor to specify its details before being played. Use this
         version of the function if you are not interested in any sidechain and/or aux buses
@@ -1258,6 +1285,24 @@ public:
     */
     static std::unique_ptr<XmlElement> getXmlFromBinary (const void* data, int sizeInBytes);
 
+    /** Helper function that stores a ValueTree as a binary blob.
+
+        This uses ValueTree::writeToStream(), which is much smaller and quicker to read
+        back than the XML that copyXmlToBinary() creates, so it's a better choice for
+        large states that the host may save often.
+
+        Use getValueTreeFromBinary() to reverse this operation.
+    */
+    static void copyValueTreeToBinary (const ValueTree& tree, juce::MemoryBlock& destData);
+
+    /** Retrieves a ValueTree that was stored with copyValueTreeToBinary().
+
+        This will also load data that was stored as XML with copyXmlToBinary(), so that
+        existing states can still be read after switching to the binary format.
+        It returns an invalid tree if the data's unsuitable or corrupted.
+    */
+    static ValueTree getValueTreeFromBinary (const void* data, int sizeInBytes);
+
     /** @internal */
     static void JUCE_CALLTYPE setTypeOfNextNewPlugin (WrapperType);
 
@@ -1470,6 +1515,7 @@ private:
     bool suspended = false;
     std::atomic<bool> nonRealtime { false };
     ProcessingPrecision processingPrecision = singlePrecision;
+    const ParameterAutomationBuffer* parameterAutomation = nullptr;
     CriticalSection callbackLock, listenerLock, activeEditorLock;
 
     friend class Bus;
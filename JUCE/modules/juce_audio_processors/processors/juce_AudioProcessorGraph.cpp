@@ -45,9 +45,11 @@ struct GraphRenderSequence
         MidiBuffer* midiBuffers;
         AudioPlayHead* audioPlayHead;
         int numSamples;
+        int chunkStartSample, numSamplesInBlock;
     };
 
-    void perform (AudioBuffer<FloatType>& buffer, MidiBuffer& midiMessages, AudioPlayHead* audioPlayHead)
+    void perform (AudioBuffer<FloatType>& buffer, MidiBuffer& midiMessages, AudioPlayHead* audioPlayHead,
+                  AudioWorkerPool* workerPool = nullptr)
     {
         auto numSamples = buffer.getNumSamples();
         auto maxSamples = renderingBuffer.getNumSamples();
@@ -64,7 +66,7 @@ struct GraphRenderSequence
                 midiChunk.clear();
                 midiChunk.addEvents (midiMessages, chunkStartSample, chunkSize, -chunkStartSample);
 
-                perform (audioChunk, midiChunk, audioPlayHead);
+                performChunk (audioChunk, midiChunk, audioPlayHead, workerPool, chunkStartSample, numSamples);
 
                 chunkStartSample += maxSamples;
             }
@@ -72,6 +74,14 @@ struct GraphRenderSequence
             return;
         }
 
+        performChunk (buffer, midiMessages, audioPlayHead, workerPool, 0, numSamples);
+    }
+
+    void performChunk (AudioBuffer<FloatType>& buffer, MidiBuffer& midiMessages, AudioPlayHead* audioPlayHead,
+                       AudioWorkerPool* workerPool, int chunkStartSample, int numSamplesInBlock)
+    {
+        auto numSamples = buffer.getNumSamples();
+
         currentAudioInputBuffer = &buffer;
         currentAudioOutputBuffer.setSize (jmax (1, buffer.getNumChannels()), numSamples);
         currentAudioOutputBuffer.clear();
@@ -79,10 +89,14 @@ struct GraphRenderSequence
         currentMidiOutputBuffer.clear();
 
         {
-            const Context context { renderingBuffer.getArrayOfWritePointers(), midiBuffers.begin(), audioPlayHead, numSamples };
+            const Context context { renderingBuffer.getArrayOfWritePointers(), midiBuffers.begin(), audioPlayHead,
+                                    numSamples, chunkStartSample, numSamplesInBlock };
 
-            for (auto* op : renderOps)
-                op->perform (context);
+            if (workerPool != nullptr && tasks.size() > 1)
+                performInParallel (context, *workerPool);
+            else
+                for (auto* op : renderOps)
+                    op->perform (context);
         }
 
         for (int i = 0; i < buffer.getNumChannels(); ++i)
@@ -95,48 +109,165 @@ struct GraphRenderSequence
 
     void addClearChannelOp (int index)
     {
-        createOp ([=] (const Context& c)    { FloatVectorOperations::clear (c.audioBuffers[index], c.numSamples); });
+        createOp ([=] (const Context& c)    { FloatVectorOperations::clear (c.audioBuffers[index], c.numSamples); })
+            .buffersWritten.add (audioBufferID (index));
     }
 
     void addCopyChannelOp (int srcIndex, int dstIndex)
     {
-        createOp ([=] (const Context& c)    { FloatVectorOperations::copy (c.audioBuffers[dstIndex],
-                                                                           c.audioBuffers[srcIndex],
-                                                                           c.numSamples); });
+        auto& op = createOp ([=] (const Context& c)    { FloatVectorOperations::copy (c.audioBuffers[dstIndex],
+                                                                                      c.audioBuffers[srcIndex],
+                                                                                      c.numSamples); });
+        op.buffersRead.add (audioBufferID (srcIndex));
+        op.buffersWritten.add (audioBufferID (dstIndex));
     }
 
     void addAddChannelOp (int srcIndex, int dstIndex)
     {
-        createOp ([=] (const Context& c)    { FloatVectorOperations::add (c.audioBuffers[dstIndex],
-                                                                          c.audioBuffers[srcIndex],
-                                                                          c.numSamples); });
+        auto& op = createOp ([=] (const Context& c)    { FloatVectorOperations::add (c.audioBuffers[dstIndex],
+                                                                                     c.audioBuffers[srcIndex],
+                                                                                     c.numSamples); });
+        op.buffersRead.add (audioBufferID (srcIndex));
+        op.buffersWritten.add (audioBufferID (dstIndex));
     }
 
     void addClearMidiBufferOp (int index)
     {
-        createOp ([=] (const Context& c)    { c.midiBuffers[index].clear(); });
+        createOp ([=] (const Context& c)    { c.midiBuffers[index].clear(); })
+            .buffersWritten.add (midiBufferID (index));
     }
 
     void addCopyMidiBufferOp (int srcIndex, int dstIndex)
     {
-        createOp ([=] (const Context& c)    { c.midiBuffers[dstIndex] = c.midiBuffers[srcIndex]; });
+        auto& op = createOp ([=] (const Context& c)    { c.midiBuffers[dstIndex] = c.midiBuffers[srcIndex]; });
+        op.buffersRead.add (midiBufferID (srcIndex));
+        op.buffersWritten.add (midiBufferID (dstIndex));
     }
 
     void addAddMidiBufferOp (int srcIndex, int dstIndex)
     {
-        createOp ([=] (const Context& c)    { c.midiBuffers[dstIndex].addEvents (c.midiBuffers[srcIndex],
-                                                                                 0, c.numSamples, 0); });
+        auto& op = createOp ([=] (const Context& c)    { c.midiBuffers[dstIndex].addEvents (c.midiBuffers[srcIndex],
+                                                                                            0, c.numSamples, 0); });
+        op.buffersRead.add (midiBufferID (srcIndex));
+        op.buffersWritten.add (midiBufferID (dstIndex));
     }
 
     void addDelayChannelOp (int chan, int delaySize)
     {
-        renderOps.add (new DelayChannelOp (chan, delaySize));
+        renderOps.add (new DelayChannelOp (chan, delaySize))->buffersWritten.add (audioBufferID (chan));
     }
 
     void addProcessOp (const AudioProcessorGraph::Node::Ptr& node,
                        const Array<int>& audioChannelsUsed, int totalNumChans, int midiBuffer)
     {
-        renderOps.add (new ProcessOp (node, audioChannelsUsed, totalNumChans, midiBuffer));
+        auto* op = renderOps.add (new ProcessOp (node, audioChannelsUsed, totalNumChans, midiBuffer));
+        op->endsTask = true;
+
+        for (auto index : audioChannelsUsed)
+            op->buffersWritten.addIfNotAlreadyThere (audioBufferID (index));
+
+        op->buffersWritten.add (midiBufferID (midiBuffer));
+
+        // The graph's output nodes all add to the same buffers
+        if (auto* ioProc = dynamic_cast<AudioProcessorGraph::AudioGraphIOProcessor*> (node->getProcessor()))
+        {
+            if (ioProc->getType() == AudioProcessorGraph::AudioGraphIOProcessor::audioOutputNode)
+                op->buffersWritten.add (graphAudioOutputID);
+            else if (ioProc->getType() == AudioProcessorGraph::AudioGraphIOProcessor::midiOutputNode)
+                op->buffersWritten.add (graphMidiOutputID);
+        }
+    }
+
+    // Makes the ops added since the last processor into a task of their own
+    void endTask()
+    {
+        if (! renderOps.isEmpty())
+            renderOps.getLast()->endsTask = true;
+    }
+
+    //==============================================================================
+    /** Splits the ops into tasks, each one ending with a processor and starting with
+        the ops which fetch its inputs, and finds which tasks have to wait for others
+        because they use the same buffers.
+    */
+    void createParallelSchedule()
+    {
+        tasks.clear();
+        successors.clear();
+
+        for (int i = 0, firstOp = 0; i < renderOps.size(); ++i)
+        {
+            if (renderOps.getUnchecked (i)->endsTask || i == renderOps.size() - 1)
+            {
+                tasks.push_back ({ firstOp, i + 1, 0, 0, 0 });
+                firstOp = i + 1;
+            }
+        }
+
+        struct BufferUsers
+        {
+            int lastWriter = -1;
+            Array<int> readersSinceLastWrite;
+        };
+
+        std::map<int, BufferUsers> bufferUsers;
+        std::vector<Array<int>> taskSuccessors (tasks.size());
+
+        for (int taskIndex = 0; taskIndex < (int) tasks.size(); ++taskIndex)
+        {
+            SortedSet<int> predecessors;
+
+            auto addPredecessor = [&] (int other)
+            {
+                if (other >= 0 && other != taskIndex)
+                    predecessors.add (other);
+            };
+
+            for (int i = tasks[(size_t) taskIndex].firstOp; i < tasks[(size_t) taskIndex].endOp; ++i)
+            {
+                auto& op = *renderOps.getUnchecked (i);
+
+                for (auto id : op.buffersRead)
+                {
+                    if (isReadOnlyEmptyBuffer (id))
+                        continue;
+
+                    auto& users = bufferUsers[id];
+                    addPredecessor (users.lastWriter);
+                    users.readersSinceLastWrite.addIfNotAlreadyThere (taskIndex);
+                }
+
+                for (auto id : op.buffersWritten)
+                {
+                    if (isReadOnlyEmptyBuffer (id))
+                        continue;
+
+                    auto& users = bufferUsers[id];
+                    addPredecessor (users.lastWriter);
+
+                    for (auto reader : users.readersSinceLastWrite)
+                        addPredecessor (reader);
+
+                    users.readersSinceLastWrite.clearQuick();
+                    users.lastWriter = taskIndex;
+                }
+            }
+
+            for (auto predecessor : predecessors)
+                taskSuccessors[(size_t) predecessor].add (taskIndex);
+
+            tasks[(size_t) taskIndex].numPredecessors = predecessors.size();
+        }
+
+        for (size_t i = 0; i < tasks.size(); ++i)
+        {
+            tasks[i].firstSuccessor = (int) successors.size();
+            tasks[i].numSuccessors = taskSuccessors[i].size();
+            successors.insert (successors.end(), taskSuccessors[i].begin(), taskSuccessors[i].end());
+        }
+
+        numPendingPredecessors.reset (new std::atomic<int>[tasks.size()]);
+        readyTasks.reset (new std::atomic<int>[tasks.size()]);
     }
 
     void prepareBuffers (int blockSize)
@@ -190,6 +321,10 @@ private:
         virtual ~RenderingOp() {}
         virtual void perform (const Context&) = 0;
 
+        // The buffers used by the op, which tell which ops can run at the same time
+        Array<int> buffersRead, buffersWritten;
+        bool endsTask = false;
+
         JUCE_LEAK_DETECTOR (RenderingOp)
     };
 
@@ -197,7 +332,7 @@ private:
 
     //==============================================================================
     template <typename LambdaType>
-    void createOp (LambdaType&& fn)
+    RenderingOp& createOp (LambdaType&& fn)
     {
         struct LambdaOp  : public RenderingOp
         {
@@ -207,7 +342,116 @@ private:
             LambdaType function;
         };
 
-        renderOps.add (new LambdaOp (std::move (fn)));
+        return *renderOps.add (new LambdaOp (std::move (fn)));
+    }
+
+    //==============================================================================
+    // The audio and midi buffers are given IDs in the same space, with the index 0 of
+    // each type being the read-only empty buffer
+    static int audioBufferID (int index) noexcept           { return 2 * index; }
+    static int midiBufferID (int index) noexcept            { return 2 * index + 1; }
+    static bool isReadOnlyEmptyBuffer (int id) noexcept     { return id == 0 || id == 1; }
+
+    enum { graphAudioOutputID = -1, graphMidiOutputID = -2 };
+
+    struct Task
+    {
+        int firstOp, endOp;
+        int numPredecessors, firstSuccessor, numSuccessors;
+    };
+
+    std::vector<Task> tasks;
+    std::vector<int> successors;
+
+    std::unique_ptr<std::atomic<int>[]> numPendingPredecessors, readyTasks;
+    std::atomic<int> numTasksRemaining { 0 }, numReadyTasksPushed { 0 }, numReadyTasksPopped { 0 };
+
+    //==============================================================================
+    void performInParallel (const Context& context, AudioWorkerPool& workerPool) noexcept
+    {
+        const auto numTasks = (int) tasks.size();
+
+        numTasksRemaining = numTasks;
+        numReadyTasksPushed = 0;
+        numReadyTasksPopped = 0;
+
+        for (int i = 0; i < numTasks; ++i)
+        {
+            numPendingPredecessors[(size_t) i] = tasks[(size_t) i].numPredecessors;
+            readyTasks[(size_t) i] = -1;
+        }
+
+        for (int i = 0; i < numTasks; ++i)
+            if (tasks[(size_t) i].numPredecessors == 0)
+                pushReadyTask (i);
+
+        // Every thread keeps running tasks until they have all finished, so runJobs()
+        // also acts as the barrier at the end of the block
+        workerPool.runJobs (workerPool.getNumWorkerThreads() + 1, [this, &context] (int) { runTasks (context); });
+    }
+
+    void runTasks (const Context& context) noexcept
+    {
+        for (int failedAttempts = 0; numTasksRemaining.load() > 0;)
+        {
+            auto taskIndex = popReadyTask();
+
+            if (taskIndex < 0)
+            {
+                if (++failedAttempts > 20)
+                    Thread::yield();
+
+                continue;
+            }
+
+            failedAttempts = 0;
+
+            // A thread carries on with one of the tasks it made ready, as its inputs
+            // are still in the cache, and leaves the others to the rest of the threads
+            while (taskIndex >= 0)
+            {
+                auto& task = tasks[(size_t) taskIndex];
+
+                for (int i = task.firstOp; i < task.endOp; ++i)
+                    renderOps.getUnchecked (i)->perform (context);
+
+                taskIndex = -1;
+
+                for (int i = task.firstSuccessor; i < task.firstSuccessor + task.numSuccessors; ++i)
+                {
+                    auto successor = successors[(size_t) i];
+
+                    if (--numPendingPredecessors[(size_t) successor] == 0)
+                    {
+                        if (taskIndex < 0)
+                            taskIndex = successor;
+                        else
+                            pushReadyTask (successor);
+                    }
+                }
+
+                --numTasksRemaining;
+            }
+        }
+    }
+
+    void pushReadyTask (int taskIndex) noexcept
+    {
+        readyTasks[(size_t) numReadyTasksPushed++] = taskIndex;
+    }
+
+    int popReadyTask() noexcept
+    {
+        auto index = numReadyTasksPopped.load();
+
+        // A slot may have been claimed by a push which hasn't stored its task yet
+        if (index >= numReadyTasksPushed.load() || readyTasks[(size_t) index].load() < 0)
+            return -1;
+
+        if (! numReadyTasksPopped.compare_exchange_weak (index, index + 1))
+            return -1;
+
+        return readyTasks[(size_t) index].load();
     }
 
     //==============================================================================
@@ -264,6 +508,23 @@ private:
         {
             processor.setPlayHead (c.audioPlayHead);
 
+            auto& automation = node->parameterAutomation;
+            auto isAutomated = ! automation.isEmpty();
+
+            if (isAutomated)
+            {
+                if (c.numSamples == c.numSamplesInBlock)
+                {
+                    processor.setParameterAutomation (&automation);
+                }
+                else
+                {
+                    auto& chunk = node->parameterAutomationChunk;
+                    chunk.copyBlockFrom (automation, c.chunkStartSample, c.numSamples);
+                    processor.setParameterAutomation (&chunk);
+                }
+            }
+
             for (int i = 0; i < totalChans; ++i)
                 audioChannels[i] = c.audioBuffers[audioChannelsToUse.getUnchecked (i)];
 
@@ -273,6 +534,15 @@ private:
                 buffer.clear();
             else
                 callProcess (buffer, c.midiBuffers[midiBufferToUse]);
+
+            if (isAutomated)
+            {
+                processor.setParameterAutomation (nullptr);
+
+                // the points belong to the block, so they're finished with once its last chunk is done
+                if (c.chunkStartSample + c.numSamples >= c.numSamplesInBlock)
+                    automation.clear();
+            }
         }
 
         void callProcess (AudioBuffer<float>& buffer, MidiBuffer& midiMessages)
@@ -337,9 +607,12 @@ template <typename RenderSequence>
 struct RenderSequenceBuilder
 {
     RenderSequenceBuilder (AudioProcessorGraph& g, RenderSequence& s)
-        : graph (g), sequence (s)
+        : graph (g), sequence (s), reuseOldestFreeBuffers (g.isParallelRenderingEnabled())
     {
-        createOrderedNodeList();
+        auto& graphOrder = g.getOrderedNodes();
+        findNodeDelays (graphOrder);
+        orderedNodes = chooseRenderingOrder (graphOrder);
+        findConsumersOfOutputs();
 
         audioBuffers.add (AssignedBuffer::createReadOnlyEmpty()); // first buffer is read-only zeros
         midiBuffers .add (AssignedBuffer::createReadOnlyEmpty());
@@ -347,55 +620,92 @@ struct RenderSequenceBuilder
         for (int i = 0; i < orderedNodes.size(); ++i)
         {
             createRenderingOpsForNode (*orderedNodes.getUnchecked(i), i);
+            createMixingOpsForOutputs (*orderedNodes.getUnchecked(i), i);
             markAnyUnusedBuffersAsFree (audioBuffers, i);
             markAnyUnusedBuffersAsFree (midiBuffers, i);
         }
 
         graph.setLatencySamples (totalLatency);
 
+        graph.bufferStatistics.numAudioBuffers = audioBuffers.size() - 1;
+        graph.bufferStatistics.numMidiBuffers = midiBuffers.size() - 1;
+        graph.bufferStatistics.numAudioBuffersWithoutReuse = numAudioBuffersAllocated;
+
         s.numBuffersNeeded = audioBuffers.size();
         s.numMidiBuffersNeeded = midiBuffers.size();
+        s.createParallelSchedule();
     }
 
     //==============================================================================
     using NodeID = AudioProcessorGraph::NodeID;
+    using Node = AudioProcessorGraph::Node;
 
     AudioProcessorGraph& graph;
     RenderSequence& sequence;
 
-    Array<AudioProcessorGraph::Node*> orderedNodes;
+    Array<Node*> orderedNodes;
+    std::vector<int> renderingIndexes; // for each node's index in the graph's order
+
+    // For each output channel, the rendering steps and input channels which use it,
+    // sorted by step
+    struct Consumer
+    {
+        int step, inputChannel;
+    };
+
+    std::map<uint64, Array<Consumer>> consumers;
+
+    // For each output channel, the inputs with several sources which it gets mixed into
+    // as soon as it has been rendered, sorted by the step of the node they belong to
+    struct MixedInput
+    {
+        Node* node;
+        int inputChannel;
+    };
+
+    std::map<uint64, Array<MixedInput>> mixedInputs;
+    std::map<uint64, int> mixBuffers;
+
+    static uint64 getKey (AudioProcessorGraph::NodeAndChannel output) noexcept
+    {
+        return ((uint64) output.nodeID.uid << 32) | (uint32) output.channelIndex;
+    }
 
     struct AssignedBuffer
     {
         AudioProcessorGraph::NodeAndChannel channel;
+        int timeFreed = 0;
 
         static AssignedBuffer createReadOnlyEmpty() noexcept    { return { { zeroNodeID(), 0 } }; }
         static AssignedBuffer createFree() noexcept             { return { { freeNodeID(), 0 } }; }
 
         bool isReadOnlyEmpty() const noexcept                   { return channel.nodeID == zeroNodeID(); }
         bool isFree() const noexcept                            { return channel.nodeID == freeNodeID(); }
-        bool isAssigned() const noexcept                        { return ! (isReadOnlyEmpty() || isFree()); }
+        bool isMixing() const noexcept                          { return channel.nodeID == mixNodeID(); }
+        bool isAssigned() const noexcept                        { return ! (isReadOnlyEmpty() || isFree() || isMixing()); }
 
-        void setFree() noexcept                                 { channel = { freeNodeID(), 0 }; }
+        void setFree (int time) noexcept                        { channel = { freeNodeID(), 0 }; timeFreed = time; }
         void setAssignedToNonExistentNode() noexcept            { channel = { anonNodeID(), 0 }; }
+        void setMixing() noexcept                               { channel = { mixNodeID(), 0 }; }
 
     private:
+        static NodeID mixNodeID()  { return NodeID (0x7ffffffc); }
         static NodeID anonNodeID() { return NodeID (0x7ffffffd); }
         static NodeID zeroNodeID() { return NodeID (0x7ffffffe); }
         static NodeID freeNodeID() { return NodeID (0x7fffffff); }
     };
 
     Array<AssignedBuffer> audioBuffers, midiBuffers;
+    int numBuffersFreed = 0, numAudioBuffersAllocated = 0;
 
-    enum { readOnlyEmptyBufferIndex = 0 };
+    // When the nodes may run in parallel, reusing the buffer which was freed the longest
+    // time ago makes it less likely that a node has to wait for the last user of its
+    // buffers. Otherwise the most recently used one is the most likely to still be cached.
+    const bool reuseOldestFreeBuffers;
 
-    struct Delay
-    {
-        NodeID nodeID;
-        int delay;
-    };
+    enum { readOnlyEmptyBufferIndex = 0 };
 
-    HashMap<uint32, int> delays;
+    HashMap<uint32, int> delays, inputLatencies;
     int totalLatency = 0;
 
     int getNodeDelay (NodeID nodeID) const noexcept
@@ -403,33 +713,210 @@ struct RenderSequenceBuilder
         return delays[nodeID.uid];
     }
 
-    int getInputLatencyForNode (NodeID nodeID) const
+    int getInputLatencyForNode (const Node& node) const noexcept
+    {
+        return inputLatencies[node.nodeID.uid];
+    }
+
+    //==============================================================================
+    // The latencies only depend on the graph's own order, so that a source which comes
+    // later because of a feedback loop is ignored whatever order the nodes are rendered in
+    void findNodeDelays (const Array<Node*>& graphOrder)
+    {
+        for (auto* node : graphOrder)
+        {
+            int maxLatency = 0;
+
+            for (auto&& i : node->inputs)
+                maxLatency = jmax (maxLatency, getNodeDelay (i.otherNode->nodeID));
+
+            auto& processor = *node->getProcessor();
+
+            inputLatencies.set (node->nodeID.uid, maxLatency);
+            delays.set (node->nodeID.uid, maxLatency + processor.getLatencySamples());
+
+            // (the order of the nodes depends on how the graph was edited, so this mustn't)
+            if (processor.getTotalNumOutputChannels() == 0)
+                totalLatency = jmax (totalLatency, maxLatency);
+        }
+    }
+
+    static std::map<int, int> countSourcesOfInputs (const Node& node)
     {
-        int maxLatency = 0;
+        std::map<int, int> numSources;
 
-        for (auto&& c : graph.getConnections())
-            if (c.destination.nodeID == nodeID)
-                maxLatency = jmax (maxLatency, getNodeDelay (c.source.nodeID));
+        for (auto&& i : node.inputs)
+            ++numSources[i.thisChannel];
 
-        return maxLatency;
+        return numSources;
     }
 
-    //==============================================================================
-    void createOrderedNodeList()
+    /*  The graph's order keeps the nodes in the order they were added where it can, which
+        often renders a whole layer of nodes before the next one, with all their outputs
+        waiting in buffers at the same time. Following each branch as far as possible
+        before starting another one can need far fewer buffers, so that order is used when
+        it's expected to need fewer of them. Either way, any two connected nodes stay in
+        the same order as in the graph's order, so that feedback loops are broken in the
+        same place.
+    */
+    Array<Node*> chooseRenderingOrder (const Array<Node*>& graphOrder) const
+    {
+        const auto numNodes = graphOrder.size();
+
+        std::vector<int> numNodesToWaitFor ((size_t) numNodes);
+        Array<Node*> readyNodes, newlyReadyNodes, depthFirstOrder;
+
+        auto isBefore = [] (const Node* a, const Node* b)  { return a->orderIndex < b->orderIndex; };
+
+        for (auto* node : graphOrder)
+        {
+            for (auto&& i : node->inputs)
+                if (isBefore (i.otherNode, node))
+                    ++numNodesToWaitFor[(size_t) node->orderIndex];
+
+            for (auto&& o : node->outputs)
+                if (isBefore (o.otherNode, node))
+                    ++numNodesToWaitFor[(size_t) node->orderIndex];
+        }
+
+        for (int i = numNodes; --i >= 0;)
+            if (numNodesToWaitFor[(size_t) i] == 0)
+                readyNodes.add (graphOrder.getUnchecked (i));
+
+        while (! readyNodes.isEmpty())
+        {
+            auto* node = readyNodes.removeAndReturn (readyNodes.size() - 1);
+            depthFirstOrder.add (node);
+
+            auto release = [&] (Node* other)
+            {
+                if (isBefore (node, other) && --numNodesToWaitFor[(size_t) other->orderIndex] == 0)
+                    newlyReadyNodes.add (other);
+            };
+
+            for (auto&& o : node->outputs)   release (o.otherNode);
+            for (auto&& i : node->inputs)    release (i.otherNode);
+
+            // (the one which comes first in the graph's order goes next)
+            std::sort (newlyReadyNodes.begin(), newlyReadyNodes.end(), [&] (const Node* a, const Node* b) { return isBefore (b, a); });
+            readyNodes.addArray (newlyReadyNodes);
+            newlyReadyNodes.clearQuick();
+        }
+
+        jassert (depthFirstOrder.size() == numNodes);
+
+        if (estimatePeakNumAudioBuffers (depthFirstOrder) < estimatePeakNumAudioBuffers (graphOrder))
+            return depthFirstOrder;
+
+        return graphOrder;
+    }
+
+    // Counts the output channels and mixes which are waiting in buffers at each step
+    static int estimatePeakNumAudioBuffers (const Array<Node*>& order)
+    {
+        const auto numNodes = (size_t) order.size();
+        std::vector<int> steps (numNodes), firstChannels (numNodes + 1);
+
+        for (size_t step = 0; step < numNodes; ++step)
+        {
+            auto* node = order.getUnchecked ((int) step);
+            steps[(size_t) node->orderIndex] = (int) step;
+            firstChannels[(size_t) node->orderIndex + 1] = node->getProcessor()->getTotalNumOutputChannels();
+        }
+
+        for (size_t i = 0; i < numNodes; ++i)
+            firstChannels[i + 1] += firstChannels[i];
+
+        std::vector<int> lastUses ((size_t) firstChannels.back()), changes ((size_t) numNodes + 1);
+
+        for (size_t i = 0; i < numNodes; ++i)
+            std::fill (lastUses.begin() + firstChannels[i], lastUses.begin() + firstChannels[i + 1], steps[i]);
+
+        for (auto* node : order)
+        {
+            const auto step = steps[(size_t) node->orderIndex];
+            const auto numIns = node->getProcessor()->getTotalNumInputChannels();
+            const auto numSources = countSourcesOfInputs (*node);
+            std::map<int, int> firstMixedSteps;
+
+            for (auto&& i : node->inputs)
+            {
+                const auto sourceStep = steps[(size_t) i.otherNode->orderIndex];
+
+                if (i.thisChannel == AudioProcessorGraph::midiChannelIndex || i.thisChannel >= numIns || sourceStep >= step)
+                    continue;
+
+                if (numSources.at (i.thisChannel) > 1)
+                {
+                    auto mixed = firstMixedSteps.insert ({ i.thisChannel, sourceStep });
+                    mixed.first->second = jmin (mixed.first->second, sourceStep);
+                }
+                else
+                {
+                    auto& lastUse = lastUses[(size_t) (firstChannels[(size_t) i.otherNode->orderIndex] + i.otherChannel)];
+                    lastUse = jmax (lastUse, step);
+                }
+            }
+
+            for (auto& mixed : firstMixedSteps)
+            {
+                ++changes[(size_t) mixed.second];
+                --changes[(size_t) step + 1];
+            }
+        }
+
+        for (size_t i = 0; i < numNodes; ++i)
+        {
+            for (auto channel = firstChannels[i]; channel < firstChannels[i + 1]; ++channel)
+            {
+                ++changes[(size_t) steps[i]];
+                --changes[(size_t) lastUses[(size_t) channel] + 1];
+            }
+        }
+
+        int numInUse = 0, peak = 0;
+
+        for (auto change : changes)
+            peak = jmax (peak, numInUse += change);
+
+        return peak;
+    }
+
+    void findConsumersOfOutputs()
     {
-        for (auto* node : graph.getNodes())
+        renderingIndexes.resize ((size_t) orderedNodes.size());
+
+        for (int step = 0; step < orderedNodes.size(); ++step)
+            renderingIndexes[(size_t) orderedNodes.getUnchecked (step)->orderIndex] = step;
+
+        for (int step = 0; step < orderedNodes.size(); ++step)
         {
-            int j = 0;
+            auto& node = *orderedNodes.getUnchecked (step);
+            auto numIns = node.getProcessor()->getTotalNumInputChannels();
+            auto numSources = countSourcesOfInputs (node);
+
+            for (auto&& i : node.inputs)
+            {
+                if (i.thisChannel != AudioProcessorGraph::midiChannelIndex && i.thisChannel >= numIns)
+                    continue;
 
-            for (; j < orderedNodes.size(); ++j)
-                if (graph.isAnInputTo (*node, *orderedNodes.getUnchecked(j)))
-                  break;
+                auto key = getKey ({ i.otherNode->nodeID, i.otherChannel });
 
-            orderedNodes.insert (j, node);
+                if (i.thisChannel != AudioProcessorGraph::midiChannelIndex && numSources[i.thisChannel] > 1)
+                {
+                    // (a source which is rendered later is part of a feedback loop, so is left out)
+                    if (renderingIndexes[(size_t) i.otherNode->orderIndex] < step)
+                        mixedInputs[key].add ({ &node, i.thisChannel });
+                }
+                else
+                {
+                    consumers[key].add ({ step, i.thisChannel });
+                }
+            }
         }
     }
 
-    int findBufferForInputAudioChannel (AudioProcessorGraph::Node& node, const int inputChan,
+    int findBufferForInputAudioChannel (Node& node, const int inputChan,
                                         const int ourRenderingIndex, const int maxLatency)
     {
         auto& processor = *node.getProcessor();
@@ -459,8 +946,12 @@ struct RenderSequenceBuilder
             if (bufIndex < 0)
             {
                 // if not found, this is probably a feedback loop
-                bufIndex = readOnlyEmptyBufferIndex;
-                jassert (bufIndex >= 0);
+                if (inputChan >= numOuts)
+                    return readOnlyEmptyBufferIndex;
+
+                auto index = getFreeBuffer (audioBuffers);
+                sequence.addClearChannelOp (index);
+                return index;
             }
 
             if (inputChan < numOuts
@@ -481,84 +972,97 @@ struct RenderSequenceBuilder
             return bufIndex;
         }
 
-        // Handle a mix of several outputs coming into this input..
-        int reusableInputIndex = -1;
-        int bufIndex = -1;
+        // Handle a mix of several outputs coming into this input, which has been made
+        // as they were rendered..
+        auto mix = mixBuffers.find (getKey ({ node.nodeID, inputChan }));
 
-        for (int i = 0; i < sources.size(); ++i)
+        if (mix != mixBuffers.end())
         {
-            auto src = sources.getReference(i);
-            auto sourceBufIndex = getBufferContaining (src);
+            auto bufIndex = mix->second;
+            mixBuffers.erase (mix);
+            audioBuffers.getReference (bufIndex).setAssignedToNonExistentNode();
+            return bufIndex;
+        }
 
-            if (sourceBufIndex >= 0 && ! isBufferNeededLater (ourRenderingIndex, inputChan, src))
-            {
-                // we've found one of our input chans that can be re-used..
-                reusableInputIndex = i;
-                bufIndex = sourceBufIndex;
+        // ..unless all of them are part of a feedback loop
+        auto bufIndex = getFreeBuffer (audioBuffers);
+        audioBuffers.getReference (bufIndex).setAssignedToNonExistentNode();
+        sequence.addClearChannelOp (bufIndex);
+        return bufIndex;
+    }
 
-                auto nodeDelay = getNodeDelay (src.nodeID);
+    /*  Rather than waiting in their own buffers until the node they go to is rendered,
+        the outputs which get mixed with others are added to the mix straight away, which
+        lets their buffers be reused by the following nodes.
+    */
+    void createMixingOpsForOutputs (Node& node, const int ourRenderingIndex)
+    {
+        auto numOuts = node.getProcessor()->getTotalNumOutputChannels();
+        auto nodeDelay = getNodeDelay (node.nodeID);
 
-                if (nodeDelay < maxLatency)
-                    sequence.addDelayChannelOp (bufIndex, maxLatency - nodeDelay);
+        for (int outputChan = 0; outputChan < numOuts; ++outputChan)
+        {
+            const AudioProcessorGraph::NodeAndChannel output { node.nodeID, outputChan };
+            auto found = mixedInputs.find (getKey (output));
 
-                break;
-            }
-        }
+            if (found == mixedInputs.end())
+                continue;
 
-        if (reusableInputIndex < 0)
-        {
-            // can't re-use any of our input chans, so get a new one and copy everything into it..
-            bufIndex = getFreeBuffer (audioBuffers);
-            jassert (bufIndex != 0);
+            auto& inputs = found->second;
 
-            audioBuffers.getReference (bufIndex).setAssignedToNonExistentNode();
+            for (int i = 0; i < inputs.size(); ++i)
+            {
+                auto& input = inputs.getReference (i);
+                auto srcIndex = getBufferContaining (output);
+                jassert (srcIndex > 0);
 
-            auto srcIndex = getBufferContaining (sources.getFirst());
+                auto isLastUse = i == inputs.size() - 1 && ! isBufferNeededLater (ourRenderingIndex + 1, -1, output);
+                auto delay = getInputLatencyForNode (*input.node) - nodeDelay;
+                auto mixKey = getKey ({ input.node->nodeID, input.inputChannel });
+                auto mix = mixBuffers.find (mixKey);
 
-            if (srcIndex < 0)
-                sequence.addClearChannelOp (bufIndex);  // if not found, this is probably a feedback loop
-            else
-                sequence.addCopyChannelOp (srcIndex, bufIndex);
+                if (mix == mixBuffers.end())
+                {
+                    // the first source to be rendered starts the mix
+                    auto mixIndex = srcIndex;
 
-            reusableInputIndex = 0;
-            auto nodeDelay = getNodeDelay (sources.getFirst().nodeID);
+                    if (! isLastUse)
+                    {
+                        mixIndex = getFreeBuffer (audioBuffers);
+                        sequence.addCopyChannelOp (srcIndex, mixIndex);
+                    }
 
-            if (nodeDelay < maxLatency)
-                sequence.addDelayChannelOp (bufIndex, maxLatency - nodeDelay);
-        }
+                    if (delay > 0)
+                        sequence.addDelayChannelOp (mixIndex, delay);
 
-        for (int i = 0; i < sources.size(); ++i)
-        {
-            if (i != reusableInputIndex)
-            {
-                auto src = sources.getReference(i);
-                int srcIndex = getBufferContaining (src);
+                    audioBuffers.getReference (mixIndex).setMixing();
+                    mixBuffers[mixKey] = mixIndex;
+                    continue;
+                }
 
-                if (srcIndex >= 0)
-                {
-                    auto nodeDelay = getNodeDelay (src.nodeID);
+                auto bufferToAdd = srcIndex;
 
-                    if (nodeDelay < maxLatency)
+                if (delay > 0)
+                {
+                    if (! isLastUse)
                     {
-                        if (! isBufferNeededLater (ourRenderingIndex, inputChan, src))
-                        {
-                            sequence.addDelayChannelOp (srcIndex, maxLatency - nodeDelay);
-                        }
-                        else // buffer is reused elsewhere, can't be delayed
-                        {
-                            auto bufferToDelay = getFreeBuffer (audioBuffers);
-                            sequence.addCopyChannelOp (srcIndex, bufferToDelay);
-                            sequence.addDelayChannelOp (bufferToDelay, maxLatency - nodeDelay);
-                            srcIndex = bufferToDelay;
-                        }
+                        // buffer is used elsewhere, so can't be delayed
+                        bufferToAdd = getFreeBuffer (audioBuffers);
+                        sequence.addCopyChannelOp (srcIndex, bufferToAdd);
                     }
 
-                    sequence.addAddChannelOp (srcIndex, bufIndex);
+                    sequence.addDelayChannelOp (bufferToAdd, delay);
                 }
+
+                sequence.addAddChannelOp (bufferToAdd, mix->second);
+
+                if (bufferToAdd != srcIndex || isLastUse)
+                    freeBuffer (audioBuffers.getReference (bufferToAdd));
             }
         }
 
-        return bufIndex;
+        // (these ops don't have to wait for the ones of the next node, or the other way round)
+        sequence.endTask();
     }
 
     int findBufferForInputMidiChannel (AudioProcessorGraph::Node& node, int ourRenderingIndex)
@@ -660,7 +1164,7 @@ struct RenderSequenceBuilder
         auto totalChans = jmax (numIns, numOuts);
 
         Array<int> audioChannelsToUse;
-        auto maxLatency = getInputLatencyForNode (node.nodeID);
+        auto maxLatency = getInputLatencyForNode (node);
 
         for (int inputChan = 0; inputChan < numIns; ++inputChan)
         {
@@ -688,11 +1192,6 @@ struct RenderSequenceBuilder
         if (processor.producesMidi())
             midiBuffers.getReference (midiBufferToUse).channel = { node.nodeID, AudioProcessorGraph::midiChannelIndex };
 
-        delays.set (node.nodeID.uid, maxLatency + processor.getLatencySamples());
-
-        if (numOuts == 0)
-            totalLatency = maxLatency;
-
         sequence.addProcessOp (node, audioChannelsToUse, totalChans, midiBufferToUse);
     }
 
@@ -700,25 +1199,51 @@ struct RenderSequenceBuilder
     Array<AudioProcessorGraph::NodeAndChannel> getSourcesForChannel (AudioProcessorGraph::Node& node, int inputChannelIndex)
     {
         Array<AudioProcessorGraph::NodeAndChannel> results;
-        AudioProcessorGraph::NodeAndChannel nc { node.nodeID, inputChannelIndex };
 
-        for (auto&& c : graph.getConnections())
-            if (c.destination == nc)
-                results.add (c.source);
+        for (auto&& i : node.inputs)
+            if (i.thisChannel == inputChannelIndex)
+                results.add ({ i.otherNode->nodeID, i.otherChannel });
+
+        // in the same order as getConnections(), so that the sources are always mixed in the same order
+        std::sort (results.begin(), results.end(), [] (const AudioProcessorGraph::NodeAndChannel& a,
+                                                       const AudioProcessorGraph::NodeAndChannel& b)
+        {
+            return a.nodeID != b.nodeID ? a.nodeID < b.nodeID
+                                        : a.channelIndex < b.channelIndex;
+        });
 
         return results;
     }
 
-    static int getFreeBuffer (Array<AssignedBuffer>& buffers)
+    int getFreeBuffer (Array<AssignedBuffer>& buffers)
     {
-        for (int i = 1; i < buffers.size(); ++i)
-            if (buffers.getReference (i).isFree())
-                return i;
+        if (&buffers == &audioBuffers)
+            ++numAudioBuffersAllocated;
+
+        int best = -1;
+
+        for (int i = 1; i < buffers.size(); ++i)
+        {
+            auto& b = buffers.getReference (i);
+
+            if (b.isFree()
+                 && (best < 0 || (reuseOldestFreeBuffers ? b.timeFreed < buffers.getReference (best).timeFreed
+                                                         : b.timeFreed > buffers.getReference (best).timeFreed)))
+                best = i;
+        }
+
+        if (best >= 0)
+            return best;
 
         buffers.add (AssignedBuffer::createFree());
         return buffers.size() - 1;
     }
 
+    void freeBuffer (AssignedBuffer& b) noexcept
+    {
+        b.setFree (++numBuffersFreed);
+    }
+
     int getBufferContaining (AudioProcessorGraph::NodeAndChannel output) const noexcept
     {
         int i = 0;
@@ -737,34 +1262,31 @@ struct RenderSequenceBuilder
     void markAnyUnusedBuffersAsFree (Array<AssignedBuffer>& buffers, const int stepIndex)
     {
         for (auto& b : buffers)
-            if (b.isAssigned() && ! isBufferNeededLater (stepIndex, -1, b.channel))
-                b.setFree();
+            if (b.isAssigned() && ! isBufferNeededLater (stepIndex + 1, -1, b.channel))
+                freeBuffer (b);
     }
 
     bool isBufferNeededLater (int stepIndexToSearchFrom,
                               int inputChannelOfIndexToIgnore,
                               AudioProcessorGraph::NodeAndChannel output) const
     {
-        while (stepIndexToSearchFrom < orderedNodes.size())
+        auto found = consumers.find (getKey (output));
+
+        if (found == consumers.end())
+            return false;
+
+        auto& list = found->second;
+
+        // (the list is sorted by step, so the last consumers are the most likely to match)
+        for (int i = list.size(); --i >= 0;)
         {
-            auto* node = orderedNodes.getUnchecked (stepIndexToSearchFrom);
+            auto& consumer = list.getReference (i);
 
-            if (output.isMIDI())
-            {
-                if (inputChannelOfIndexToIgnore != AudioProcessorGraph::midiChannelIndex
-                     && graph.isConnected ({ { output.nodeID, AudioProcessorGraph::midiChannelIndex },
-                                             { node->nodeID,  AudioProcessorGraph::midiChannelIndex } }))
-                    return true;
-            }
-            else
-            {
-                for (int i = 0; i < node->getProcessor()->getTotalNumInputChannels(); ++i)
-                    if (i != inputChannelOfIndexToIgnore && graph.isConnected ({ output, { node->nodeID, i } }))
-                        return true;
-            }
+            if (consumer.step < stepIndexToSearchFrom)
+                return false;
 
-            inputChannelOfIndexToIgnore = -1;
-            ++stepIndexToSearchFrom;
+            if (consumer.step > stepIndexToSearchFrom || consumer.inputChannel != inputChannelOfIndexToIgnore)
+                return true;
         }
 
         return false;
@@ -843,6 +1365,12 @@ void AudioProcessorGraph::Node::unprepare()
     }
 }
 
+void AudioProcessorGraph::Node::ensureParameterAutomationSize (int numPointsToAllocate)
+{
+    parameterAutomation.ensureSize (numPointsToAllocate);
+    parameterAutomationChunk.ensureSize (numPointsToAllocate);
+}
+
 void AudioProcessorGraph::Node::setParentGraph (AudioProcessorGraph* const graph) const
 {
     const ScopedLock lock (processorLock);
@@ -885,8 +1413,197 @@ void AudioProcessorGraph::Node::setBypassed (bool shouldBeBypassed) noexcept
 struct AudioProcessorGraph::RenderSequenceFloat   : public GraphRenderSequence<float> {};
 struct AudioProcessorGraph::RenderSequenceDouble  : public GraphRenderSequence<double> {};
 
+//==============================================================================
+/*  Hands the render sequences built on the message thread over to the audio thread
+    without any locking.
+
+    A new pair of sequences is published through an atomic pointer, which the audio
+    thread picks up at the start of a block. The sequences it replaces are pushed onto
+    a lock-free list, and deleted later on the message thread, so that the audio thread
+    never frees memory or releases the last reference to a node.
+
+    The structural changes which delete the sequences being rendered, or replace the
+    worker pool, are rare enough to take a lock, which the audio thread only tries to
+    take: if it can't, the block is cleared rather than rendered.
+*/
+class AudioProcessorGraph::RenderSequenceExchange  : private Timer
+{
+public:
+    struct Sequences
+    {
+        RenderSequenceFloat  sequenceFloat;
+        RenderSequenceDouble sequenceDouble;
+
+        GraphRenderSequence<float>&  getFor (const AudioBuffer<float>&) noexcept     { return sequenceFloat; }
+        GraphRenderSequence<double>& getFor (const AudioBuffer<double>&) noexcept    { return sequenceDouble; }
+
+        Sequences* nextRetired = nullptr;
+    };
+
+    RenderSequenceExchange() = default;
+
+    ~RenderSequenceExchange() override
+    {
+        stopTimer();
+        clear();
+    }
+
+    /** Publishes a new pair of sequences. Called on the message thread. */
+    void set (std::unique_ptr<Sequences> newSequences)
+    {
+        collectRetiredSequences();
+
+        // If the audio thread didn't pick up the previous ones, it never will
+        std::unique_ptr<Sequences> unused (pending.exchange (newSequences.release()));
+
+        lastPendingSeenByTimer = nullptr;
+        startTimer (100);
+    }
+
+    /** Renders a block with the latest sequences. This must only be called by the audio
+        thread, which waits for any structural change to finish when rendering offline.
+    */
+    template <typename FloatType>
+    void render (AudioBuffer<FloatType>& buffer, MidiBuffer& midiMessages,
+                 AudioPlayHead* playHead, bool isNonRealtime) noexcept
+    {
+        if (isNonRealtime)
+        {
+            const ScopedLock sl (structureLock);
+            renderWithLockHeld (buffer, midiMessages, playHead);
+            return;
+        }
+
+        const ScopedTryLock stl (structureLock);
+
+        if (stl.isLocked())
+        {
+            renderWithLockHeld (buffer, midiMessages, playHead);
+        }
+        else
+        {
+            buffer.clear();
+            midiMessages.clear();
+        }
+    }
+
+    /** Returns the sequences being rendered by the audio thread. */
+    Sequences* getCurrentSequences() const noexcept     { return current.get(); }
+
+    /** Deletes all the sequences. Called on the message thread. */
+    void clear()
+    {
+        std::unique_ptr<Sequences> oldCurrent, unusedPending;
+
+        {
+            const ScopedLock sl (structureLock);
+            oldCurrent = std::move (current);
+            unusedPending.reset (pending.exchange (nullptr));
+        }
+
+        collectRetiredSequences();
+    }
+
+    /** Replaces the pool used to render the tasks of the sequences in parallel, which
+        may be null. Called on the message thread.
+    */
+    void setWorkerPool (std::unique_ptr<AudioWorkerPool> newPool)
+    {
+        {
+            const ScopedLock sl (structureLock);
+            std::swap (workerPool, newPool);
+        }
+
+        // the old pool's threads are stopped here, without holding the lock
+    }
+
+    bool hasWorkerPool() const noexcept                 { return workerPool != nullptr; }
+
+private:
+    template <typename FloatType>
+    void renderWithLockHeld (AudioBuffer<FloatType>& buffer, MidiBuffer& midiMessages, AudioPlayHead* playHead) noexcept
+    {
+        // The pending slot is only emptied elsewhere while the lock is held, so the old
+        // sequences are always retired before the slot is seen to be empty
+        if (pending.load() != nullptr)
+        {
+            if (auto* old = current.release())
+            {
+                old->nextRetired = retired.load();
+
+                while (! retired.compare_exchange_weak (old->nextRetired, old))
+                {}
+            }
+
+            current.reset (pending.exchange (nullptr));
+        }
+
+        if (current != nullptr)
+            current->getFor (buffer).perform (buffer, midiMessages, playHead, workerPool.get());
+    }
+
+    void collectRetiredSequences()
+    {
+        for (auto* old = retired.exchange (nullptr); old != nullptr;)
+        {
+            auto* next = old->nextRetired;
+            delete old;
+            old = next;
+        }
+    }
+
+    void timerCallback() override
+    {
+        collectRetiredSequences();
+
+        auto* newSequences = pending.load();
+
+        if (newSequences == nullptr)
+        {
+            // Anything retired since the collection above will be deleted on the next tick
+            if (retired.load() == nullptr)
+                stopTimer();
+
+            return;
+        }
+
+        // If the audio thread hasn't picked up the new sequences for a whole tick, the
+        // graph isn't being played, so they're swapped in here instead
+        if (newSequences != lastPendingSeenByTimer)
+        {
+            lastPendingSeenByTimer = newSequences;
+            return;
+        }
+
+        std::unique_ptr<Sequences> oldCurrent;
+
+        {
+            const ScopedTryLock stl (structureLock);
+
+            if (! stl.isLocked())
+                return;
+
+            oldCurrent = std::move (current);
+            current.reset (pending.exchange (nullptr));
+        }
+
+        lastPendingSeenByTimer = nullptr;
+        stopTimer();
+    }
+
+    std::unique_ptr<Sequences> current;
+    std::atomic<Sequences*> pending { nullptr }, retired { nullptr };
+    Sequences* lastPendingSeenByTimer = nullptr;
+
+    std::unique_ptr<AudioWorkerPool> workerPool;
+    CriticalSection structureLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderSequenceExchange)
+};
+
 //==============================================================================
 AudioProcessorGraph::AudioProcessorGraph()
+    : renderSequenceExchange (new RenderSequenceExchange())
 {
 }
 
@@ -913,12 +1630,16 @@ void AudioProcessorGraph::topologyChanged()
 
 void AudioProcessorGraph::clear()
 {
-    const ScopedLock sl (getCallbackLock());
-
     if (nodes.isEmpty())
         return;
 
-    nodes.clear();
+    {
+        const ScopedLock sl (getCallbackLock());
+        nodes.clear();
+    }
+
+    orderedNodes.clear();
+    isNodeOrderValid = true;
     topologyChanged();
 }
 
@@ -963,6 +1684,10 @@ AudioProcessorGraph::Node::Ptr AudioProcessorGraph::addNode (std::unique_ptr<Aud
         nodes.add (n.get());
     }
 
+    // a node without any connections can go anywhere in the order
+    n->orderIndex = orderedNodes.size();
+    orderedNodes.add (n.get());
+
     n->setParentGraph (this);
     topologyChanged();
     return n;
@@ -970,14 +1695,24 @@ AudioProcessorGraph::Node::Ptr AudioProcessorGraph::addNode (std::unique_ptr<Aud
 
 AudioProcessorGraph::Node::Ptr AudioProcessorGraph::removeNode (NodeID nodeId)
 {
-    const ScopedLock sl (getCallbackLock());
-
     for (int i = nodes.size(); --i >= 0;)
     {
         if (nodes.getUnchecked (i)->nodeID == nodeId)
         {
-            disconnectNode (nodeId);
-            auto node = nodes.removeAndReturn (i);
+            removeNodeConnections (*nodes.getUnchecked (i));
+
+            Node::Ptr node;
+
+            {
+                const ScopedLock sl (getCallbackLock());
+                node = nodes.removeAndReturn (i);
+            }
+
+            orderedNodes.remove (node->orderIndex);
+
+            for (int j = node->orderIndex; j < orderedNodes.size(); ++j)
+                orderedNodes.getUnchecked (j)->orderIndex = j;
+
             topologyChanged();
             return node;
         }
@@ -1054,6 +1789,10 @@ bool AudioProcessorGraph::isAnInputTo (Node& src, Node& dst) const noexcept
     jassert (nodes.contains (&src));
     jassert (nodes.contains (&dst));
 
+    // all the inputs of a node come before it in a valid order
+    if (isNodeOrderValid && src.orderIndex > dst.orderIndex)
+        return false;
+
     return isAnInputTo (src, dst, nodes.size());
 }
 
@@ -1119,6 +1858,7 @@ bool AudioProcessorGraph::addConnection (const Connection& c)
                 source->outputs.add ({ dest, destChan, sourceChan });
                 dest->inputs.add ({ source, sourceChan, destChan });
                 jassert (isConnected (c));
+                updateNodeOrderForNewConnection (*source, *dest);
                 topologyChanged();
                 return true;
             }
@@ -1129,6 +1869,17 @@ bool AudioProcessorGraph::addConnection (const Connection& c)
 }
 
 bool AudioProcessorGraph::removeConnection (const Connection& c)
+{
+    if (removeConnectionWithoutUpdate (c))
+    {
+        topologyChanged();
+        return true;
+    }
+
+    return false;
+}
+
+bool AudioProcessorGraph::removeConnectionWithoutUpdate (const Connection& c)
 {
     if (auto* source = getNodeForId (c.source.nodeID))
     {
@@ -1139,9 +1890,9 @@ bool AudioProcessorGraph::removeConnection (const Connection& c)
 
             if (isConnected (source, sourceChan, dest, destChan))
             {
+                // (removing a connection never invalidates the order of the nodes)
                 source->outputs.removeAllInstancesOf ({ dest, destChan, sourceChan });
                 dest->inputs.removeAllInstancesOf ({ source, sourceChan, destChan });
-                topologyChanged();
                 return true;
             }
         }
@@ -1150,18 +1901,24 @@ bool AudioProcessorGraph::removeConnection (const Connection& c)
     return false;
 }
 
+bool AudioProcessorGraph::removeNodeConnections (Node& node)
+{
+    std::vector<Connection> connections;
+    getNodeConnections (node, connections);
+
+    for (auto c : connections)
+        removeConnectionWithoutUpdate (c);
+
+    return ! connections.empty();
+}
+
 bool AudioProcessorGraph::disconnectNode (NodeID nodeID)
 {
     if (auto* node = getNodeForId (nodeID))
     {
-        std::vector<Connection> connections;
-        getNodeConnections (*node, connections);
-
-        if (! connections.empty())
+        if (removeNodeConnections (*node))
         {
-            for (auto c : connections)
-                removeConnection (c);
-
+            topologyChanged();
             return true;
         }
     }
@@ -1197,23 +1954,158 @@ bool AudioProcessorGraph::removeIllegalConnections()
 
         for (auto c : connections)
             if (! isConnectionLegal (c))
-                anyRemoved = removeConnection (c) || anyRemoved;
+                anyRemoved = removeConnectionWithoutUpdate (c) || anyRemoved;
     }
 
+    if (anyRemoved)
+        topologyChanged();
+
     return anyRemoved;
 }
 
 //==============================================================================
-void AudioProcessorGraph::clearRenderingSequence()
+/*  The order in which the nodes are rendered is kept up to date as the connections
+    change, rather than being worked out from scratch for each new rendering sequence.
+
+    When a new connection goes against the current order, only the nodes between its
+    ends which depend on it are moved, using the algorithm of Pearce and Kelly ("A dynamic
+    topological sort algorithm for directed acyclic graphs", 2006). If the connection
+    creates a feedback loop, there's no such order, and the nodes are sorted again the
+    next time the rendering sequence is built.
+*/
+void AudioProcessorGraph::updateNodeOrderForNewConnection (Node& source, Node& dest)
 {
-    std::unique_ptr<RenderSequenceFloat> oldSequenceF;
-    std::unique_ptr<RenderSequenceDouble> oldSequenceD;
+    if (! isNodeOrderValid)
+        return;
+
+    const auto lowerBound = dest.orderIndex;
+    const auto upperBound = source.orderIndex;
+
+    if (lowerBound > upperBound)
+        return;
 
+    // The nodes which follow dest and must move after source...
+    Array<Node*> forward, stack;
+    SortedSet<Node*> visited;
+    stack.add (&dest);
+    visited.add (&dest);
+
+    while (! stack.isEmpty())
     {
-        const ScopedLock sl (getCallbackLock());
-        std::swap (renderSequenceFloat, oldSequenceF);
-        std::swap (renderSequenceDouble, oldSequenceD);
+        auto* node = stack.removeAndReturn (stack.size() - 1);
+        forward.add (node);
+
+        for (auto& o : node->outputs)
+        {
+            if (o.otherNode == &source)
+            {
+                isNodeOrderValid = false; // a feedback loop
+                return;
+            }
+
+            if (o.otherNode->orderIndex < upperBound && ! visited.contains (o.otherNode))
+            {
+                visited.add (o.otherNode);
+                stack.add (o.otherNode);
+            }
+        }
+    }
+
+    // ... and the nodes which lead to source and must move before dest
+    Array<Node*> backward;
+    stack.add (&source);
+    visited.add (&source);
+
+    while (! stack.isEmpty())
+    {
+        auto* node = stack.removeAndReturn (stack.size() - 1);
+        backward.add (node);
+
+        for (auto& i : node->inputs)
+        {
+            if (i.otherNode->orderIndex > lowerBound && ! visited.contains (i.otherNode))
+            {
+                visited.add (i.otherNode);
+                stack.add (i.otherNode);
+            }
+        }
+    }
+
+    // The two sets take over the same positions, with backward before forward
+    auto byOrder = [] (const Node* a, const Node* b) { return a->orderIndex < b->orderIndex; };
+    std::sort (forward.begin(),  forward.end(),  byOrder);
+    std::sort (backward.begin(), backward.end(), byOrder);
+
+    Array<int> positions;
+
+    for (auto* node : backward)   positions.add (node->orderIndex);
+    for (auto* node : forward)    positions.add (node->orderIndex);
+
+    positions.sort();
+
+    int index = 0;
+
+    for (auto* node : backward)   orderedNodes.set (node->orderIndex = positions[index++], node);
+    for (auto* node : forward)    orderedNodes.set (node->orderIndex = positions[index++], node);
+}
+
+const Array<AudioProcessorGraph::Node*>& AudioProcessorGraph::getOrderedNodes()
+{
+    if (! isNodeOrderValid)
+    {
+        // Kahn's algorithm, starting from the nodes in the order they were added
+        Array<Node*> sorted;
+        HashMap<Node*, int> numPendingInputs;
+
+        for (auto* node : nodes)
+        {
+            numPendingInputs.set (node, node->inputs.size());
+
+            if (node->inputs.isEmpty())
+                sorted.add (node);
+        }
+
+        isNodeOrderValid = true;
+        int nextUnsorted = 0;
+
+        for (int i = 0; sorted.size() < nodes.size(); ++i)
+        {
+            if (i == sorted.size())
+            {
+                // Only feedback loops are left, so break one of them at the earliest node added
+                while (numPendingInputs[nodes.getObjectPointerUnchecked (nextUnsorted)] <= 0)
+                    ++nextUnsorted;
+
+                auto* node = nodes.getObjectPointerUnchecked (nextUnsorted);
+                numPendingInputs.set (node, 0);
+                sorted.add (node);
+                isNodeOrderValid = false;
+            }
+
+            for (auto& o : sorted.getUnchecked (i)->outputs)
+            {
+                auto remaining = numPendingInputs[o.otherNode] - 1;
+                numPendingInputs.set (o.otherNode, remaining);
+
+                if (remaining == 0)
+                    sorted.add (o.otherNode);
+            }
+        }
+
+        orderedNodes.swapWith (sorted);
+
+        for (int i = 0; i < orderedNodes.size(); ++i)
+            orderedNodes.getUnchecked (i)->orderIndex = i;
     }
+
+    return orderedNodes;
+}
+
+//==============================================================================
+void AudioProcessorGraph::clearRenderingSequence()
+{
+    const ScopedLock sl (getCallbackLock());
+    renderSequenceExchange->clear();
 }
 
 bool AudioProcessorGraph::anyNodesNeedPreparing() const noexcept
@@ -1227,31 +2119,24 @@ bool AudioProcessorGraph::anyNodesNeedPreparing() const noexcept
 
 void AudioProcessorGraph::buildRenderingSequence()
 {
-    auto newSequenceF = std::make_unique<RenderSequenceFloat>();
-    auto newSequenceD = std::make_unique<RenderSequenceDouble>();
-
-    RenderSequenceBuilder<RenderSequenceFloat>  builderF (*this, *newSequenceF);
-    RenderSequenceBuilder<RenderSequenceDouble> builderD (*this, *newSequenceD);
+    auto newSequences = std::make_unique<RenderSequenceExchange::Sequences>();
 
-    const ScopedLock sl (getCallbackLock());
+    RenderSequenceBuilder<RenderSequenceFloat>  builderF (*this, newSequences->sequenceFloat);
+    RenderSequenceBuilder<RenderSequenceDouble> builderD (*this, newSequences->sequenceDouble);
 
     const auto currentBlockSize = getBlockSize();
-    newSequenceF->prepareBuffers (currentBlockSize);
-    newSequenceD->prepareBuffers (currentBlockSize);
+    newSequences->sequenceFloat .prepareBuffers (currentBlockSize);
+    newSequences->sequenceDouble.prepareBuffers (currentBlockSize);
 
+    // The nodes which need preparing aren't used by the sequences the audio thread may
+    // be rendering, and each node's lock stops it being processed while it's prepared,
+    // so none of this needs the callback lock
     if (anyNodesNeedPreparing())
-    {
-        renderSequenceFloat.reset();
-        renderSequenceDouble.reset();
-
         for (auto* node : nodes)
             node->prepare (getSampleRate(), currentBlockSize, this, getProcessingPrecision());
-    }
 
+    renderSequenceExchange->set (std::move (newSequences));
     isPrepared = 1;
-
-    std::swap (renderSequenceFloat,  newSequenceF);
-    std::swap (renderSequenceDouble, newSequenceD);
 }
 
 void AudioProcessorGraph::handleAsyncUpdate()
@@ -1311,11 +2196,7 @@ void AudioProcessorGraph::releaseResources()
 
     unprepare();
 
-    if (renderSequenceFloat != nullptr)
-        renderSequenceFloat->releaseBuffers();
-
-    if (renderSequenceDouble != nullptr)
-        renderSequenceDouble->releaseBuffers();
+    renderSequenceExchange->clear();
 }
 
 void AudioProcessorGraph::reset()
@@ -1326,6 +2207,23 @@ void AudioProcessorGraph::reset()
         n->getProcessor()->reset();
 }
 
+void AudioProcessorGraph::setParallelRendering (int numWorkerThreads)
+{
+    jassert (numWorkerThreads >= 0);
+
+    std::unique_ptr<AudioWorkerPool> newPool;
+
+    if (numWorkerThreads > 0)
+        newPool.reset (new AudioWorkerPool (numWorkerThreads));
+
+    renderSequenceExchange->setWorkerPool (std::move (newPool));
+}
+
+bool AudioProcessorGraph::isParallelRenderingEnabled() const noexcept
+{
+    return renderSequenceExchange->hasWorkerPool();
+}
+
 void AudioProcessorGraph::setNonRealtime (bool isProcessingNonRealtime) noexcept
 {
     const ScopedLock sl (getCallbackLock());
@@ -1342,37 +2240,25 @@ bool AudioProcessorGraph::producesMidi() const                      { return tru
 void AudioProcessorGraph::getStateInformation (juce::MemoryBlock&)  {}
 void AudioProcessorGraph::setStateInformation (const void*, int)    {}
 
-template <typename FloatType, typename SequenceType>
+template <typename FloatType, typename ExchangeType>
 static void processBlockForBuffer (AudioBuffer<FloatType>& buffer, MidiBuffer& midiMessages,
                                    AudioProcessorGraph& graph,
-                                   std::unique_ptr<SequenceType>& renderSequence,
+                                   ExchangeType& renderSequenceExchange,
                                    std::atomic<bool>& isPrepared)
 {
     if (graph.isNonRealtime())
     {
         while (! isPrepared)
             Thread::sleep (1);
-
-        const ScopedLock sl (graph.getCallbackLock());
-
-        if (renderSequence != nullptr)
-            renderSequence->perform (buffer, midiMessages, graph.getPlayHead());
     }
-    else
+    else if (! isPrepared)
     {
-        const ScopedLock sl (graph.getCallbackLock());
-
-        if (isPrepared)
-        {
-            if (renderSequence != nullptr)
-                renderSequence->perform (buffer, midiMessages, graph.getPlayHead());
-        }
-        else
-        {
-            buffer.clear();
-            midiMessages.clear();
-        }
+        buffer.clear();
+        midiMessages.clear();
+        return;
     }
+
+    renderSequenceExchange.render (buffer, midiMessages, graph.getPlayHead(), graph.isNonRealtime());
 }
 
 void AudioProcessorGraph::processBlock (AudioBuffer<float>& buffer, MidiBuffer& midiMessages)
@@ -1380,7 +2266,7 @@ void AudioProcessorGraph::processBlock (AudioBuffer<float>& buffer, MidiBuffer&
     if ((! isPrepared) && MessageManager::getInstance()->isThisTheMessageThread())
         handleAsyncUpdate();
 
-    processBlockForBuffer<float> (buffer, midiMessages, *this, renderSequenceFloat, isPrepared);
+    processBlockForBuffer (buffer, midiMessages, *this, *renderSequenceExchange, isPrepared);
 }
 
 void AudioProcessorGraph::processBlock (AudioBuffer<double>& buffer, MidiBuffer& midiMessages)
@@ -1388,7 +2274,7 @@ void AudioProcessorGraph::processBlock (AudioBuffer<double>& buffer, MidiBuffer&
     if ((! isPrepared) && MessageManager::getInstance()->isThisTheMessageThread())
         handleAsyncUpdate();
 
-    processBlockForBuffer<double> (buffer, midiMessages, *this, renderSequenceDouble, isPrepared);
+    processBlockForBuffer (buffer, midiMessages, *this, *renderSequenceExchange, isPrepared);
 }
 
 //==============================================================================
@@ -1492,13 +2378,13 @@ static void processIOBlock (AudioProcessorGraph::AudioGraphIOProcessor& io, Sequ
 void AudioProcessorGraph::AudioGraphIOProcessor::processBlock (AudioBuffer<float>& buffer, MidiBuffer& midiMessages)
 {
     jassert (graph != nullptr);
-    processIOBlock (*this, *graph->renderSequenceFloat, buffer, midiMessages);
+    processIOBlock (*this, graph->renderSequenceExchange->getCurrentSequences()->sequenceFloat, buffer, midiMessages);
 }
 
 void AudioProcessorGraph::AudioGraphIOProcessor::processBlock (AudioBuffer<double>& buffer, MidiBuffer& midiMessages)
 {
     jassert (graph != nullptr);
-    processIOBlock (*this, *graph->renderSequenceDouble, buffer, midiMessages);
+    processIOBlock (*this, graph->renderSequenceExchange->getCurrentSequences()->sequenceDouble, buffer, midiMessages);
 }
 
 double AudioProcessorGraph::AudioGraphIOProcessor::getTailLengthSeconds() const
@@ -1547,4 +2433,736 @@ void AudioProcessorGraph::AudioGraphIOProcessor::setParentGraph (AudioProcessorG
     }
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AudioProcessorGraphTests  : public UnitTest
+{
+public:
+    AudioProcessorGraphTests()
+        : UnitTest ("AudioProcessorGraph", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Parallel rendering matches serial rendering");
+        {
+            for (auto numWorkers : { 1, 3 })
+            {
+                AudioProcessorGraph serial, parallel;
+                parallel.setParallelRendering (numWorkers);
+                expect (parallel.isParallelRenderingEnabled());
+
+                for (auto* graph : { &serial, &parallel })
+                    createBranchingGraph (*graph, 24, 0);
+
+                for (int block = 0; block < 40; ++block)
+                {
+                    // (some blocks are larger than the prepared block size, so get split)
+                    auto numSamples = block % 10 == 9 ? 700 : 1 + Random (block).nextInt (blockSize);
+                    AudioBuffer<float> serialAudio (2, numSamples), parallelAudio (2, numSamples);
+                    MidiBuffer serialMidi, parallelMidi;
+
+                    fillBlock (serialAudio, serialMidi, block);
+                    fillBlock (parallelAudio, parallelMidi, block);
+
+                    serial.processBlock (serialAudio, serialMidi);
+                    parallel.processBlock (parallelAudio, parallelMidi);
+
+                    expect (buffersAreIdentical (serialAudio, parallelAudio));
+                    expect (midiBuffersAreIdentical (serialMidi, parallelMidi));
+                }
+
+                // changing the connections rebuilds the schedule
+                for (auto* graph : { &serial, &parallel })
+                    graph->disconnectNode (AudioProcessorGraph::NodeID (10));
+
+                AudioBuffer<float> serialAudio (2, blockSize), parallelAudio (2, blockSize);
+                MidiBuffer serialMidi, parallelMidi;
+                fillBlock (serialAudio, serialMidi, 0);
+                fillBlock (parallelAudio, parallelMidi, 0);
+
+                serial.processBlock (serialAudio, serialMidi);
+                parallel.processBlock (parallelAudio, parallelMidi);
+
+                expect (buffersAreIdentical (serialAudio, parallelAudio));
+                expect (midiBuffersAreIdentical (serialMidi, parallelMidi));
+            }
+        }
+
+        beginTest ("Parallel rendering with double precision");
+        {
+            AudioProcessorGraph serial, parallel;
+            parallel.setParallelRendering (2);
+
+            for (auto* graph : { &serial, &parallel })
+            {
+                graph->setProcessingPrecision (AudioProcessor::doublePrecision);
+                createBranchingGraph (*graph, 8, 0);
+            }
+
+            for (int block = 0; block < 10; ++block)
+            {
+                AudioBuffer<float> input (2, blockSize);
+                MidiBuffer serialMidi, parallelMidi;
+                fillBlock (input, serialMidi, block);
+                fillBlock (input, parallelMidi, block);
+
+                AudioBuffer<double> serialAudio, parallelAudio;
+                serialAudio.makeCopyOf (input);
+                parallelAudio.makeCopyOf (input);
+
+                serial.processBlock (serialAudio, serialMidi);
+                parallel.processBlock (parallelAudio, parallelMidi);
+
+                expect (buffersAreIdentical (serialAudio, parallelAudio));
+            }
+        }
+
+        beginTest ("Editing connections doesn't take the callback lock");
+        {
+            AudioProcessorGraph graph;
+            createBranchingGraph (graph, 4, 0);
+
+            // another thread holds the callback lock, as a host does while calling processBlock()
+            struct LockHolder  : public Thread
+            {
+                LockHolder (AudioProcessorGraph& g) : Thread ("Lock holder"), graph (g) {}
+
+                void run() override
+                {
+                    const ScopedLock sl (graph.getCallbackLock());
+                    locked.signal();
+                    finished.wait (5000);
+                }
+
+                AudioProcessorGraph& graph;
+                WaitableEvent locked, finished;
+            };
+
+            LockHolder holder (graph);
+            holder.startThread();
+            holder.locked.wait();
+
+            const auto start = Time::getMillisecondCounterHiRes();
+            const AudioProcessorGraph::Connection connection { { AudioProcessorGraph::NodeID (10), 0 },
+                                                               { AudioProcessorGraph::NodeID (13), 0 } };
+
+            for (int i = 0; i < 10; ++i)
+            {
+                expect (graph.addConnection (connection));
+                expect (graph.removeConnection (connection));
+            }
+
+            expectLessThan (Time::getMillisecondCounterHiRes() - start, 2500.0);
+
+            holder.finished.signal();
+            holder.stopThread (1000);
+        }
+
+        beginTest ("Editing connections while rendering");
+        {
+            using IO = AudioProcessorGraph::AudioGraphIOProcessor;
+
+            AudioProcessorGraph graph;
+            graph.setPlayConfigDetails (2, 2, 44100.0, blockSize);
+            auto audioIn  = graph.addNode (std::make_unique<IO> (IO::audioInputNode))->nodeID;
+            auto audioOut = graph.addNode (std::make_unique<IO> (IO::audioOutputNode))->nodeID;
+            graph.prepareToPlay (44100.0, blockSize);
+
+            // The audio thread checks that every block uses either the old or the new sequence
+            struct AudioThread  : public Thread
+            {
+                AudioThread (AudioProcessorGraph& g) : Thread ("Audio"), graph (g) {}
+
+                void run() override
+                {
+                    AudioBuffer<float> audio (2, blockSize);
+                    MidiBuffer midi;
+
+                    while (! threadShouldExit())
+                    {
+                        for (int ch = 0; ch < 2; ++ch)
+                            audio.clear (ch, 0, blockSize);
+
+                        audio.setSample (0, 0, 1.0f);
+                        graph.processBlock (audio, midi);
+
+                        const auto out = audio.getSample (0, 0);
+
+                        if (out != 0.0f && out != 1.0f)
+                            ++numBadBlocks;
+
+                        ++numBlocks;
+                    }
+                }
+
+                AudioProcessorGraph& graph;
+                std::atomic<int> numBlocks { 0 }, numBadBlocks { 0 };
+            };
+
+            AudioThread audioThread (graph);
+            audioThread.startThread();
+
+            const AudioProcessorGraph::Connection connection { { audioIn, 0 }, { audioOut, 0 } };
+
+            for (int i = 0; i < 100; ++i)
+            {
+                expect (graph.addConnection (connection));
+                Thread::yield();
+                expect (graph.removeConnection (connection));
+                Thread::yield();
+            }
+
+            expect (graph.addConnection (connection));
+
+            for (auto target = audioThread.numBlocks.load() + 3; audioThread.numBlocks.load() < target;)
+                Thread::yield();
+
+            audioThread.stopThread (1000);
+            expectEquals (audioThread.numBadBlocks.load(), 0);
+
+            // the last sequence must have been picked up
+            AudioBuffer<float> audio (2, blockSize);
+            audio.clear();
+            audio.setSample (0, 0, 1.0f);
+            MidiBuffer midi;
+            graph.processBlock (audio, midi);
+            expectEquals (audio.getSample (0, 0), 1.0f);
+        }
+
+        beginTest ("Removed nodes are destroyed");
+        {
+            struct ReportingProcessor  : public GainProcessor
+            {
+                explicit ReportingProcessor (bool& flag) : GainProcessor (1.0f, 0), destroyed (flag) {}
+                ~ReportingProcessor() override      { destroyed = true; }
+
+                using AudioProcessor::processBlock;
+
+                bool& destroyed;
+            };
+
+            // The graph may or may not be played after the node is removed
+            for (auto isPlayed : { true, false })
+            {
+                AudioProcessorGraph graph;
+                createBranchingGraph (graph, 2, 0);
+
+                bool destroyed = false;
+                auto nodeID = graph.addNode (std::make_unique<ReportingProcessor> (destroyed))->nodeID;
+
+                AudioBuffer<float> audio (2, blockSize);
+                MidiBuffer midi;
+                graph.processBlock (audio, midi);
+
+                // the sequence being rendered still uses the node
+                expect (graph.removeNode (nodeID));
+                expect (! destroyed);
+
+                if (isPlayed)
+                    graph.processBlock (audio, midi);
+
+               #if JUCE_MODAL_LOOPS_PERMITTED
+                for (int i = 0; i < 50 && ! destroyed; ++i)
+                    MessageManager::getInstance()->runDispatchLoopUntil (20);
+
+                expect (destroyed);
+               #endif
+            }
+        }
+
+        beginTest ("Incremental edits give the same result as building from scratch");
+        {
+            using NodeID = AudioProcessorGraph::NodeID;
+            using Connection = AudioProcessorGraph::Connection;
+
+            constexpr int numBranches = 12;
+            Random random (4321);
+
+            // A random order of the branches, in which each connection between them goes forwards
+            Array<int> branchOrder;
+
+            for (int i = 0; i < numBranches; ++i)
+                branchOrder.insert (random.nextInt (i + 1), i);
+
+            for (int branch = 3; branch < numBranches; branch += 4)
+                if (branchOrder.indexOf (branch) < branchOrder.indexOf (branch - 1))
+                    branchOrder.swap (branchOrder.indexOf (branch), branchOrder.indexOf (branch - 1));
+
+            Array<Connection> candidates;
+
+            for (int i = 0; i < numBranches; ++i)
+                for (int j = i + 1; j < numBranches; ++j)
+                    candidates.add ({ { NodeID ((uint32) (11 + 2 * branchOrder[i])), random.nextInt (2) },
+                                      { NodeID ((uint32) (10 + 2 * branchOrder[j])), random.nextInt (2) } });
+
+            // The edits move the nodes around in the order of the graph they're made to...
+            AudioProcessorGraph edited;
+            createBranchingGraph (edited, numBranches, 0);
+
+            for (int i = 0; i < 200; ++i)
+            {
+                auto& c = candidates.getReference (random.nextInt (candidates.size()));
+
+                if (! edited.removeConnection (c))
+                    expect (edited.addConnection (c));
+            }
+
+            // ... whereas the nodes of this one are added in an order which never needs to change
+            auto compareWithNewGraph = [&]
+            {
+                AudioProcessorGraph fresh;
+                createBranchingGraph (fresh, numBranches, 0, branchOrder);
+
+                for (auto& c : candidates)
+                    if (edited.isConnected (c))
+                        fresh.addConnection (c);
+
+                for (auto* graph : { &edited, &fresh })
+                    graph->reset();
+
+                for (int block = 0; block < 4; ++block)
+                {
+                    AudioBuffer<float> editedAudio (2, blockSize), freshAudio (2, blockSize);
+                    MidiBuffer editedMidi, freshMidi;
+                    fillBlock (editedAudio, editedMidi, block);
+                    fillBlock (freshAudio, freshMidi, block);
+
+                    edited.processBlock (editedAudio, editedMidi);
+                    fresh.processBlock (freshAudio, freshMidi);
+
+                    for (int ch = 0; ch < 2; ++ch)
+                        for (int i = 0; i < blockSize; ++i)
+                            expectWithinAbsoluteError (editedAudio.getSample (ch, i), freshAudio.getSample (ch, i), 1.0e-5f);
+
+                    expectEquals (editedMidi.getNumEvents(), freshMidi.getNumEvents());
+                }
+
+                expectEquals (edited.getLatencySamples(), fresh.getLatencySamples());
+            };
+
+            compareWithNewGraph();
+
+            // a feedback loop has no proper order, but must still be rendered...
+            const Connection feedback { { NodeID (11 + 2 * (uint32) branchOrder.getLast()), 0 },
+                                        { NodeID (10 + 2 * (uint32) branchOrder.getFirst()), 0 } };
+            expect (edited.addConnection (feedback));
+
+            AudioBuffer<float> audio (2, blockSize);
+            MidiBuffer midi;
+            fillBlock (audio, midi, 0);
+            edited.processBlock (audio, midi);
+
+            // ... and the order must recover once it's removed
+            expect (edited.removeConnection (feedback));
+            compareWithNewGraph();
+        }
+
+        beginTest ("Buffers are reused");
+        {
+            using IO = AudioProcessorGraph::AudioGraphIOProcessor;
+            using NodeID = AudioProcessorGraph::NodeID;
+
+            constexpr int numBranches = 40;
+            auto getGain    = [] (int branch)  { return 0.1f + 0.02f * (float) branch; };
+            auto getLatency = [] (int branch)  { return 5 * (branch % 4); };
+            auto hasDirectOutput = [] (int branch)  { return branch % 3 == 0; };
+
+            for (auto numWorkers : { 0, 2 })
+            {
+                AudioProcessorGraph graph;
+                graph.setParallelRendering (numWorkers);
+                graph.setPlayConfigDetails (2, 2, 44100.0, blockSize);
+
+                // The nodes are added a layer at a time, which isn't the best order to render them in
+                auto audioIn = graph.addNode (std::make_unique<IO> (IO::audioInputNode))->nodeID;
+
+                for (int branch = 0; branch < numBranches; ++branch)
+                    graph.addNode (std::make_unique<GainProcessor> (getGain (branch), getLatency (branch)), NodeID ((uint32) (10 + 2 * branch)));
+
+                for (int branch = 0; branch < numBranches; ++branch)
+                    graph.addNode (std::make_unique<GainProcessor> (0.5f, 0), NodeID ((uint32) (11 + 2 * branch)));
+
+                auto audioOut = graph.addNode (std::make_unique<IO> (IO::audioOutputNode))->nodeID;
+
+                for (int branch = 0; branch < numBranches; ++branch)
+                {
+                    NodeID first ((uint32) (10 + 2 * branch)), second ((uint32) (11 + 2 * branch));
+
+                    for (int ch = 0; ch < 2; ++ch)
+                    {
+                        graph.addConnection ({ { audioIn, ch }, { first, ch } });
+                        graph.addConnection ({ { first, ch }, { second, ch } });
+                        graph.addConnection ({ { second, ch }, { audioOut, ch } });
+
+                        if (hasDirectOutput (branch))
+                            graph.addConnection ({ { first, ch }, { audioOut, ch } });
+                    }
+                }
+
+                graph.prepareToPlay (44100.0, blockSize);
+
+                auto stats = graph.getBufferStatistics();
+                expectLessThan (stats.numAudioBuffers, 12);
+                expectGreaterThan (stats.numAudioBuffersWithoutReuse, 2 * numBranches);
+                expectEquals (stats.numMidiBuffers, 1);
+
+                if (numWorkers == 0)
+                    logMessage ("A graph with " + String (2 * numBranches) + " stereo nodes uses " + String (stats.numAudioBuffers)
+                                + " audio buffers, rather than " + String (stats.numAudioBuffersWithoutReuse));
+
+                // Every branch has to be delayed to line up with the one with the most latency
+                constexpr int numBlocks = 2;
+                AudioBuffer<float> input (2, numBlocks * blockSize);
+                MidiBuffer midi;
+                fillBlock (input, midi, 1);
+
+                const auto maxLatency = getLatency (3);
+
+                for (int block = 0; block < numBlocks; ++block)
+                {
+                    AudioBuffer<float> audio (2, blockSize);
+
+                    for (int ch = 0; ch < 2; ++ch)
+                        audio.copyFrom (ch, 0, input, ch, block * blockSize, blockSize);
+
+                    graph.processBlock (audio, midi);
+
+                    for (int ch = 0; ch < 2; ++ch)
+                    {
+                        for (int i = 0; i < blockSize; ++i)
+                        {
+                            auto expected = 0.0f;
+
+                            for (int branch = 0; branch < numBranches; ++branch)
+                            {
+                                auto index = block * blockSize + i - (maxLatency - getLatency (branch));
+
+                                if (index >= 0)
+                                    expected += input.getSample (ch, index) * getGain (branch) * (hasDirectOutput (branch) ? 1.5f : 0.5f);
+                            }
+
+                            expectWithinAbsoluteError (audio.getSample (ch, i), expected, 1.0e-4f);
+                        }
+                    }
+                }
+            }
+        }
+
+        beginTest ("Nodes receive sample-accurate automation");
+        {
+            using IO = AudioProcessorGraph::AudioGraphIOProcessor;
+
+            AudioProcessorGraph graph;
+            graph.setPlayConfigDetails (2, 2, 44100.0, blockSize);
+
+            auto audioIn  = graph.addNode (std::make_unique<IO> (IO::audioInputNode))->nodeID;
+            auto gainNode = graph.addNode (std::make_unique<AutomatedGainProcessor>());
+            auto audioOut = graph.addNode (std::make_unique<IO> (IO::audioOutputNode))->nodeID;
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                graph.addConnection ({ { audioIn, ch }, { gainNode->nodeID, ch } });
+                graph.addConnection ({ { gainNode->nodeID, ch }, { audioOut, ch } });
+            }
+
+            graph.prepareToPlay (44100.0, blockSize);
+            gainNode->ensureParameterAutomationSize (16);
+
+            // The larger blocks have to be rendered in chunks
+            for (auto numSamples : { blockSize, 2 * blockSize + 100 })
+            {
+                MidiBuffer midi;
+                AudioBuffer<float> audio (2, numSamples);
+                ParameterAutomationBuffer expected;
+
+                for (auto* automation : { &gainNode->getParameterAutomation(), &expected })
+                {
+                    automation->addPoint (0, 0.5f, 100, 1.0f);
+                    automation->addPoint (0, 0.5f, numSamples / 2, 0.0f);
+                    automation->addPoint (0, 0.5f, numSamples - 50, 0.25f);
+                }
+
+                HeapBlock<float> expectedGains ((size_t) numSamples);
+                expected.getValues (0, expectedGains, numSamples);
+
+                for (auto isAutomated : { true, false })
+                {
+                    for (int ch = 0; ch < 2; ++ch)
+                        FloatVectorOperations::fill (audio.getWritePointer (ch), 1.0f, numSamples);
+
+                    graph.processBlock (audio, midi);
+
+                    // once the block is done, the points are gone and the parameter's own value is used
+                    for (int ch = 0; ch < 2; ++ch)
+                        for (int i = 0; i < numSamples; ++i)
+                            expectWithinAbsoluteError (audio.getSample (ch, i), isAutomated ? expectedGains[i] : 0.5f, 1.0e-5f);
+
+                    expect (gainNode->getParameterAutomation().isEmpty());
+                }
+            }
+        }
+    }
+
+private:
+    friend class AudioProcessorGraphBenchmark;
+
+    static constexpr int blockSize = 512;
+
+    //==============================================================================
+    // A stereo processor with some state, which passes its midi through and adds
+    // a note to it, so that any change of the processing order would be noticed
+    class TestProcessor  : public AudioProcessor
+    {
+    public:
+        TestProcessor (int seedToUse, int latency, int amountOfWork)
+            : AudioProcessor (BusesProperties().withInput  ("Input",  AudioChannelSet::stereo())
+                                               .withOutput ("Output", AudioChannelSet::stereo())),
+              seed (seedToUse), work (amountOfWork)
+        {
+            setLatencySamples (latency);
+        }
+
+        const String getName() const override                           { return "Test"; }
+        void prepareToPlay (double, int) override                        { state[0] = state[1] = 0.0f; }
+        void releaseResources() override                                 {}
+        void reset() override                                            { state[0] = state[1] = 0.0f; }
+        double getTailLengthSeconds() const override                     { return 0.0; }
+        bool acceptsMidi() const override                                { return true; }
+        bool producesMidi() const override                               { return true; }
+        AudioProcessorEditor* createEditor() override                    { return nullptr; }
+        bool hasEditor() const override                                  { return false; }
+        int getNumPrograms() override                                    { return 1; }
+        int getCurrentProgram() override                                 { return 0; }
+        void setCurrentProgram (int) override                            {}
+        const String getProgramName (int) override                       { return {}; }
+        void changeProgramName (int, const String&) override             {}
+        void getStateInformation (MemoryBlock&) override                 {}
+        void setStateInformation (const void*, int) override             {}
+
+        void processBlock (AudioBuffer<float>& buffer, MidiBuffer& midi) override
+        {
+            const auto coefficient = 0.1f + 0.8f * (float) (seed % 10) / 10.0f;
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            {
+                auto* samples = buffer.getWritePointer (ch);
+
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                {
+                    auto x = samples[i];
+
+                    for (int w = 0; w < work; ++w)
+                        x = 0.5f * (x + std::sin (x));
+
+                    state[ch] += coefficient * (x - state[ch]);
+                    samples[i] = state[ch] * (ch == 0 ? 0.9f : -0.7f);
+                }
+            }
+
+            midi.addEvent (MidiMessage::noteOn (1 + seed % 16, seed % 128, (uint8) 100), seed % buffer.getNumSamples());
+        }
+
+        using AudioProcessor::processBlock;
+
+    private:
+        const int seed, work;
+        float state[2] = {};
+    };
+
+    // Just applies a gain, so that the output of a graph is easy to work out,
+    // and reports some latency without actually delaying anything
+    class GainProcessor  : public TestProcessor
+    {
+    public:
+        GainProcessor (float gainToUse, int latency)
+            : TestProcessor (0, latency, 0), gain (gainToUse)
+        {}
+
+        void processBlock (AudioBuffer<float>& buffer, MidiBuffer&) override     { buffer.applyGain (gain); }
+
+        using AudioProcessor::processBlock;
+
+    private:
+        const float gain;
+    };
+
+    // Applies the gain parameter's automation curve when there is one, so that a
+    // test can see exactly what the processor was given
+    class AutomatedGainProcessor  : public TestProcessor
+    {
+    public:
+        AutomatedGainProcessor()
+            : TestProcessor (0, 0, 0)
+        {
+            addParameter (gain = new AudioParameterFloat ("gain", "Gain", 0.0f, 1.0f, 0.5f));
+        }
+
+        void prepareToPlay (double, int maximumExpectedSamplesPerBlock) override
+        {
+            gains.allocate ((size_t) maximumExpectedSamplesPerBlock, true);
+        }
+
+        void processBlock (AudioBuffer<float>& buffer, MidiBuffer&) override
+        {
+            auto numSamples = buffer.getNumSamples();
+            auto* automation = getParameterAutomation();
+
+            if (automation == nullptr || ! automation->getValues (0, gains, numSamples))
+                FloatVectorOperations::fill (gains, gain->get(), numSamples);
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                FloatVectorOperations::multiply (buffer.getWritePointer (ch), gains, numSamples);
+        }
+
+        using AudioProcessor::processBlock;
+
+    private:
+        AudioParameterFloat* gain;
+        HeapBlock<float> gains;
+    };
+
+    //==============================================================================
+    // Input -> many branches of two processors -> output, with some connections
+    // between the branches, and some latencies to compensate. The nodes are added
+    // in the order of the branches given, or of their indexes.
+    static void createBranchingGraph (AudioProcessorGraph& graph, int numBranches, int work,
+                                      const Array<int>& branchOrder = {})
+    {
+        using IO = AudioProcessorGraph::AudioGraphIOProcessor;
+        using NodeID = AudioProcessorGraph::NodeID;
+
+        graph.setPlayConfigDetails (2, 2, 44100.0, blockSize);
+
+        auto audioIn  = graph.addNode (std::make_unique<IO> (IO::audioInputNode))->nodeID;
+        auto midiIn   = graph.addNode (std::make_unique<IO> (IO::midiInputNode))->nodeID;
+
+        for (int i = 0; i < numBranches; ++i)
+        {
+            auto branch = branchOrder.isEmpty() ? i : branchOrder[i];
+
+            graph.addNode (std::make_unique<TestProcessor> (2 * branch, branch % 5 == 0 ? 3 * branch : 0, work),
+                           NodeID ((uint32) (10 + 2 * branch)));
+            graph.addNode (std::make_unique<TestProcessor> (2 * branch + 1, 0, work),
+                           NodeID ((uint32) (11 + 2 * branch)));
+        }
+
+        auto audioOut = graph.addNode (std::make_unique<IO> (IO::audioOutputNode))->nodeID;
+        auto midiOut  = graph.addNode (std::make_unique<IO> (IO::midiOutputNode))->nodeID;
+
+        const auto midi = AudioProcessorGraph::midiChannelIndex;
+
+        for (int branch = 0; branch < numBranches; ++branch)
+        {
+            NodeID first ((uint32) (10 + 2 * branch)), second ((uint32) (11 + 2 * branch));
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                graph.addConnection ({ { audioIn, ch }, { first, ch } });
+                graph.addConnection ({ { first, ch }, { second, ch } });
+                graph.addConnection ({ { second, ch }, { audioOut, ch } });
+            }
+
+            if (branch % 3 == 0)
+            {
+                graph.addConnection ({ { midiIn, midi }, { first, midi } });
+                graph.addConnection ({ { first, midi }, { second, midi } });
+                graph.addConnection ({ { second, midi }, { midiOut, midi } });
+            }
+
+            // a connection to the previous branch, crossing the channels
+            if (branch % 4 == 3)
+                graph.addConnection ({ { NodeID ((uint32) (8 + 2 * branch)), 0 }, { second, 1 } });
+        }
+
+        graph.prepareToPlay (44100.0, blockSize);
+    }
+
+    static void fillBlock (AudioBuffer<float>& audio, MidiBuffer& midi, int seed)
+    {
+        Random random (seed);
+
+        for (int ch = 0; ch < audio.getNumChannels(); ++ch)
+            for (int i = 0; i < audio.getNumSamples(); ++i)
+                audio.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+        midi.clear();
+        midi.addEvent (MidiMessage::controllerEvent (1, 7, seed % 128), 0);
+    }
+
+    template <typename FloatType>
+    static bool buffersAreIdentical (const AudioBuffer<FloatType>& a, const AudioBuffer<FloatType>& b)
+    {
+        for (int ch = 0; ch < a.getNumChannels(); ++ch)
+            if (std::memcmp (a.getReadPointer (ch), b.getReadPointer (ch), sizeof (FloatType) * (size_t) a.getNumSamples()) != 0)
+                return false;
+
+        return true;
+    }
+
+    static bool midiBuffersAreIdentical (const MidiBuffer& a, const MidiBuffer& b)
+    {
+        if (a.getNumEvents() != b.getNumEvents())
+            return false;
+
+        for (auto itA = a.begin(), itB = b.begin(); itA != a.end(); ++itA, ++itB)
+        {
+            const auto eventA = *itA, eventB = *itB;
+
+            if (eventA.samplePosition != eventB.samplePosition
+                 || eventA.numBytes != eventB.numBytes
+                 || std::memcmp (eventA.data, eventB.data, (size_t) eventA.numBytes) != 0)
+                return false;
+        }
+
+        return true;
+    }
+};
+
+static AudioProcessorGraphTests audioProcessorGraphTests;
+
+//==============================================================================
+class AudioProcessorGraphBenchmark  : public UnitTest
+{
+public:
+    AudioProcessorGraphBenchmark()
+        : UnitTest ("AudioProcessorGraph benchmark", UnitTestCategories::benchmarks)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Edit latency");
+
+        auto message = String ("Average time to rebuild after adding or removing a connection:");
+
+        for (auto numNodes : { 50, 100, 200, 500 })
+        {
+            AudioProcessorGraph graph;
+            AudioProcessorGraphTests::createBranchingGraph (graph, numNodes / 2, 0);
+
+            const AudioProcessorGraph::Connection connection { { AudioProcessorGraph::NodeID ((uint32) numNodes / 2), 0 },
+                                                               { AudioProcessorGraph::NodeID ((uint32) numNodes / 2 + 3), 1 } };
+            constexpr int numEdits = 10;
+            auto start = Time::getHighResolutionTicks();
+
+            for (int i = 0; i < numEdits; ++i)
+            {
+                graph.addConnection (connection);
+                graph.removeConnection (connection);
+            }
+
+            auto elapsed = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) * 1000.0;
+            message << " " << numNodes << " nodes " << String (elapsed / (2 * numEdits), 3) << " ms" << (numNodes < 500 ? "," : "");
+        }
+
+        logMessage (message);
+    }
+};
+
+static AudioProcessorGraphBenchmark audioProcessorGraphBenchmark;
+
+#endif
+
 } // namespace juce
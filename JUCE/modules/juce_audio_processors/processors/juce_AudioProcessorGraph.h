@@ -37,6 +37,10 @@ namespace juce
     added, you can connect any of their input or output channels to other
     nodes using addConnection().
 
+    Whenever the nodes or connections change, the graph rebuilds its rendering
+    sequence on the message thread, and hands it over to the audio thread without
+    blocking it, so a graph can be edited while it's playing.
+
     To play back a graph through an audio device, you might want to use an
     AudioProcessorPlayer object.
 
@@ -124,6 +128,24 @@ public:
         /** Tell this node to bypass processing. */
         void setBypassed (bool shouldBeBypassed) noexcept;
 
+        //==============================================================================
+        /** Returns the buffer that holds sample-accurate automation for this node's processor.
+
+            A host can add points to this on the audio thread, just before calling the
+            graph's processBlock(), and the processor will see them through
+            AudioProcessor::getParameterAutomation(). The sample positions are relative to
+            the start of the graph's block, and the graph clears the buffer once the node
+            has been processed. To avoid allocating on the audio thread, call
+            ensureParameterAutomationSize() beforehand.
+        */
+        ParameterAutomationBuffer& getParameterAutomation() noexcept    { return parameterAutomation; }
+
+        /** Preallocates space for the given number of automation points, both in the
+            buffer returned by getParameterAutomation() and in the copy that the graph
+            uses when it has to process a block in several chunks.
+        */
+        void ensureParameterAutomationSize (int numPointsToAllocate);
+
         //==============================================================================
         /** A convenient typedef for referring to a pointer to a node object. */
         using Ptr = ReferenceCountedObjectPtr<Node>;
@@ -133,6 +155,8 @@ public:
         friend class AudioProcessorGraph;
         template <typename Float>
         friend struct GraphRenderSequence;
+        template <typename RenderSequence>
+        friend struct RenderSequenceBuilder;
 
         struct Connection
         {
@@ -144,8 +168,10 @@ public:
 
         std::unique_ptr<AudioProcessor> processor;
         Array<Connection> inputs, outputs;
+        int orderIndex = 0;
         bool isPrepared = false;
         std::atomic<bool> bypassed { false };
+        ParameterAutomationBuffer parameterAutomation, parameterAutomationChunk;
 
         Node (NodeID, std::unique_ptr<AudioProcessor>) noexcept;
 
@@ -388,6 +414,56 @@ public:
     void reset() override;
     void setNonRealtime (bool) noexcept override;
 
+    //==============================================================================
+    /** Enables rendering the graph on a pool of worker threads.
+
+        The nodes are still rendered in an order which respects their connections, but
+        nodes which don't depend on each other, like the ones in independent branches of
+        the graph, can be processed at the same time on different threads. The output
+        is identical to the one of the single-threaded renderer.
+
+        The audio thread takes part in the rendering, so numWorkerThreads should be
+        one less than the number of cores you want to use, and 0 disables parallel
+        rendering. The processors of the graph must be happy to be called from the
+        worker threads, and their play heads may be called by several threads at once.
+
+        This creates and destroys threads, so shouldn't be called from the audio thread.
+    */
+    void setParallelRendering (int numWorkerThreads);
+
+    /** Returns true if setParallelRendering() has enabled some worker threads.
+        @see setParallelRendering
+    */
+    bool isParallelRenderingEnabled() const noexcept;
+
+    //==============================================================================
+    /** Describes the buffers which the graph uses to pass audio and MIDI between its nodes.
+        @see getBufferStatistics
+    */
+    struct BufferStatistics
+    {
+        /** The number of single-channel audio buffers, each one block long. */
+        int numAudioBuffers = 0;
+
+        /** The number of MIDI buffers. */
+        int numMidiBuffers = 0;
+
+        /** The number of audio buffers which would be needed if none of them were reused. */
+        int numAudioBuffersWithoutReuse = 0;
+    };
+
+    /** Returns the number of buffers needed to render the graph.
+
+        A buffer is reused as soon as the data it holds isn't needed any more, and the
+        nodes are rendered in an order which keeps the number of buffers in use low, so
+        numAudioBuffers is the peak number of channels which the graph holds at any one
+        time rather than the total number of channels in the graph.
+
+        The statistics are updated whenever the graph is prepared or its connections
+        change, and this should be called on the message thread.
+    */
+    BufferStatistics getBufferStatistics() const noexcept   { return bufferStatistics; }
+
     double getTailLengthSeconds() const override;
     bool acceptsMidi() const override;
     bool producesMidi() const override;
@@ -423,14 +499,17 @@ private:
 
     //==============================================================================
     ReferenceCountedArray<Node> nodes;
+    Array<Node*> orderedNodes;
+    bool isNodeOrderValid = true;
     NodeID lastNodeID = {};
 
     struct RenderSequenceFloat;
     struct RenderSequenceDouble;
-    std::unique_ptr<RenderSequenceFloat> renderSequenceFloat;
-    std::unique_ptr<RenderSequenceDouble> renderSequenceDouble;
+    class RenderSequenceExchange;
+    std::unique_ptr<RenderSequenceExchange> renderSequenceExchange;
 
     PrepareSettings prepareSettings;
+    BufferStatistics bufferStatistics;
 
     friend class AudioGraphIOProcessor;
 
@@ -446,8 +525,15 @@ private:
     bool isAnInputTo (Node& src, Node& dst, int recursionCheck) const noexcept;
     bool canConnect (Node* src, int sourceChannel, Node* dest, int destChannel) const noexcept;
     bool isLegal (Node* src, int sourceChannel, Node* dest, int destChannel) const noexcept;
+    bool removeConnectionWithoutUpdate (const Connection&);
+    bool removeNodeConnections (Node&);
+    void updateNodeOrderForNewConnection (Node& source, Node& dest);
+    const Array<Node*>& getOrderedNodes();
     static void getNodeConnections (Node&, std::vector<Connection>&);
 
+    template <typename RenderSequence>
+    friend struct RenderSequenceBuilder;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioProcessorGraph)
 };
 
@@ -0,0 +1,363 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+ParameterAutomationBuffer::ParameterAutomationBuffer() noexcept {}
+ParameterAutomationBuffer::~ParameterAutomationBuffer() {}
+
+void ParameterAutomationBuffer::clear() noexcept
+{
+    points.clearQuick();
+}
+
+void ParameterAutomationBuffer::ensureSize (int numPointsToAllocate)
+{
+    points.ensureStorageAllocated (numPointsToAllocate);
+}
+
+void ParameterAutomationBuffer::addPoint (int parameterIndex, float valueAtStartOfBlock, int samplePosition, float newValue)
+{
+    jassert (parameterIndex >= 0);
+
+    if (findFirstPoint (parameterIndex) < 0)
+        insertPoint ({ parameterIndex, startPosition, valueAtStartOfBlock });
+
+    insertPoint ({ parameterIndex, jmax (0, samplePosition), newValue });
+}
+
+void ParameterAutomationBuffer::insertPoint (Point newPoint)
+{
+    auto isBefore = [] (const Point& a, const Point& b) noexcept
+    {
+        return a.parameterIndex < b.parameterIndex
+            || (a.parameterIndex == b.parameterIndex && a.samplePosition < b.samplePosition);
+    };
+
+    // Hosts nearly always deliver points in order, so check the end first
+    if (points.isEmpty() || isBefore (points.getReference (points.size() - 1), newPoint))
+    {
+        points.add (newPoint);
+        return;
+    }
+
+    int start = 0, end = points.size();
+
+    while (start < end)
+    {
+        auto mid = (start + end) / 2;
+
+        if (isBefore (points.getReference (mid), newPoint))
+            start = mid + 1;
+        else
+            end = mid;
+    }
+
+    auto& existing = points.getReference (start);
+
+    if (existing.parameterIndex == newPoint.parameterIndex && existing.samplePosition == newPoint.samplePosition)
+        existing.value = newPoint.value;
+    else
+        points.insert (start, newPoint);
+}
+
+int ParameterAutomationBuffer::findFirstPoint (int parameterIndex) const noexcept
+{
+    int start = 0, end = points.size();
+
+    while (start < end)
+    {
+        auto mid = (start + end) / 2;
+
+        if (points.getReference (mid).parameterIndex < parameterIndex)
+            start = mid + 1;
+        else
+            end = mid;
+    }
+
+    if (start < points.size() && points.getReference (start).parameterIndex == parameterIndex)
+        return start;
+
+    return -1;
+}
+
+int ParameterAutomationBuffer::findEndOfCurve (int firstPoint) const noexcept
+{
+    auto parameterIndex = points.getReference (firstPoint).parameterIndex;
+    auto end = firstPoint + 1;
+
+    while (end < points.size() && points.getReference (end).parameterIndex == parameterIndex)
+        ++end;
+
+    return end;
+}
+
+//==============================================================================
+bool ParameterAutomationBuffer::isAutomated (int parameterIndex) const noexcept
+{
+    return findFirstPoint (parameterIndex) >= 0;
+}
+
+int ParameterAutomationBuffer::getNumPoints (int parameterIndex) const noexcept
+{
+    auto first = findFirstPoint (parameterIndex);
+    return first < 0 ? 0 : findEndOfCurve (first) - first - 1;
+}
+
+float ParameterAutomationBuffer::getValueAt (int parameterIndex, int samplePosition, float defaultValue) const noexcept
+{
+    auto first = findFirstPoint (parameterIndex);
+
+    if (first < 0)
+        return defaultValue;
+
+    auto end = findEndOfCurve (first);
+    auto prevPosition = 0;
+    auto prevValue = points.getReference (first).value;
+
+    for (int i = first + 1; i < end; ++i)
+    {
+        auto& p = points.getReference (i);
+
+        if (p.samplePosition == samplePosition)
+            return p.value;
+
+        if (p.samplePosition > samplePosition)
+        {
+            auto slope = (p.value - prevValue) / (float) (p.samplePosition - prevPosition);
+            return prevValue + slope * (float) (samplePosition - prevPosition);
+        }
+
+        prevPosition = p.samplePosition;
+        prevValue = p.value;
+    }
+
+    return prevValue;
+}
+
+bool ParameterAutomationBuffer::getValues (int parameterIndex, float* destination, int numSamples) const noexcept
+{
+    auto first = findFirstPoint (parameterIndex);
+
+    if (first < 0)
+        return false;
+
+    auto end = findEndOfCurve (first);
+    auto prevPosition = 0;
+    auto prevValue = points.getReference (first).value;
+    int sample = 0;
+
+    for (int i = first + 1; i < end && sample < numSamples; ++i)
+    {
+        auto& p = points.getReference (i);
+
+        if (p.samplePosition > prevPosition)
+        {
+            auto slope = (p.value - prevValue) / (float) (p.samplePosition - prevPosition);
+            auto rampEnd = jmin (p.samplePosition, numSamples);
+
+            for (; sample < rampEnd; ++sample)
+                destination[sample] = prevValue + slope * (float) (sample - prevPosition);
+        }
+
+        prevPosition = p.samplePosition;
+        prevValue = p.value;
+    }
+
+    for (; sample < numSamples; ++sample)
+        destination[sample] = prevValue;
+
+    return true;
+}
+
+//==============================================================================
+void ParameterAutomationBuffer::copyBlockFrom (const ParameterAutomationBuffer& source, int startSample, int numSamples)
+{
+    jassert (&source != this);
+
+    points.clearQuick();
+
+    for (int first = 0; first < source.points.size();)
+    {
+        auto end = source.findEndOfCurve (first);
+        auto parameterIndex = source.points.getReference (first).parameterIndex;
+
+        points.add ({ parameterIndex, startPosition, source.getValueAt (parameterIndex, startSample, 0.0f) });
+
+        for (int i = first + 1; i < end; ++i)
+        {
+            auto& p = source.points.getReference (i);
+
+            if (p.samplePosition <= startSample)
+                continue;
+
+            // the first point beyond the range is kept too, so that the last ramp has the right slope
+            points.add ({ parameterIndex, p.samplePosition - startSample, p.value });
+
+            if (p.samplePosition >= startSample + numSamples)
+                break;
+        }
+
+        first = end;
+    }
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ParameterAutomationBufferTests  : public UnitTest
+{
+public:
+    ParameterAutomationBufferTests()
+        : UnitTest ("ParameterAutomationBuffer", UnitTestCategories::audioProcessorParameters)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Parameters without points aren't automated");
+        {
+            ParameterAutomationBuffer buffer;
+            expect (buffer.isEmpty());
+
+            buffer.addPoint (2, 0.0f, 10, 1.0f);
+            expect (! buffer.isEmpty());
+            expect (buffer.isAutomated (2));
+            expect (! buffer.isAutomated (1));
+            expect (! buffer.isAutomated (3));
+
+            float values[] = { -1.0f, -1.0f };
+            expect (! buffer.getValues (1, values, 2));
+            expectEquals (values[0], -1.0f);
+            expectEquals (buffer.getValueAt (1, 0, 0.25f), 0.25f);
+
+            buffer.clear();
+            expect (buffer.isEmpty());
+            expect (! buffer.isAutomated (2));
+        }
+
+        beginTest ("Values ramp between points and hold after the last one");
+        {
+            ParameterAutomationBuffer buffer;
+            buffer.addPoint (3, 0.0f, 100, 1.0f);
+            buffer.addPoint (3, 0.0f, 200, 0.5f);
+            expectEquals (buffer.getNumPoints (3), 2);
+
+            HeapBlock<float> values (300);
+            expect (buffer.getValues (3, values, 300));
+
+            expectWithinAbsoluteError (values[0], 0.0f, 1.0e-6f);
+            expectWithinAbsoluteError (values[50], 0.5f, 1.0e-6f);
+            expectWithinAbsoluteError (values[100], 1.0f, 1.0e-6f);
+            expectWithinAbsoluteError (values[150], 0.75f, 1.0e-6f);
+            expectWithinAbsoluteError (values[200], 0.5f, 1.0e-6f);
+            expectWithinAbsoluteError (values[299], 0.5f, 1.0e-6f);
+
+            for (int i = 0; i < 300; ++i)
+                expectWithinAbsoluteError (buffer.getValueAt (3, i, 0.0f), values[i], 1.0e-6f);
+
+            // a point at the start of the block is a jump
+            buffer.clear();
+            buffer.addPoint (0, 0.2f, 0, 0.8f);
+            expect (buffer.getValues (0, values, 300));
+            expectEquals (values[0], 0.8f);
+            expectEquals (values[299], 0.8f);
+        }
+
+        beginTest ("Points can be added in any order");
+        {
+            ParameterAutomationBuffer inOrder, shuffled;
+
+            inOrder.addPoint (1, 0.5f, 10, 0.0f);
+            inOrder.addPoint (1, 0.5f, 20, 1.0f);
+            inOrder.addPoint (4, 0.1f, 5, 0.3f);
+            inOrder.addPoint (4, 0.1f, 30, 0.9f);
+
+            shuffled.addPoint (4, 0.1f, 30, 0.9f);
+            shuffled.addPoint (1, 0.5f, 20, 0.7f);
+            shuffled.addPoint (4, 0.1f, 5, 0.3f);
+            shuffled.addPoint (1, 0.5f, 10, 0.0f);
+            shuffled.addPoint (1, 0.5f, 20, 1.0f);
+
+            for (auto index : { 1, 4 })
+            {
+                expectEquals (shuffled.getNumPoints (index), 2);
+
+                for (int i = 0; i < 40; ++i)
+                    expectEquals (shuffled.getValueAt (index, i, 0.0f), inOrder.getValueAt (index, i, 0.0f));
+            }
+        }
+
+        beginTest ("Chunks of a block have the same curves as the whole block");
+        {
+            Random random (91);
+            constexpr int blockSize = 1024;
+            HeapBlock<float> whole (blockSize), chunked (blockSize);
+
+            for (int iteration = 0; iteration < 20; ++iteration)
+            {
+                ParameterAutomationBuffer buffer, chunk;
+                buffer.ensureSize (64);
+
+                for (int index = 0; index < 5; ++index)
+                {
+                    if (random.nextBool())
+                        continue;
+
+                    auto startValue = random.nextFloat();
+
+                    for (int n = random.nextInt (8); --n >= 0;)
+                        buffer.addPoint (index, startValue, random.nextInt (blockSize), random.nextFloat());
+                }
+
+                for (int index = 0; index < 5; ++index)
+                {
+                    if (! buffer.isAutomated (index))
+                        continue;
+
+                    expect (buffer.getValues (index, whole, blockSize));
+
+                    for (int start = 0; start < blockSize;)
+                    {
+                        auto numSamples = jmin (blockSize - start, 1 + random.nextInt (300));
+                        chunk.copyBlockFrom (buffer, start, numSamples);
+                        expect (chunk.getValues (index, chunked + start, numSamples));
+                        start += numSamples;
+                    }
+
+                    for (int i = 0; i < blockSize; ++i)
+                        expectWithinAbsoluteError (chunked[i], whole[i], 1.0e-5f);
+                }
+            }
+        }
+    }
+};
+
+static ParameterAutomationBufferTests parameterAutomationBufferTests;
+
+#endif
+
+} // namespace juce
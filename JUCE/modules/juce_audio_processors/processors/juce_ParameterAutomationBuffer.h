@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Holds the sample-accurate automation for an AudioProcessor's parameters
+    during a single call to processBlock().
+
+    A host that knows exactly where in a block a parameter changes can describe
+    each change as a list of points, and the processor can then ask for a
+    per-sample curve instead of only seeing the value at the end of the block.
+    Between points the value ramps linearly, starting from the value the
+    parameter had at the beginning of the block; after the last point it holds
+    that point's value.
+
+    Adding points won't allocate as long as you've called ensureSize() with a
+    large enough number, so the buffer can be filled on the audio thread.
+
+    @see AudioProcessor::getParameterAutomation
+
+    @tags{Audio}
+*/
+class JUCE_API  ParameterAutomationBuffer
+{
+public:
+    //==============================================================================
+    /** Creates an empty buffer. */
+    ParameterAutomationBuffer() noexcept;
+
+    /** Destructor. */
+    ~ParameterAutomationBuffer();
+
+    //==============================================================================
+    /** Removes all points from the buffer, without freeing its storage. */
+    void clear() noexcept;
+
+    /** Preallocates enough space for the given number of points. */
+    void ensureSize (int numPointsToAllocate);
+
+    /** Adds a point to a parameter's curve.
+
+        @param parameterIndex       the index of the parameter, as returned by
+                                    AudioProcessorParameter::getParameterIndex()
+        @param valueAtStartOfBlock  the normalised value the parameter had at the start
+                                    of the block - this is only used for the first point
+                                    added to each parameter
+        @param samplePosition       the position in the block at which the parameter
+                                    reaches the new value
+        @param newValue             the normalised value at that position
+
+        Adding a second point at the same position replaces the first one.
+    */
+    void addPoint (int parameterIndex, float valueAtStartOfBlock, int samplePosition, float newValue);
+
+    //==============================================================================
+    /** Returns true if no parameters are automated during this block. */
+    bool isEmpty() const noexcept                   { return points.isEmpty(); }
+
+    /** Returns true if the given parameter has any points in this block. */
+    bool isAutomated (int parameterIndex) const noexcept;
+
+    /** Returns the number of points that have been added for a parameter. */
+    int getNumPoints (int parameterIndex) const noexcept;
+
+    /** Returns the value of a parameter at a position in the block.
+
+        If the parameter isn't automated, this just returns the default value.
+    */
+    float getValueAt (int parameterIndex, int samplePosition, float defaultValue) const noexcept;
+
+    /** Fills an array with a parameter's value at each sample of the block.
+
+        If the parameter isn't automated, this returns false and leaves the
+        destination untouched, so that you can fall back to the parameter's
+        current value.
+    */
+    bool getValues (int parameterIndex, float* destination, int numSamples) const noexcept;
+
+    //==============================================================================
+    /** Replaces the contents of this buffer with the part of another buffer that
+        covers the given range of samples.
+
+        The resulting curves start at sample 0 of the range and are identical to
+        the corresponding part of the source's curves. This is handy when a block
+        has to be processed in smaller chunks.
+
+        Like addPoint(), this only allocates if ensureSize() hasn't been called with
+        at least as many points as the source holds.
+    */
+    void copyBlockFrom (const ParameterAutomationBuffer& source, int startSample, int numSamples);
+
+private:
+    //==============================================================================
+    // The points are kept sorted by parameter index and then by position. Each
+    // parameter's curve begins with a point at startPosition, which holds the
+    // value at the start of the block.
+    struct Point
+    {
+        int parameterIndex, samplePosition;
+        float value;
+    };
+
+    static constexpr int startPosition = -1;
+
+    Array<Point> points;
+
+    int findFirstPoint (int parameterIndex) const noexcept;
+    int findEndOfCurve (int firstPoint) const noexcept;
+    void insertPoint (Point);
+
+    JUCE_LEAK_DETECTOR (ParameterAutomationBuffer)
+};
+
+} // namespace juce
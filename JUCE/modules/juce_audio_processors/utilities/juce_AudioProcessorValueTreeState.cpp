@@ -126,6 +126,16 @@ public:
     float getDenormalisedValue() const                { return unnormalisedValue; }
     std::atomic<float>& getRawDenormalisedValue()     { return unnormalisedValue; }
 
+    // Sets a bit that the state will check to find out which adapters need flushing
+    void setUpdateFlag (std::atomic<uint32>& word, uint32 bit)
+    {
+        updateFlagWord = &word;
+        updateFlagBit = bit;
+
+        if (needsUpdate)
+            word.fetch_or (bit);
+    }
+
     bool flushToTree (const Identifier& key, UndoManager* um)
     {
         auto needsUpdateTestValue = true;
@@ -164,7 +174,9 @@ private:
         unnormalisedValue = newValue;
         listeners.call ([this] (Listener& l) { l.parameterChanged (parameter.paramID, unnormalisedValue); });
         listenersNeedCalling = false;
-        needsUpdate = true;
+
+        if (! needsUpdate.exchange (true) && updateFlagWord != nullptr)
+            updateFlagWord->fetch_or (updateFlagBit);
     }
 
     float denormalise (float normalised) const
@@ -216,6 +228,8 @@ private:
     LockedListeners listeners;
     std::atomic<float> unnormalisedValue { 0.0f };
     std::atomic<bool> needsUpdate { true }, listenersNeedCalling { true };
+    std::atomic<uint32>* updateFlagWord = nullptr;
+    uint32 updateFlagBit = 0;
     bool ignoreParameterChangedCallbacks { false };
 };
 
@@ -338,7 +352,45 @@ RangedAudioParameter* AudioProcessorValueTreeState::createAndAddParameter (std::
 //==============================================================================
 void AudioProcessorValueTreeState::addParameterAdapter (RangedAudioParameter& param)
 {
-    adapterTable.emplace (param.paramID, std::make_unique<ParameterAdapter> (param));
+    auto inserted = adapterTable.emplace (param.paramID, std::make_unique<ParameterAdapter> (param));
+
+    if (! inserted.second)
+        return;
+
+    auto index = adapters.size();
+    adapters.push_back (inserted.first->second.get());
+
+    if (index % 32 == 0)
+        parametersNeedingUpdate.emplace_back (0u);
+
+    adapters.back()->setUpdateFlag (parametersNeedingUpdate.back(), 1u << (index % 32));
+
+    auto hashed = adapterIndexesByIDHash.emplace (hashParameterID (param.paramID), (int) index);
+
+    if (! hashed.second)
+        hashed.first->second = -1;
+}
+
+uint32 AudioProcessorValueTreeState::hashParameterID (const String& paramID) noexcept
+{
+    return (uint32) paramID.hashCode();
+}
+
+int AudioProcessorValueTreeState::getParameterAdapterIndex (const String& paramID) const
+{
+    auto it = adapterIndexesByIDHash.find (hashParameterID (paramID));
+
+    if (it == adapterIndexesByIDHash.end())
+        return -1;
+
+    if (it->second >= 0)
+        return adapters[(size_t) it->second]->getParameter().paramID == paramID ? it->second : -1;
+
+    for (size_t i = 0; i < adapters.size(); ++i)
+        if (adapters[i]->getParameter().paramID == paramID)
+            return (int) i;
+
+    return -1;
 }
 
 AudioProcessorValueTreeState::ParameterAdapter* AudioProcessorValueTreeState::getParameterAdapter (StringRef paramID) const
@@ -392,6 +444,24 @@ std::atomic<float>* AudioProcessorValueTreeState::getRawParameterValue (StringRe
     return nullptr;
 }
 
+void AudioProcessorValueTreeState::getParameterValues (Array<float>& destination) const
+{
+    destination.ensureStorageAllocated ((int) adapters.size());
+    destination.clearQuick();
+
+    for (auto* adapter : adapters)
+        destination.add (adapter->getDenormalisedValue());
+}
+
+void AudioProcessorValueTreeState::setParameterValues (const Array<float>& values)
+{
+    // This array should have come from getParameterValues() on a state with the same parameters
+    jassert (values.size() == (int) adapters.size());
+
+    for (int i = 0; i < jmin (values.size(), (int) adapters.size()); ++i)
+        adapters[(size_t) i]->setDenormalisedValue (values.getUnchecked (i));
+}
+
 ValueTree AudioProcessorValueTreeState::copyState()
 {
     ScopedLock lock (valueTreeChanging);
@@ -409,6 +479,140 @@ void AudioProcessorValueTreeState::replaceState (const ValueTree& newState)
         undoManager->clearUndoHistory();
 }
 
+//==============================================================================
+// magic number and format version for memory blocks written by copyStateToBinary()
+const uint32 magicBinaryStateNumber = 0x21324358;
+const int binaryStateVersion = 1;
+
+void AudioProcessorValueTreeState::copyStateToBinary (juce::MemoryBlock& destData)
+{
+    ScopedLock lock (valueTreeChanging);
+    flushParameterValuesToValueTree();
+
+    // The state must be set up before it can be saved!
+    jassert (state.isValid());
+
+    MemoryOutputStream out (destData, false);
+    out.writeInt ((int) magicBinaryStateNumber);
+    out.writeInt (binaryStateVersion);
+
+    out.writeCompressedInt ((int) adapters.size());
+
+    for (auto* adapter : adapters)
+    {
+        out.writeString (adapter->getParameter().paramID);
+        out.writeFloat (adapter->getDenormalisedValue());
+    }
+
+    // The rest of the tree is written with ValueTree::writeToStream(), leaving out the
+    // parameters' children unless they hold more than their ID and value
+    ValueTree otherChildren (state.getType());
+    otherChildren.copyPropertiesFrom (state, nullptr);
+
+    size_t nextAdapter = 0;
+
+    for (const auto& child : state)
+    {
+        if (child.hasType (valueType)
+             && child.getNumChildren() == 0
+             && child.getNumProperties() == 2
+             && child.hasProperty (valuePropertyID))
+        {
+            // the parameters' children are usually in the same order as the parameters
+            if (nextAdapter < adapters.size() && adapters[nextAdapter]->tree == child)
+            {
+                ++nextAdapter;
+                continue;
+            }
+
+            if (getParameterAdapterIndex (child.getProperty (idPropertyID).toString()) >= 0)
+                continue;
+        }
+
+        otherChildren.appendChild (child.createCopy(), nullptr);
+    }
+
+    otherChildren.writeToStream (out);
+}
+
+void AudioProcessorValueTreeState::replaceStateFromBinary (const void* data, int sizeInBytes)
+{
+    if (sizeInBytes <= 8 || ByteOrder::littleEndianInt (data) != magicBinaryStateNumber)
+    {
+        auto newState = AudioProcessor::getValueTreeFromBinary (data, sizeInBytes);
+
+        if (newState.isValid())
+            replaceState (newState);
+
+        return;
+    }
+
+    MemoryInputStream in (data, (size_t) sizeInBytes, false);
+    in.readInt();
+
+    // This data was written by a newer version of this class
+    if (in.readInt() > binaryStateVersion)
+    {
+        jassertfalse;
+        return;
+    }
+
+    const auto numValues = in.readCompressedInt();
+
+    // each value takes up at least five bytes
+    if (numValues < 0 || numValues > sizeInBytes / 5)
+    {
+        jassertfalse; // trying to read corrupted data!
+        return;
+    }
+
+    Array<float> values;
+    getParameterValues (values);
+
+    for (int i = 0; i < numValues; ++i)
+    {
+        auto paramID = in.readString();
+        auto value = in.readFloat();
+
+        // the values are usually stored in the same order as the parameters
+        auto index = i < (int) adapters.size() && adapters[(size_t) i]->getParameter().paramID == paramID
+                        ? i : getParameterAdapterIndex (paramID);
+
+        if (index >= 0)
+            values.setUnchecked (index, value);
+    }
+
+    auto newState = ValueTree::readFromStream (in);
+
+    if (! newState.isValid())
+    {
+        jassertfalse; // trying to read corrupted data!
+        return;
+    }
+
+    // parameters with extra data in their trees were stored along with the other children
+    std::vector<bool> hasTree (adapters.size(), false);
+
+    for (const auto& child : newState)
+    {
+        if (child.hasType (valueType))
+        {
+            auto index = getParameterAdapterIndex (child.getProperty (idPropertyID).toString());
+
+            if (index >= 0)
+                hasTree[(size_t) index] = true;
+        }
+    }
+
+    for (size_t i = 0; i < adapters.size(); ++i)
+        if (! hasTree[i])
+            newState.appendChild (ValueTree (valueType, { { idPropertyID, adapters[i]->getParameter().paramID },
+                                                          { valuePropertyID, values.getUnchecked ((int) i) } }),
+                                  nullptr);
+
+    replaceState (newState);
+}
+
 void AudioProcessorValueTreeState::setNewState (ValueTree vt)
 {
     jassert (vt.getParent() == state);
@@ -469,8 +673,15 @@ bool AudioProcessorValueTreeState::flushParameterValuesToValueTree()
 
     bool anyUpdated = false;
 
-    for (auto& p : adapterTable)
-        anyUpdated |= p.second->flushToTree (valuePropertyID, undoManager);
+    // Only the adapters whose bits are set can have anything to flush
+    for (size_t wordIndex = 0; wordIndex < parametersNeedingUpdate.size(); ++wordIndex)
+    {
+        auto bits = parametersNeedingUpdate[wordIndex].exchange (0);
+
+        for (auto index = wordIndex * 32; bits != 0; bits >>= 1, ++index)
+            if ((bits & 1) != 0)
+                anyUpdated |= adapters[index]->flushToTree (valuePropertyID, undoManager);
+    }
 
     return anyUpdated;
 }
@@ -663,6 +874,23 @@ private:
         float value{};
     };
 
+    struct PropertyChangeCounter final : public ValueTree::Listener
+    {
+        void valueTreePropertyChanged (ValueTree&, const Identifier&) override  { ++numChanges; }
+
+        int numChanges = 0;
+    };
+
+    static ParameterLayout createFloatParameters (int numParameters)
+    {
+        ParameterLayout layout;
+
+        for (int i = 0; i < numParameters; ++i)
+            layout.add (std::make_unique<AudioParameterFloat> ("p" + String (i), "", NormalisableRange<float>(), 0.0f));
+
+        return layout;
+    }
+
 public:
     AudioProcessorValueTreeStateTests()
         : UnitTest ("Audio Processor Value Tree State", UnitTestCategories::audioProcessorParameters)
@@ -951,6 +1179,213 @@ public:
             expectEquals (listener.value, newValue);
             expectEquals (listener.id, String (key));
         }
+
+        beginTest ("Only the parameters that have changed are written to the tree");
+        {
+            TestAudioProcessor proc (createFloatParameters (100));
+            proc.state.copyState();
+
+            PropertyChangeCounter counter;
+            proc.state.state.addListener (&counter);
+
+            for (auto index : { 3, 40, 99 })
+                proc.state.getParameter ("p" + String (index))->setValueNotifyingHost (0.25f);
+
+            const auto valueTree = proc.state.copyState();
+            expectEquals (counter.numChanges, 3);
+
+            for (auto index : { 3, 40, 99 })
+                expectEquals ((float) valueTree.getChildWithProperty ("id", "p" + String (index)).getProperty ("value"), 0.25f);
+
+            proc.state.copyState();
+            expectEquals (counter.numChanges, 3);
+
+            proc.state.state.removeListener (&counter);
+        }
+
+        beginTest ("Parameter changes on another thread all reach the tree");
+        {
+            constexpr int numParameters = 200;
+            TestAudioProcessor proc (createFloatParameters (numParameters));
+
+            struct AudioThread  : public Thread
+            {
+                explicit AudioThread (AudioProcessor& p) : Thread ("Audio"), processor (p) {}
+
+                void run() override
+                {
+                    Random random (1);
+                    auto& params = processor.getParameters();
+
+                    while (! threadShouldExit())
+                        params.getUnchecked (random.nextInt (params.size()))->setValueNotifyingHost (random.nextFloat());
+                }
+
+                AudioProcessor& processor;
+            };
+
+            AudioThread audioThread (proc);
+            audioThread.startThread();
+
+            for (int i = 0; i < 200; ++i)
+            {
+                proc.state.flushParameterValuesToValueTree();
+                Thread::yield();
+            }
+
+            audioThread.stopThread (1000);
+
+            const auto valueTree = proc.state.copyState();
+
+            for (int i = 0; i < numParameters; ++i)
+            {
+                const auto id = "p" + String (i);
+                expectEquals ((float) valueTree.getChildWithProperty ("id", id).getProperty ("value"),
+                              proc.state.getRawParameterValue (id)->load());
+            }
+        }
+
+        beginTest ("Parameter values can be copied and restored in bulk");
+        {
+            TestAudioProcessor proc (createFloatParameters (50));
+
+            for (int i = 0; i < 50; ++i)
+                proc.state.getParameter ("p" + String (i))->setValueNotifyingHost ((float) i / 50.0f);
+
+            Array<float> values;
+            proc.state.getParameterValues (values);
+            expectEquals (values.size(), 50);
+
+            for (int i = 0; i < 50; ++i)
+                expectEquals (values[i], proc.state.getRawParameterValue ("p" + String (i))->load());
+
+            TestAudioProcessor other (createFloatParameters (50));
+            other.state.setParameterValues (values);
+
+            Array<float> otherValues;
+            other.state.getParameterValues (otherValues);
+            expect (otherValues == values);
+        }
+
+        beginTest ("The state can be stored in binary and restored");
+        {
+            TestAudioProcessor proc (createFloatParameters (100));
+            proc.state.state.setProperty ("version", 3, nullptr);
+            proc.state.state.appendChild (ValueTree ("EXTRA", { { "colour", "red" } }), nullptr);
+
+            for (int i = 0; i < 100; ++i)
+                proc.state.getParameter ("p" + String (i))->setValueNotifyingHost ((float) (i % 7) / 7.0f);
+
+            MemoryBlock data;
+            proc.state.copyStateToBinary (data);
+
+            TestAudioProcessor other (createFloatParameters (100));
+            other.state.replaceStateFromBinary (data.getData(), (int) data.getSize());
+
+            expectEquals ((int) other.state.state.getProperty ("version"), 3);
+            expectEquals (other.state.state.getChildWithName ("EXTRA").getProperty ("colour").toString(), String ("red"));
+            expectEquals (other.state.state.getNumChildren(), 101);
+
+            Array<float> values, otherValues;
+            proc.state.getParameterValues (values);
+            other.state.getParameterValues (otherValues);
+            expect (otherValues == values);
+
+            // the parameters must still be attached to the tree
+            for (int i = 0; i < 100; ++i)
+                expectEquals ((float) other.state.getParameterAsValue ("p" + String (i)).getValue(), values[i]);
+
+            other.state.getParameterAsValue ("p5") = 0.75f;
+            expectEquals (other.state.getRawParameterValue ("p5")->load(), 0.75f);
+        }
+
+        beginTest ("States stored as XML or as a ValueTree can still be restored");
+        {
+            TestAudioProcessor proc (createFloatParameters (10));
+            proc.state.getParameter ("p3")->setValueNotifyingHost (0.5f);
+
+            MemoryBlock xmlData, treeData;
+            AudioProcessor::copyXmlToBinary (*proc.state.copyState().createXml(), xmlData);
+            AudioProcessor::copyValueTreeToBinary (proc.state.copyState(), treeData);
+
+            for (auto* data : { &xmlData, &treeData })
+            {
+                TestAudioProcessor other (createFloatParameters (10));
+                other.state.replaceStateFromBinary (data->getData(), (int) data->getSize());
+                expectEquals (other.state.getRawParameterValue ("p3")->load(), 0.5f);
+            }
+        }
+
+        beginTest ("Parameters that aren't in the stored state keep their values");
+        {
+            TestAudioProcessor proc (createFloatParameters (5));
+            proc.state.getParameter ("p1")->setValueNotifyingHost (0.25f);
+
+            MemoryBlock data;
+            proc.state.copyStateToBinary (data);
+
+            TestAudioProcessor other (createFloatParameters (8));
+            other.state.getParameter ("p6")->setValueNotifyingHost (0.75f);
+            other.state.replaceStateFromBinary (data.getData(), (int) data.getSize());
+
+            expectEquals (other.state.getRawParameterValue ("p1")->load(), 0.25f);
+            expectEquals (other.state.getRawParameterValue ("p6")->load(), 0.75f);
+            expectEquals (other.state.state.getNumChildren(), 8);
+
+            // and states with parameters that have since been removed can still be loaded
+            other.state.copyStateToBinary (data);
+            proc.state.replaceStateFromBinary (data.getData(), (int) data.getSize());
+            expectEquals (proc.state.getRawParameterValue ("p1")->load(), 0.25f);
+            expectEquals (proc.state.state.getNumChildren(), 5);
+        }
+
+        beginTest ("Parameters whose IDs have the same hash aren't mixed up");
+        {
+            // "Aa" and "BB" have the same String::hashCode()
+            auto createParameter = [] (const String& paramID)
+            {
+                return std::make_unique<AudioParameterFloat> (paramID, "", NormalisableRange<float>(), 0.0f);
+            };
+
+            TestAudioProcessor proc (ParameterLayout (createParameter ("Aa"))), other (ParameterLayout (createParameter ("BB")));
+            expectEquals (String ("Aa").hashCode(), String ("BB").hashCode());
+
+            proc.state.getParameter ("Aa")->setValueNotifyingHost (0.5f);
+
+            MemoryBlock data;
+            proc.state.copyStateToBinary (data);
+            other.state.replaceStateFromBinary (data.getData(), (int) data.getSize());
+
+            expectEquals (other.state.getRawParameterValue ("BB")->load(), 0.0f);
+        }
+
+        beginTest ("Extra data in the parameters' trees is stored in binary");
+        {
+            TestAudioProcessor proc (createFloatParameters (10));
+
+            auto parameterTree = proc.state.state.getChildWithProperty ("id", "p2");
+            parameterTree.setProperty ("midiCC", 7, nullptr);
+            parameterTree.appendChild (ValueTree ("MODULATION", { { "depth", 0.25 } }), nullptr);
+
+            proc.state.getParameter ("p2")->setValueNotifyingHost (0.5f);
+
+            MemoryBlock data;
+            proc.state.copyStateToBinary (data);
+
+            TestAudioProcessor other (createFloatParameters (10));
+            other.state.replaceStateFromBinary (data.getData(), (int) data.getSize());
+
+            expectEquals (other.state.state.getNumChildren(), 10);
+            expectEquals (other.state.getRawParameterValue ("p2")->load(), 0.5f);
+
+            auto otherTree = other.state.state.getChildWithProperty ("id", "p2");
+            expectEquals ((int) otherTree.getProperty ("midiCC"), 7);
+            expectEquals ((double) otherTree.getChildWithName ("MODULATION").getProperty ("depth"), 0.25);
+
+            // the parameter must still be attached to its tree
+            other.state.getParameterAsValue ("p2") = 0.75f;
+            expectEquals (other.state.getRawParameterValue ("p2")->load(), 0.75f);
+        }
     }
 };
 
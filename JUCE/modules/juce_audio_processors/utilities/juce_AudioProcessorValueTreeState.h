@@ -286,6 +286,25 @@ public:
     */
     std::atomic<float>* getRawParameterValue (StringRef parameterID) const noexcept;
 
+    /** Copies the current values of all the parameters into an array, in the order
+        in which they were added.
+
+        The values are the same denormalised ones that getRawParameterValue() returns.
+        Unlike copyState(), this reads them straight from the parameters, without
+        locking or going through the ValueTree, so it's a cheap way to take a snapshot
+        of the whole state. It won't allocate if the array already has enough space.
+
+        @see setParameterValues
+    */
+    void getParameterValues (Array<float>& destination) const;
+
+    /** Sets all the parameters from an array that was filled by getParameterValues().
+
+        Each parameter that changes will notify the host in the usual way, so this should
+        be called on the message thread, like replaceState().
+    */
+    void setParameterValues (const Array<float>& values);
+
     //==============================================================================
     /** A listener class that can be attached to an AudioProcessorValueTreeState.
         Use AudioProcessorValueTreeState::addParameterListener() to register a callback.
@@ -344,6 +363,36 @@ public:
     */
     void replaceState (const ValueTree& newState);
 
+    /** Stores the state in a compact binary form.
+
+        This does the same job as calling copyState() and then storing the result with
+        AudioProcessor::copyXmlToBinary(), but it's much quicker for states with lots of
+        parameters. The values of the parameters are written as a list of IDs and floats,
+        and the rest of the tree is written with ValueTree::writeToStream(), so no XML has
+        to be generated or parsed. A parameter's child tree is only written in full if it
+        holds any properties or children besides its ID and value.
+
+        This is a handy thing to call from your processor's getStateInformation() method.
+        Like copyState(), it's thread-safe but not realtime-safe.
+
+        @see replaceStateFromBinary
+    */
+    void copyStateToBinary (juce::MemoryBlock& destData);
+
+    /** Replaces the state with one that was stored by copyStateToBinary().
+
+        This also accepts data that was stored with AudioProcessor::copyXmlToBinary()
+        or AudioProcessor::copyValueTreeToBinary(), so it can read states that were
+        saved before a plugin switched to the binary format.
+
+        Any parameters that aren't in the data keep their current values, and the
+        parameters' children of the tree end up after any other children it has.
+        Like replaceState(), it's thread-safe but not realtime-safe.
+
+        @see copyStateToBinary
+    */
+    void replaceStateFromBinary (const void* data, int sizeInBytes);
+
     //==============================================================================
     /** A reference to the processor with which this state is associated. */
     AudioProcessor& processor;
@@ -527,10 +576,13 @@ private:
     //==============================================================================
    #if JUCE_UNIT_TESTS
     friend struct ParameterAdapterTests;
+    friend class AudioProcessorValueTreeStateTests;
    #endif
 
     void addParameterAdapter (RangedAudioParameter&);
     ParameterAdapter* getParameterAdapter (StringRef) const;
+    int getParameterAdapterIndex (const String&) const;
+    static uint32 hashParameterID (const String&) noexcept;
 
     bool flushParameterValuesToValueTree();
     void setNewState (ValueTree);
@@ -550,6 +602,16 @@ private:
 
     std::map<StringRef, std::unique_ptr<ParameterAdapter>, StringRefLessThan> adapterTable;
 
+    // The adapters in the order they were added, and a bit for each of them that's set when
+    // its value needs to be copied to the tree. Parameters can change on any thread, so the
+    // bits are atomic, and a deque is used so that the words never move once they've been
+    // handed to an adapter.
+    std::vector<ParameterAdapter*> adapters;
+    std::deque<std::atomic<uint32>> parametersNeedingUpdate;
+
+    // Maps the hashes of the parameter IDs to the adapters' indexes, or to -1 if the hash is shared
+    std::map<uint32, int> adapterIndexesByIDHash;
+
     CriticalSection valueTreeChanging;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioProcessorValueTreeState)
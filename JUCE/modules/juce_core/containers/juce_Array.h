@@ -1065,6 +1065,17 @@ public:
         values.ensureAllocatedSize (minNumElements);
     }
 
+    /** Returns the number of elements that the array can hold before it has to
+        reallocate its storage.
+
+        @see ensureStorageAllocated
+    */
+    int getNumAllocated() const noexcept
+    {
+        const ScopedLockType lock (getLock());
+        return values.capacity();
+    }
+
     //==============================================================================
     /** Sorts the array using a default comparison operation.
         If the type of your elements isn't supported by the DefaultElementComparator class
@@ -342,7 +342,10 @@ public:
     void runTests (const Array<UnitTest*>& tests, int64 randomSeed = 0);
 
     /** Runs all the UnitTest objects that currently exist.
-        This calls runTests() for all the objects listed in UnitTest::getAllTests().
+        This calls runTests() for all the objects listed in UnitTest::getAllTests(),
+        apart from the ones in the "Benchmarks" category. Those only measure how long
+        things take, so they're only run if you ask for that category with
+        runTestsInCategory().
 
         If you want to run the tests with a predetermined seed, you can pass that into
         the randomSeed argument, or pass 0 to have a randomly-generated seed chosen.
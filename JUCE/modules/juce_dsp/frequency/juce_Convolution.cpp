@@ -439,6 +439,179 @@ struct ConvolutionEngine
     std::vector<AudioBuffer<float>> buffersInputSegments, buffersImpulseSegments;
 };
 
+//==============================================================================
+// A uniformly partitioned section of the impulse response tail, convolved on a
+// background thread. Each input block is handed to the worker once it is complete,
+// and the result is collected when the following block is complete, so the stage
+// adds a latency of twice its partition size. For this reason, a stage must only
+// be used for the part of the impulse response starting at that offset.
+class BackgroundConvolutionStage
+{
+public:
+    BackgroundConvolutionStage (std::vector<std::unique_ptr<ConvolutionEngine>> enginesIn,
+                                int partitionSizeIn)
+        : engines (std::move (enginesIn)),
+          partitionSize (partitionSizeIn),
+          audioInput  ((int) engines.size(), partitionSize),
+          audioOutput ((int) engines.size(), partitionSize),
+          jobInput    ((int) engines.size(), partitionSize),
+          jobOutput   ((int) engines.size(), partitionSize)
+    {
+        reset();
+    }
+
+    // Must be called on the audio thread.
+    void reset()
+    {
+        waitForPendingBlock();
+
+        for (const auto& e : engines)
+            e->reset();
+
+        audioInput.clear();
+        audioOutput.clear();
+        jobInput.clear();
+        jobOutput.clear();
+
+        inputDataPos = 0;
+        state = JobState::idle;
+    }
+
+    // Adds the output of this stage to the output block, and returns true if a
+    // new input block is waiting to be processed.
+    bool processSamples (const AudioBlock<const float>& input, AudioBlock<float>& output)
+    {
+        const auto numChannels = jmin (engines.size(), input.getNumChannels(), output.getNumChannels());
+        const auto numSamples  = jmin (input.getNumSamples(), output.getNumSamples());
+
+        size_t numSamplesProcessed = 0;
+        auto blockWasPosted = false;
+
+        while (numSamplesProcessed < numSamples)
+        {
+            const auto numSamplesToProcess = jmin (numSamples - numSamplesProcessed,
+                                                   (size_t) partitionSize - inputDataPos);
+
+            for (size_t channel = 0; channel < numChannels; ++channel)
+            {
+                FloatVectorOperations::copy (audioInput.getWritePointer ((int) channel, (int) inputDataPos),
+                                             input.getChannelPointer (channel) + numSamplesProcessed,
+                                             (int) numSamplesToProcess);
+
+                FloatVectorOperations::add (output.getChannelPointer (channel) + numSamplesProcessed,
+                                            audioOutput.getReadPointer ((int) channel, (int) inputDataPos),
+                                            (int) numSamplesToProcess);
+            }
+
+            inputDataPos += numSamplesToProcess;
+            numSamplesProcessed += numSamplesToProcess;
+
+            if (inputDataPos == (size_t) partitionSize)
+            {
+                exchangeBlocks (numChannels);
+                inputDataPos = 0;
+                blockWasPosted = true;
+            }
+        }
+
+        return blockWasPosted;
+    }
+
+    // Called on the worker thread, and by the audio thread if the worker falls behind.
+    bool tryProcessPendingBlock()
+    {
+        auto expected = JobState::pending;
+
+        if (! state.compare_exchange_strong (expected, JobState::running))
+            return false;
+
+        for (size_t channel = 0; channel < jobNumChannels; ++channel)
+            engines[channel]->processSamples (jobInput.getReadPointer ((int) channel),
+                                              jobOutput.getWritePointer ((int) channel),
+                                              (size_t) partitionSize);
+
+        state = JobState::done;
+        return true;
+    }
+
+private:
+    enum class JobState { idle, pending, running, done };
+
+    void waitForPendingBlock()
+    {
+        // If the worker hasn't picked up the block yet we'll do it ourselves,
+        // otherwise we have no choice but to wait for it to finish.
+        tryProcessPendingBlock();
+
+        while (state == JobState::running)
+            Thread::yield();
+    }
+
+    void exchangeBlocks (size_t numChannels)
+    {
+        waitForPendingBlock();
+
+        if (state == JobState::done)
+            std::swap (audioOutput, jobOutput);
+
+        std::swap (audioInput, jobInput);
+        jobNumChannels = numChannels;
+        state = JobState::pending;
+    }
+
+    std::vector<std::unique_ptr<ConvolutionEngine>> engines;
+    const int partitionSize;
+    size_t inputDataPos = 0, jobNumChannels = 0;
+
+    AudioBuffer<float> audioInput, audioOutput, jobInput, jobOutput;
+    std::atomic<JobState> state { JobState::idle };
+
+    JUCE_DECLARE_NON_COPYABLE (BackgroundConvolutionStage)
+};
+
+// Processes the blocks posted by a set of BackgroundConvolutionStages.
+class BackgroundConvolutionWorker  : private Thread
+{
+public:
+    explicit BackgroundConvolutionWorker (const std::vector<std::unique_ptr<BackgroundConvolutionStage>>& stagesIn)
+        : Thread ("Convolution tail processor"), stages (stagesIn)
+    {
+        startThread (8);
+    }
+
+    ~BackgroundConvolutionWorker() override
+    {
+        stopThread (-1);
+    }
+
+    using Thread::notify;
+
+private:
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            // The stages are sorted by partition size, so the blocks with the
+            // closest deadlines are always processed first.
+            const auto processNextBlock = [&]
+            {
+                return std::any_of (stages.begin(), stages.end(), [] (const auto& stage)
+                {
+                    return stage->tryProcessPendingBlock();
+                });
+            };
+
+            while (processNextBlock() && ! threadShouldExit()) {}
+
+            wait (-1);
+        }
+    }
+
+    const std::vector<std::unique_ptr<BackgroundConvolutionStage>>& stages;
+
+    JUCE_DECLARE_NON_COPYABLE (BackgroundConvolutionWorker)
+};
+
 //==============================================================================
 class MultichannelEngine
 {
@@ -477,12 +650,54 @@ public:
 
             const auto tailBufferSize = static_cast<uint32> (headSizeIn.headSizeInSamples + (isZeroDelay ? 0 : maxBufferSize));
 
+            // With a maximum tail partition size, the synchronous tail only covers the
+            // start of the remaining IR, and the rest is split into stages with
+            // partitions of doubling size which are processed on a background thread.
+            // A stage with partition size N adds a latency of 2N, so it starts at
+            // offset 2N, and the first stage is made large enough that the worker
+            // always has at least one audio callback's worth of time to process it.
+            const auto firstStageSize = jmax (headSizeIn.headSizeInSamples, 2 * nextPowerOfTwo (maxBlockSize));
+            const auto useStages = isZeroDelay
+                                && headSizeIn.maxTailPartitionSizeInSamples > 0
+                                && buf.getNumSamples() > 2 * firstStageSize;
+
+            const auto tailEnd = useStages ? 2 * firstStageSize : buf.getNumSamples();
+
             if (size != buf.getNumSamples())
                 for (int i = 0; i < numChannels; ++i)
-                    tail.emplace_back (makeEngine (i, size, buf.getNumSamples() - size, tailBufferSize));
+                    tail.emplace_back (makeEngine (i, size, tailEnd - size, tailBufferSize));
+
+            if (useStages)
+            {
+                const auto maxStageSize = jmax (firstStageSize, headSizeIn.maxTailPartitionSizeInSamples);
+
+                for (auto stageSize = firstStageSize, offset = tailEnd; offset < buf.getNumSamples(); stageSize *= 2)
+                {
+                    const auto isLastStage = stageSize >= maxStageSize;
+                    const auto length = isLastStage ? buf.getNumSamples() - offset
+                                                    : jmin (2 * stageSize, buf.getNumSamples() - offset);
+
+                    std::vector<std::unique_ptr<ConvolutionEngine>> engines;
+
+                    for (int i = 0; i < numChannels; ++i)
+                        engines.emplace_back (makeEngine (i, offset, length, static_cast<uint32> (stageSize)));
+
+                    stages.emplace_back (std::make_unique<BackgroundConvolutionStage> (std::move (engines), stageSize));
+                    offset += length;
+                }
+
+                stagesBuffer.setSize (numChannels, maxBlockSize);
+                worker = std::make_unique<BackgroundConvolutionWorker> (stages);
+            }
         }
     }
 
+    ~MultichannelEngine()
+    {
+        // The worker must be stopped before the stages it refers to are destroyed
+        worker = nullptr;
+    }
+
     void reset()
     {
         for (const auto& e : head)
@@ -490,6 +705,9 @@ public:
 
         for (const auto& e : tail)
             e->reset();
+
+        for (const auto& s : stages)
+            s->reset();
     }
 
     void processSamples (const AudioBlock<const float>& input, AudioBlock<float>& output)
@@ -502,6 +720,24 @@ public:
 
         const auto isUniform = tail.empty();
 
+        // The stages need to see the input before it is overwritten by the head
+        AudioBlock<float> stagesBlock;
+
+        if (! stages.empty())
+        {
+            stagesBlock = AudioBlock<float> (stagesBuffer).getSubsetChannelBlock (0, numChannels)
+                                                          .getSubBlock (0, numSamples);
+            stagesBlock.clear();
+
+            auto blockWasPosted = false;
+
+            for (const auto& stage : stages)
+                blockWasPosted = stage->processSamples (input, stagesBlock) || blockWasPosted;
+
+            if (blockWasPosted)
+                worker->notify();
+        }
+
         for (size_t channel = 0; channel < numChannels; ++channel)
         {
             if (! isUniform)
@@ -520,6 +756,9 @@ public:
 
             if (! isUniform)
                 output.getSingleChannelBlock (channel) += tailBlock;
+
+            if (! stages.empty())
+                output.getSingleChannelBlock (channel) += stagesBlock.getSingleChannelBlock (channel);
         }
 
         const auto numOutputChannels = output.getNumChannels();
@@ -534,7 +773,9 @@ public:
 
 private:
     std::vector<std::unique_ptr<ConvolutionEngine>> head, tail;
-    AudioBuffer<float> tailBuffer;
+    std::vector<std::unique_ptr<BackgroundConvolutionStage>> stages;
+    std::unique_ptr<BackgroundConvolutionWorker> worker;
+    AudioBuffer<float> tailBuffer, stagesBuffer;
 
     const int latency;
     const int irSize;
@@ -733,7 +974,8 @@ public:
     ConvolutionEngineFactory (Convolution::Latency requiredLatency,
                               Convolution::NonUniform requiredHeadSize)
         : latency  { (requiredLatency.latencyInSamples   <= 0) ? 0 : jmax (64, nextPowerOfTwo (requiredLatency.latencyInSamples)) },
-          headSize { (requiredHeadSize.headSizeInSamples <= 0) ? 0 : jmax (64, nextPowerOfTwo (requiredHeadSize.headSizeInSamples)) },
+          headSize { (requiredHeadSize.headSizeInSamples <= 0) ? 0 : jmax (64, nextPowerOfTwo (requiredHeadSize.headSizeInSamples)),
+                     (requiredHeadSize.maxTailPartitionSizeInSamples <= 0) ? 0 : nextPowerOfTwo (requiredHeadSize.maxTailPartitionSizeInSamples) },
           shouldBeZeroLatency (requiredLatency.latencyInSamples == 0)
     {}
 
@@ -130,18 +130,31 @@ public:
     */
     explicit Convolution (const Latency& requiredLatency);
 
-    /** Contains configuration information for a non-uniform convolution. */
-    struct NonUniform { int headSizeInSamples; };
+    /** Contains configuration information for a non-uniform convolution.
+
+        If maxTailPartitionSizeInSamples is greater than zero, the end of the
+        impulse response is split into stages of partitions which double in
+        size up to this maximum, and these stages are processed on a background
+        thread. This keeps the processing cost on the audio thread low and
+        evenly spread between blocks for very long impulse responses.
+    */
+    struct NonUniform
+    {
+        int headSizeInSamples;
+        int maxTailPartitionSizeInSamples = 0;
+    };
 
     /** Initialises an object for performing convolution in the frequency domain
         using a non-uniform partitioned algorithm.
 
         A requiredHeadSize of 256 samples or greater will improve the
         efficiency of the processing for IR sizes of 4096 samples or greater
-        (recommended for reverberation IRs).
+        (recommended for reverberation IRs). For IRs of several seconds, also
+        setting a maxTailPartitionSizeInSamples of 8192 samples or greater
+        will move most of the work to a background thread.
 
-        @param requiredHeadSize       the head IR size for two stage non-uniform
-                                      partitioned convolution
+        @param requiredHeadSize       the head IR size and maximum tail partition
+                                      size for non-uniform partitioned convolution
      */
     explicit Convolution (const NonUniform& requiredHeadSize);
 
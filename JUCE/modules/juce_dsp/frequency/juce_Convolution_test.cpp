@@ -548,6 +548,24 @@ public:
             }
         }
 
+        beginTest ("Non-uniform convolutions with background tail stages work");
+        {
+            const auto ramp = makeStereoRamp (static_cast<int> (spec.maximumBlockSize) * 40);
+
+            for (auto maxTailPartitionSize : { spec.maximumBlockSize * 2, spec.maximumBlockSize * 8 })
+            {
+                testConvolution (spec,
+                                 Convolution::NonUniform { static_cast<int> (spec.maximumBlockSize / 2),
+                                                           static_cast<int> (maxTailPartitionSize) },
+                                 ramp,
+                                 spec.sampleRate,
+                                 Convolution::Stereo::yes,
+                                 Convolution::Trim::yes,
+                                 Convolution::Normalise::no,
+                                 ramp);
+            }
+        }
+
         beginTest ("Convolutions with latency work");
         {
             const auto ramp = makeRamp (static_cast<int> (spec.maximumBlockSize) * 8);
@@ -34,6 +34,19 @@ struct FFT::Instance
     virtual void perform (const Complex<float>* input, Complex<float>* output, bool inverse) const noexcept = 0;
     virtual void performRealOnlyForwardTransform (float*, bool) const noexcept = 0;
     virtual void performRealOnlyInverseTransform (float*) const noexcept = 0;
+
+    virtual void performMultichannelRealOnlyForwardTransform (float* const* channels, int numChannels,
+                                                              bool ignoreNegativeFreqs) const noexcept
+    {
+        for (int i = 0; i < numChannels; ++i)
+            performRealOnlyForwardTransform (channels[i], ignoreNegativeFreqs);
+    }
+
+    virtual void performMultichannelRealOnlyInverseTransform (float* const* channels, int numChannels) const noexcept
+    {
+        for (int i = 0; i < numChannels; ++i)
+            performRealOnlyInverseTransform (channels[i]);
+    }
 };
 
 struct FFT::Engine
@@ -421,6 +434,464 @@ struct FFTFallback  : public FFT::Instance
 
 FFT::EngineImpl<FFTFallback> fftFallback;
 
+//==============================================================================
+//==============================================================================
+#if JUCE_USE_SIMD
+struct FFTStockham  : public FFT::Instance
+{
+    // this should be used in preference to the fallback, but not to
+    // any of the platform or third-party engines
+    static constexpr int priority = 0;
+
+    using Vec = SIMDRegister<float>;
+    static constexpr int numLanes = (int) Vec::SIMDNumElements;
+
+    // Above this size, the transforms are already mostly vectorised within
+    // each channel, so it isn't worth the memory needed to interleave channels
+    static constexpr int maxMultichannelSize = 1024;
+
+    static FFTStockham* create (int order)
+    {
+        return new FFTStockham (order);
+    }
+
+    FFTStockham (int order)
+        : size (1 << order),
+          complexTwiddles ((size_t) size),
+          realTwiddles ((size_t) (size / 2 + 1)),
+          workspace ((size_t) (4 * size + 4 * numLanes))
+    {
+        for (int i = 0; i < size; ++i)
+            complexTwiddles[i] = std::polar (1.0f, (float) (-MathConstants<double>::twoPi * i / size));
+
+        // The real-only transforms use a complex transform of half the size, so
+        // they need a second table of twiddles to unpack the result
+        for (int i = 0; i <= size / 2; ++i)
+            realTwiddles[i] = std::polar (1.0f, (float) (-MathConstants<double>::twoPi * i / size));
+
+        // Each of the work buffers must be SIMD aligned
+        const auto assignBuffers = [] (float* (&bufs)[4], HeapBlock<float>& block, int bufferSize)
+        {
+            auto* ptr = Vec::getNextSIMDAlignedPtr (block.getData());
+
+            for (auto& buffer : bufs)
+            {
+                buffer = ptr;
+                ptr = Vec::getNextSIMDAlignedPtr (ptr + bufferSize);
+            }
+        };
+
+        assignBuffers (buffers, workspace, size);
+
+        if (size <= maxMultichannelSize)
+        {
+            multichannelWorkspace.malloc ((size_t) (4 * (size + 1) * numLanes));
+            assignBuffers (multichannelBuffers, multichannelWorkspace, size * numLanes);
+        }
+    }
+
+    void perform (const Complex<float>* input, Complex<float>* output, bool inverse) const noexcept override
+    {
+        if (size == 1)
+        {
+            *output = *input;
+            return;
+        }
+
+        const SpinLock::ScopedLockType sl (processLock);
+
+        for (int i = 0; i < size; ++i)
+        {
+            buffers[0][i] = input[i].real();
+            buffers[1][i] = input[i].imag();
+        }
+
+        const auto result = inverse ? performComplex<true>  (buffers, size, 1, 1)
+                                    : performComplex<false> (buffers, size, 1, 1);
+
+        const auto scale = inverse ? 1.0f / (float) size : 1.0f;
+
+        for (int i = 0; i < size; ++i)
+            output[i] = { result.re[i] * scale, result.im[i] * scale };
+    }
+
+    void performRealOnlyForwardTransform (float* d, bool ignoreNegativeFreqs) const noexcept override
+    {
+        if (size == 1)
+            return;
+
+        const SpinLock::ScopedLockType sl (processLock);
+
+        // Pack the even and odd samples into the real and imaginary parts of
+        // a complex signal of half the size, and transform that instead
+        const auto half = size / 2;
+
+        for (int i = 0; i < half; ++i)
+        {
+            buffers[0][i] = d[2 * i];
+            buffers[1][i] = d[2 * i + 1];
+        }
+
+        const auto z = performComplex<false> (buffers, half, 2, 1);
+        auto* out = reinterpret_cast<Complex<float>*> (d);
+
+        out[0]    = { z.re[0] + z.im[0], 0.0f };
+        out[half] = { z.re[0] - z.im[0], 0.0f };
+
+        for (int k = 1; k < half; ++k)
+        {
+            const Complex<float> zk (z.re[k], z.im[k]);
+            const Complex<float> zc (z.re[half - k], -z.im[half - k]);
+
+            const auto even = 0.5f * (zk + zc);
+            const auto odd  = Complex<float> (0.0f, -0.5f) * (zk - zc);
+
+            out[k] = even + realTwiddles[k] * odd;
+        }
+
+        if (! ignoreNegativeFreqs)
+            mirrorNegativeFrequencies (d);
+    }
+
+    void performRealOnlyInverseTransform (float* d) const noexcept override
+    {
+        if (size == 1)
+            return;
+
+        const SpinLock::ScopedLockType sl (processLock);
+
+        const auto half = size / 2;
+        const auto* in = reinterpret_cast<const Complex<float>*> (d);
+
+        for (int k = 0; k < half; ++k)
+        {
+            const auto xk = in[k];
+            const auto xc = std::conj (in[half - k]);
+
+            const auto even = 0.5f * (xk + xc);
+            const auto odd  = 0.5f * (xk - xc) * std::conj (realTwiddles[k]);
+            const auto zk = even + Complex<float> (-odd.imag(), odd.real());
+
+            buffers[0][k] = zk.real();
+            buffers[1][k] = zk.imag();
+        }
+
+        const auto z = performComplex<true> (buffers, half, 2, 1);
+        const auto scale = 1.0f / (float) half;
+
+        for (int i = 0; i < half; ++i)
+        {
+            d[2 * i]     = z.re[i] * scale;
+            d[2 * i + 1] = z.im[i] * scale;
+        }
+    }
+
+    // The multichannel transforms interleave up to one SIMD register's worth of
+    // channels, so that every butterfly processes all of those channels at once.
+    void performMultichannelRealOnlyForwardTransform (float* const* channels, int numChannels,
+                                                      bool ignoreNegativeFreqs) const noexcept override
+    {
+        if (size == 1 || multichannelBuffers[0] == nullptr)
+        {
+            FFT::Instance::performMultichannelRealOnlyForwardTransform (channels, numChannels, ignoreNegativeFreqs);
+            return;
+        }
+
+        const SpinLock::ScopedLockType sl (processLock);
+
+        const auto half = size / 2;
+
+        for (int first = 0; first < numChannels; first += numLanes)
+        {
+            const auto numInGroup = jmin (numLanes, numChannels - first);
+
+            for (int i = 0; i < half; ++i)
+            {
+                for (int lane = 0; lane < numLanes; ++lane)
+                {
+                    const auto isUsed = lane < numInGroup;
+                    multichannelBuffers[0][i * numLanes + lane] = isUsed ? channels[first + lane][2 * i]     : 0.0f;
+                    multichannelBuffers[1][i * numLanes + lane] = isUsed ? channels[first + lane][2 * i + 1] : 0.0f;
+                }
+            }
+
+            const auto z = performComplex<false> (multichannelBuffers, half, 2, numLanes);
+            const auto x = getOtherBuffers (z);
+
+            const auto z0r = Vec::fromRawArray (z.re), z0i = Vec::fromRawArray (z.im);
+            (z0r + z0i).copyToRawArray (x.re);
+            (z0r - z0i).copyToRawArray (x.re + half * numLanes);
+            Vec::expand (0.0f).copyToRawArray (x.im);
+            Vec::expand (0.0f).copyToRawArray (x.im + half * numLanes);
+
+            for (int k = 1; k < half; ++k)
+            {
+                const auto zkr = Vec::fromRawArray (z.re + k * numLanes);
+                const auto zki = Vec::fromRawArray (z.im + k * numLanes);
+                const auto zcr = Vec::fromRawArray (z.re + (half - k) * numLanes);
+                const auto zci = Vec::fromRawArray (z.im + (half - k) * numLanes) * -1.0f;
+
+                const auto evenr = (zkr + zcr) * 0.5f, eveni = (zki + zci) * 0.5f;
+                const auto oddr  = (zki - zci) * 0.5f, oddi  = (zcr - zkr) * 0.5f;
+                const auto w = realTwiddles[k];
+
+                (evenr + oddr * w.real() - oddi * w.imag()).copyToRawArray (x.re + k * numLanes);
+                (eveni + oddr * w.imag() + oddi * w.real()).copyToRawArray (x.im + k * numLanes);
+            }
+
+            for (int lane = 0; lane < numInGroup; ++lane)
+            {
+                auto* d = channels[first + lane];
+
+                for (int k = 0; k <= half; ++k)
+                {
+                    d[2 * k]     = x.re[k * numLanes + lane];
+                    d[2 * k + 1] = x.im[k * numLanes + lane];
+                }
+
+                if (! ignoreNegativeFreqs)
+                    mirrorNegativeFrequencies (d);
+            }
+        }
+    }
+
+    void performMultichannelRealOnlyInverseTransform (float* const* channels, int numChannels) const noexcept override
+    {
+        if (size == 1 || multichannelBuffers[0] == nullptr)
+        {
+            FFT::Instance::performMultichannelRealOnlyInverseTransform (channels, numChannels);
+            return;
+        }
+
+        const SpinLock::ScopedLockType sl (processLock);
+
+        const auto half = size / 2;
+        const SplitComplex x { multichannelBuffers[2], multichannelBuffers[3] };
+        const SplitComplex zIn { multichannelBuffers[0], multichannelBuffers[1] };
+
+        for (int first = 0; first < numChannels; first += numLanes)
+        {
+            const auto numInGroup = jmin (numLanes, numChannels - first);
+
+            for (int k = 0; k <= half; ++k)
+            {
+                for (int lane = 0; lane < numLanes; ++lane)
+                {
+                    const auto isUsed = lane < numInGroup;
+                    x.re[k * numLanes + lane] = isUsed ? channels[first + lane][2 * k]     : 0.0f;
+                    x.im[k * numLanes + lane] = isUsed ? channels[first + lane][2 * k + 1] : 0.0f;
+                }
+            }
+
+            for (int k = 0; k < half; ++k)
+            {
+                const auto xkr = Vec::fromRawArray (x.re + k * numLanes);
+                const auto xki = Vec::fromRawArray (x.im + k * numLanes);
+                const auto xcr = Vec::fromRawArray (x.re + (half - k) * numLanes);
+                const auto xci = Vec::fromRawArray (x.im + (half - k) * numLanes) * -1.0f;
+
+                const auto evenr = (xkr + xcr) * 0.5f, eveni = (xki + xci) * 0.5f;
+                const auto diffr = (xkr - xcr) * 0.5f, diffi = (xki - xci) * 0.5f;
+                const auto w = std::conj (realTwiddles[k]);
+                const auto oddr = diffr * w.real() - diffi * w.imag();
+                const auto oddi = diffr * w.imag() + diffi * w.real();
+
+                (evenr - oddi).copyToRawArray (zIn.re + k * numLanes);
+                (eveni + oddr).copyToRawArray (zIn.im + k * numLanes);
+            }
+
+            const auto z = performComplex<true> (multichannelBuffers, half, 2, numLanes);
+            const auto scale = 1.0f / (float) half;
+
+            for (int lane = 0; lane < numInGroup; ++lane)
+            {
+                auto* d = channels[first + lane];
+
+                for (int i = 0; i < half; ++i)
+                {
+                    d[2 * i]     = z.re[i * numLanes + lane] * scale;
+                    d[2 * i + 1] = z.im[i * numLanes + lane] * scale;
+                }
+            }
+        }
+    }
+
+private:
+    //==============================================================================
+    struct SplitComplex { float* re; float* im; };
+
+    struct ScalarAccess
+    {
+        using Element = float;
+        static float load (const float* p) noexcept         { return *p; }
+        static void store (float v, float* p) noexcept      { *p = v; }
+    };
+
+    struct VectorAccess
+    {
+        using Element = Vec;
+        static Vec load (const float* p) noexcept           { return Vec::fromRawArray (p); }
+        static void store (Vec v, float* p) noexcept        { v.copyToRawArray (p); }
+    };
+
+    void mirrorNegativeFrequencies (float* d) const noexcept
+    {
+        auto* out = reinterpret_cast<Complex<float>*> (d);
+
+        for (int i = size / 2 + 1; i < size; ++i)
+            out[i] = std::conj (out[size - i]);
+    }
+
+    SplitComplex getOtherBuffers (SplitComplex z) const noexcept
+    {
+        return z.re == multichannelBuffers[0] ? SplitComplex { multichannelBuffers[2], multichannelBuffers[3] }
+                                              : SplitComplex { multichannelBuffers[0], multichannelBuffers[1] };
+    }
+
+    // Performs an unscaled transform of the first n values in bufs[0] and bufs[1],
+    // using the Stockham autosort algorithm to avoid a bit-reversal pass.
+    // The result may end up in either pair of buffers. twiddleStride is the ratio
+    // between the size of this FFT and n. If lanes is greater than one, each value
+    // is a whole SIMD register holding the same element for several channels.
+    template <bool inverse>
+    SplitComplex performComplex (float* const* bufs, int n, int twiddleStride, int lanes) const noexcept
+    {
+        SplitComplex x { bufs[0], bufs[1] }, y { bufs[2], bufs[3] };
+        int s = 1;
+
+        for (; n >= 4; n /= 4, s *= 4)
+        {
+            radix4Pass<inverse> (x, y, n, s, twiddleStride, lanes);
+            std::swap (x, y);
+        }
+
+        if (n == 2)
+        {
+            radix2Pass (x, y, s, lanes);
+            std::swap (x, y);
+        }
+
+        return x;
+    }
+
+    template <bool inverse>
+    void radix4Pass (SplitComplex x, SplitComplex y, int n, int s, int twiddleStride, int lanes) const noexcept
+    {
+        const auto m = n / 4;
+
+        for (int p = 0; p < m; ++p)
+        {
+            const auto twiddleIndex = p * s * twiddleStride;
+            const auto w1 = twiddle<inverse> (twiddleIndex);
+            const auto w2 = twiddle<inverse> (twiddleIndex * 2);
+            const auto w3 = twiddle<inverse> (twiddleIndex * 3);
+
+            if (lanes > 1)
+            {
+                for (int q = 0; q < s; ++q)
+                    radix4Butterfly<inverse, VectorAccess> (x, y, (q + s * p) * lanes, s * m * lanes,
+                                                            (q + s * 4 * p) * lanes, s * lanes, w1, w2, w3);
+
+                continue;
+            }
+
+            int q = 0;
+
+            // When the stride is a multiple of the SIMD width, the inner loop is
+            // over contiguous, aligned data and the twiddles are constant
+            if (s >= numLanes)
+                for (; q < s; q += numLanes)
+                    radix4Butterfly<inverse, VectorAccess> (x, y, q + s * p, s * m, q + s * 4 * p, s, w1, w2, w3);
+
+            for (; q < s; ++q)
+                radix4Butterfly<inverse, ScalarAccess> (x, y, q + s * p, s * m, q + s * 4 * p, s, w1, w2, w3);
+        }
+    }
+
+    // The offsets are in floats, so that the same code can operate both within
+    // a single channel and across several interleaved channels.
+    template <bool inverse, typename Access>
+    static void radix4Butterfly (SplitComplex x, SplitComplex y, int in, int inStep, int out, int outStep,
+                                 Complex<float> w1, Complex<float> w2, Complex<float> w3) noexcept
+    {
+        const auto ar = Access::load (x.re + in),              ai = Access::load (x.im + in);
+        const auto br = Access::load (x.re + in + inStep),     bi = Access::load (x.im + in + inStep);
+        const auto cr = Access::load (x.re + in + 2 * inStep), ci = Access::load (x.im + in + 2 * inStep);
+        const auto dr = Access::load (x.re + in + 3 * inStep), di = Access::load (x.im + in + 3 * inStep);
+
+        const auto apcr = ar + cr, apci = ai + ci;
+        const auto amcr = ar - cr, amci = ai - ci;
+        const auto bpdr = br + dr, bpdi = bi + di;
+
+        // multiply (b - d) by j, which is i for the forward transform and -i for the inverse
+        const auto jbmdr = inverse ? bi - di : di - bi;
+        const auto jbmdi = inverse ? dr - br : br - dr;
+
+        const auto store = [&] (int index, typename Access::Element re, typename Access::Element im, Complex<float> w)
+        {
+            Access::store (re * w.real() - im * w.imag(), y.re + out + index * outStep);
+            Access::store (re * w.imag() + im * w.real(), y.im + out + index * outStep);
+        };
+
+        Access::store (apcr + bpdr, y.re + out);
+        Access::store (apci + bpdi, y.im + out);
+
+        store (1, amcr - jbmdr, amci - jbmdi, w1);
+        store (2, apcr - bpdr,  apci - bpdi,  w2);
+        store (3, amcr + jbmdr, amci + jbmdi, w3);
+    }
+
+    static void radix2Pass (SplitComplex x, SplitComplex y, int s, int lanes) noexcept
+    {
+        if (lanes > 1)
+        {
+            for (int q = 0; q < s; ++q)
+                radix2Butterfly<VectorAccess> (x, y, q * lanes, s * lanes);
+
+            return;
+        }
+
+        int q = 0;
+
+        if (s >= numLanes)
+            for (; q < s; q += numLanes)
+                radix2Butterfly<VectorAccess> (x, y, q, s);
+
+        for (; q < s; ++q)
+            radix2Butterfly<ScalarAccess> (x, y, q, s);
+    }
+
+    template <typename Access>
+    static void radix2Butterfly (SplitComplex x, SplitComplex y, int index, int step) noexcept
+    {
+        const auto ar = Access::load (x.re + index),        ai = Access::load (x.im + index);
+        const auto br = Access::load (x.re + index + step), bi = Access::load (x.im + index + step);
+
+        Access::store (ar + br, y.re + index);
+        Access::store (ai + bi, y.im + index);
+        Access::store (ar - br, y.re + index + step);
+        Access::store (ai - bi, y.im + index + step);
+    }
+
+    template <bool inverse>
+    Complex<float> twiddle (int index) const noexcept
+    {
+        const auto w = complexTwiddles[index];
+        return inverse ? std::conj (w) : w;
+    }
+
+    //==============================================================================
+    SpinLock processLock;
+    const int size;
+    HeapBlock<Complex<float>> complexTwiddles, realTwiddles;
+    HeapBlock<float> workspace, multichannelWorkspace;
+    float* buffers[4];
+    float* multichannelBuffers[4] {};
+};
+
+FFT::EngineImpl<FFTStockham> fftStockham;
+#endif
+
 //==============================================================================
 //==============================================================================
 #if (JUCE_MAC || JUCE_IOS) && JUCE_USE_VDSP_FRAMEWORK
@@ -974,6 +1445,56 @@ void FFT::performRealOnlyInverseTransform (float* inputOutputData) const noexcep
         engine->performRealOnlyInverseTransform (inputOutputData);
 }
 
+void FFT::performRealOnlyForwardTransform (float* const* channels, int numChannels,
+                                           bool ignoreNegativeFreqs) const noexcept
+{
+    if (engine != nullptr)
+        engine->performMultichannelRealOnlyForwardTransform (channels, numChannels, ignoreNegativeFreqs);
+}
+
+void FFT::performRealOnlyInverseTransform (float* const* channels, int numChannels) const noexcept
+{
+    if (engine != nullptr)
+        engine->performMultichannelRealOnlyInverseTransform (channels, numChannels);
+}
+
+template <typename Fn>
+static void forEachChannelChunk (const AudioBlock<float>& block, Fn&& fn)
+{
+    constexpr size_t maxChannelsPerChunk = 32;
+    float* channels[maxChannelsPerChunk];
+
+    for (size_t first = 0; first < block.getNumChannels(); first += maxChannelsPerChunk)
+    {
+        const auto numInChunk = jmin (maxChannelsPerChunk, block.getNumChannels() - first);
+
+        for (size_t i = 0; i < numInChunk; ++i)
+            channels[i] = block.getChannelPointer (first + i);
+
+        fn (channels, (int) numInChunk);
+    }
+}
+
+void FFT::performRealOnlyForwardTransform (const AudioBlock<float>& block, bool ignoreNegativeFreqs) const noexcept
+{
+    jassert (block.getNumSamples() >= (size_t) (2 * size));
+
+    forEachChannelChunk (block, [&] (float* const* channels, int numChannels)
+    {
+        performRealOnlyForwardTransform (channels, numChannels, ignoreNegativeFreqs);
+    });
+}
+
+void FFT::performRealOnlyInverseTransform (const AudioBlock<float>& block) const noexcept
+{
+    jassert (block.getNumSamples() >= (size_t) (2 * size));
+
+    forEachChannelChunk (block, [&] (float* const* channels, int numChannels)
+    {
+        performRealOnlyInverseTransform (channels, numChannels);
+    });
+}
+
 void FFT::performFrequencyOnlyForwardTransform (float* inputOutputData) const noexcept
 {
     if (size == 1)
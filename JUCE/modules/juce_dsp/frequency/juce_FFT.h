@@ -96,6 +96,43 @@ public:
     */
     void performRealOnlyInverseTransform (float* inputOutputData) const noexcept;
 
+    /** Performs in-place forward transforms on several blocks of real data.
+
+        This is equivalent to calling the single-channel version of
+        performRealOnlyForwardTransform() on each of the numChannels arrays,
+        but some FFT engines can transform several channels in parallel, which
+        can be considerably faster for smaller transform sizes.
+
+        Each array must have the same layout and size as the single-channel version.
+        The channels must be stored in separate arrays: interleaved data needs to be
+        de-interleaved before calling this, e.g. with AudioDataConverters::deinterleaveSamples().
+    */
+    void performRealOnlyForwardTransform (float* const* inputOutputData,
+                                          int numChannels,
+                                          bool dontCalculateNegativeFrequencies = false) const noexcept;
+
+    /** Performs in-place inverse transforms on several blocks of data created in
+        performRealOnlyForwardTransform().
+
+        Each array must have the same layout and size as the single-channel version.
+    */
+    void performRealOnlyInverseTransform (float* const* inputOutputData, int numChannels) const noexcept;
+
+    /** Performs in-place forward transforms on all of the channels of an AudioBlock.
+        The block must contain at least 2 * getSize() samples.
+
+        @see performRealOnlyForwardTransform
+    */
+    void performRealOnlyForwardTransform (const AudioBlock<float>& inputOutputData,
+                                          bool dontCalculateNegativeFrequencies = false) const noexcept;
+
+    /** Performs in-place inverse transforms on all of the channels of an AudioBlock.
+        The block must contain at least 2 * getSize() samples.
+
+        @see performRealOnlyInverseTransform
+    */
+    void performRealOnlyInverseTransform (const AudioBlock<float>& inputOutputData) const noexcept;
+
     /** Takes an array and simply transforms it to the magnitude frequency response
         spectrum. This may be handy for things like frequency displays or analysis.
         The size of the array passed in must be 2 * getSize().
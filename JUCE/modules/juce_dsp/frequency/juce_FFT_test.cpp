@@ -192,6 +192,98 @@ struct FFTUnitTest  : public UnitTest
         }
     };
 
+    struct LargeTransformTest
+    {
+        static void run (FFTUnitTest& u)
+        {
+            Random random (378272);
+
+            for (size_t order = 9; order <= 15; ++order)
+            {
+                auto n = (1u << order);
+
+                FFT fft ((int) order);
+
+                HeapBlock<Complex<float>> input (n), output (n), roundTrip (n);
+
+                fillRandom (random, input.getData(), n);
+                fft.perform (input.getData(), output.getData(), false);
+
+                if (order <= 10)
+                {
+                    // A direct DFT in double precision, which costs O(n^2), so only the smaller sizes are checked
+                    HeapBlock<Complex<float>> reference (n);
+
+                    for (size_t k = 0; k < n; ++k)
+                    {
+                        Complex<double> sum;
+
+                        for (size_t i = 0; i < n; ++i)
+                            sum += Complex<double> (input[i]) * std::polar (1.0, -MathConstants<double>::twoPi * (double) ((i * k) % n) / (double) n);
+
+                        reference[k] = Complex<float> (sum);
+                    }
+
+                    u.expect (checkArrayIsSimilar (output.getData(), reference.getData(), n));
+                }
+
+                fft.perform (output.getData(), roundTrip.getData(), true);
+                u.expect (checkArrayIsSimilar (roundTrip.getData(), input.getData(), n));
+
+                HeapBlock<float> realInput (n), realData (n << 1);
+
+                fillRandom (random, realInput.getData(), n);
+                zeromem (realData.getData(), sizeof (float) * (n << 1));
+                memcpy (realData.getData(), realInput.getData(), sizeof (float) * n);
+
+                fft.performRealOnlyForwardTransform (realData.getData(), true);
+                fft.performRealOnlyInverseTransform (realData.getData());
+                u.expect (checkArrayIsSimilar (realData.getData(), realInput.getData(), n));
+            }
+        }
+    };
+
+    struct MultichannelTest
+    {
+        static void run (FFTUnitTest& u)
+        {
+            Random random (378272);
+
+            for (size_t order = 0; order <= 11; ++order)
+            {
+                auto n = (1u << order);
+
+                FFT fft ((int) order);
+
+                for (auto numChannels : { 1, 3, 8, 13 })
+                {
+                    AudioBuffer<float> input (numChannels, (int) n << 1), output (numChannels, (int) n << 1);
+                    input.clear();
+
+                    for (auto channel = 0; channel < numChannels; ++channel)
+                        fillRandom (random, input.getWritePointer (channel), n);
+
+                    output.makeCopyOf (input);
+                    fft.performRealOnlyForwardTransform (output.getArrayOfWritePointers(), numChannels);
+
+                    for (auto channel = 0; channel < numChannels; ++channel)
+                    {
+                        HeapBlock<float> reference (n << 1, true);
+                        memcpy (reference.getData(), input.getReadPointer (channel), n * sizeof (float));
+                        fft.performRealOnlyForwardTransform (reference.getData());
+
+                        u.expect (checkArrayIsSimilar (output.getWritePointer (channel), reference.getData(), n << 1));
+                    }
+
+                    fft.performRealOnlyInverseTransform (AudioBlock<float> (output));
+
+                    for (auto channel = 0; channel < numChannels; ++channel)
+                        u.expect (checkArrayIsSimilar (output.getWritePointer (channel), input.getWritePointer (channel), n));
+                }
+            }
+        }
+    };
+
     template <class TheTest>
     void runTestForAllTypes (const char* unitTestName)
     {
@@ -205,10 +297,72 @@ struct FFTUnitTest  : public UnitTest
         runTestForAllTypes<RealTest> ("Real input numbers Test");
         runTestForAllTypes<FrequencyOnlyTest> ("Frequency only Test");
         runTestForAllTypes<ComplexTest> ("Complex input numbers Test");
+        runTestForAllTypes<LargeTransformTest> ("Large transforms Test");
+        runTestForAllTypes<MultichannelTest> ("Multichannel real input numbers Test");
     }
 };
 
 static FFTUnitTest fftUnitTest;
 
+//==============================================================================
+struct FFTBenchmark  : public UnitTest
+{
+    FFTBenchmark()
+        : UnitTest ("FFT benchmark", UnitTestCategories::benchmarks)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Multichannel real-only transforms against a loop over the channels");
+
+        Random random (378272);
+
+        for (auto order : { 6, 8, 10 })
+        {
+            constexpr auto numChannels = 32;
+            const auto n = 1 << order;
+            const auto numIterations = (1 << 18) >> order;
+
+            FFT fft (order);
+            AudioBuffer<float> buffer (numChannels, n << 1);
+            buffer.clear();
+
+            for (auto channel = 0; channel < numChannels; ++channel)
+                FFTUnitTest::fillRandom (random, buffer.getWritePointer (channel), (size_t) n);
+
+            const auto timeInMs = [&] (auto&& transform)
+            {
+                const auto start = Time::getMillisecondCounterHiRes();
+
+                for (auto i = 0; i < numIterations; ++i)
+                    transform();
+
+                return Time::getMillisecondCounterHiRes() - start;
+            };
+
+            const auto loopTime = timeInMs ([&]
+            {
+                for (auto channel = 0; channel < numChannels; ++channel)
+                {
+                    fft.performRealOnlyForwardTransform (buffer.getWritePointer (channel), true);
+                    fft.performRealOnlyInverseTransform (buffer.getWritePointer (channel));
+                }
+            });
+
+            const auto multichannelTime = timeInMs ([&]
+            {
+                fft.performRealOnlyForwardTransform (buffer.getArrayOfWritePointers(), numChannels, true);
+                fft.performRealOnlyInverseTransform (buffer.getArrayOfWritePointers(), numChannels);
+            });
+
+            logMessage ("FFT order " + String (order) + ", " + String (numChannels) + " channels: "
+                        + String (loopTime, 2) + " ms per channel, "
+                        + String (multichannelTime, 2) + " ms multichannel");
+        }
+    }
+};
+
+static FFTBenchmark fftBenchmark;
+
 } // namespace dsp
 } // namespace juce
@@ -56,6 +56,7 @@
 
 #include "processors/juce_FIRFilter.cpp"
 #include "processors/juce_IIRFilter.cpp"
+#include "processors/juce_MultichannelIIRFilter.cpp"
 #include "processors/juce_FirstOrderTPTFilter.cpp"
 #include "processors/juce_Panner.cpp"
 #include "processors/juce_Oversampling.cpp"
@@ -64,6 +65,7 @@
 #include "processors/juce_DelayLine.cpp"
 #include "processors/juce_DryWetMixer.cpp"
 #include "processors/juce_StateVariableTPTFilter.cpp"
+#include "processors/juce_MultichannelStateVariableTPTFilter.cpp"
 #include "maths/juce_SpecialFunctions.cpp"
 #include "maths/juce_Matrix.cpp"
 #include "maths/juce_LookupTable.cpp"
@@ -72,11 +74,14 @@
 #include "frequency/juce_Windowing.cpp"
 #include "filter_design/juce_FilterDesign.cpp"
 #include "widgets/juce_LadderFilter.cpp"
+#include "widgets/juce_MultichannelLadderFilter.cpp"
 #include "widgets/juce_Compressor.cpp"
 #include "widgets/juce_NoiseGate.cpp"
 #include "widgets/juce_Limiter.cpp"
 #include "widgets/juce_Phaser.cpp"
 #include "widgets/juce_Chorus.cpp"
+#include "widgets/juce_WavetableOscillator.cpp"
+#include "widgets/juce_FDNReverb.cpp"
 
 #if JUCE_USE_SIMD
  #if defined(__i386__) || defined(__amd64__) || defined(_M_X64) || defined(_X86_) || defined(_M_IX86)
@@ -104,6 +109,13 @@
  #include "containers/juce_FixedSizeFunction_test.cpp"
  #include "frequency/juce_Convolution_test.cpp"
  #include "frequency/juce_FFT_test.cpp"
+ #include "processors/juce_DelayLine_test.cpp"
  #include "processors/juce_FIRFilter_test.cpp"
+ #include "processors/juce_MultichannelIIRFilter_test.cpp"
+ #include "processors/juce_MultichannelStateVariableTPTFilter_test.cpp"
+ #include "processors/juce_Oversampling_test.cpp"
  #include "processors/juce_ProcessorChain_test.cpp"
+ #include "widgets/juce_FDNReverb_test.cpp"
+ #include "widgets/juce_MultichannelLadderFilter_test.cpp"
+ #include "widgets/juce_WavetableOscillator_test.cpp"
 #endif
@@ -249,6 +249,7 @@ namespace juce
 #include "processors/juce_ProcessorChain.h"
 #include "processors/juce_ProcessorDuplicator.h"
 #include "processors/juce_IIRFilter.h"
+#include "processors/juce_MultichannelIIRFilter.h"
 #include "processors/juce_FIRFilter.h"
 #include "processors/juce_StateVariableFilter.h"
 #include "processors/juce_FirstOrderTPTFilter.h"
@@ -259,16 +260,20 @@ namespace juce
 #include "processors/juce_LinkwitzRileyFilter.h"
 #include "processors/juce_DryWetMixer.h"
 #include "processors/juce_StateVariableTPTFilter.h"
+#include "processors/juce_MultichannelStateVariableTPTFilter.h"
 #include "frequency/juce_FFT.h"
 #include "frequency/juce_Convolution.h"
 #include "frequency/juce_Windowing.h"
 #include "filter_design/juce_FilterDesign.h"
 #include "widgets/juce_Reverb.h"
+#include "widgets/juce_FDNReverb.h"
 #include "widgets/juce_Bias.h"
 #include "widgets/juce_Gain.h"
 #include "widgets/juce_WaveShaper.h"
 #include "widgets/juce_Oscillator.h"
+#include "widgets/juce_WavetableOscillator.h"
 #include "widgets/juce_LadderFilter.h"
+#include "widgets/juce_MultichannelLadderFilter.h"
 #include "widgets/juce_Compressor.h"
 #include "widgets/juce_NoiseGate.h"
 #include "widgets/juce_Limiter.h"
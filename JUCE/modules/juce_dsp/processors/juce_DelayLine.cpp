@@ -40,7 +40,7 @@ DelayLine<SampleType, InterpolationType>::DelayLine (int maximumDelayInSamples)
 {
     jassert (maximumDelayInSamples >= 0);
 
-    totalSize = jmax (4, maximumDelayInSamples + 1);
+    totalSize = nextPowerOfTwo (jmax (4, maximumDelayInSamples + 1));
     sampleRate = 44100.0;
 }
 
@@ -97,7 +97,7 @@ template <typename SampleType, typename InterpolationType>
 void DelayLine<SampleType, InterpolationType>::pushSample (int channel, SampleType sample)
 {
     bufferData.setSample (channel, writePos[(size_t) channel], sample);
-    writePos[(size_t) channel] = (writePos[(size_t) channel] + totalSize - 1) % totalSize;
+    writePos[(size_t) channel] = (writePos[(size_t) channel] + totalSize - 1) & (totalSize - 1);
 }
 
 template <typename SampleType, typename InterpolationType>
@@ -109,11 +109,107 @@ SampleType DelayLine<SampleType, InterpolationType>::popSample (int channel, Sam
     auto result = interpolateSample (channel);
 
     if (updateReadPointer)
-        readPos[(size_t) channel] = (readPos[(size_t) channel] + totalSize - 1) % totalSize;
+        readPos[(size_t) channel] = (readPos[(size_t) channel] + totalSize - 1) & (totalSize - 1);
 
     return result;
 }
 
+template <typename SampleType, typename InterpolationType>
+void DelayLine<SampleType, InterpolationType>::readTaps (int channel, const SampleType* delaysInSamples,
+                                                         SampleType* destination, int numTaps) const
+{
+    auto* samples = bufferData.getReadPointer (channel);
+    auto position = readPos[(size_t) channel];
+
+    for (int i = 0; i < numTaps; ++i)
+    {
+        int tapInt;
+        SampleType tapFrac;
+        splitDelay (delaysInSamples[i], tapInt, tapFrac);
+
+        destination[i] = interpolateAt (samples, position + tapInt, tapFrac);
+    }
+}
+
+//==============================================================================
+template <typename SampleType, typename InterpolationType>
+void DelayLine<SampleType, InterpolationType>::processChannel (int channel, const SampleType* input, SampleType* output,
+                                                               size_t numSamples, const SampleType* delaysInSamples) noexcept
+{
+    // Thiran interpolation is recursive, so it has to go through the usual path
+    if (std::is_same<InterpolationType, DelayLineInterpolationTypes::Thiran>::value)
+    {
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            pushSample (channel, input[i]);
+            output[i] = popSample (channel, delaysInSamples != nullptr ? delaysInSamples[i] : (SampleType) -1);
+        }
+
+        return;
+    }
+
+    // The write and read positions move backwards through the buffer together, so
+    // keeping them in locals and wrapping them with a mask lets this loop run without
+    // any function calls or divisions.
+    auto* samples = bufferData.getWritePointer (channel);
+    auto mask = totalSize - 1;
+    auto writeIndex = writePos[(size_t) channel];
+    auto readIndex  = readPos[(size_t) channel];
+
+    if (delaysInSamples == nullptr)
+    {
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            samples[writeIndex] = input[i];
+            output[i] = interpolateAt (samples, readIndex + delayInt, delayFrac);
+
+            writeIndex = (writeIndex + mask) & mask;
+            readIndex  = (readIndex  + mask) & mask;
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            int sampleDelayInt;
+            SampleType sampleDelayFrac;
+            splitDelay (delaysInSamples[i], sampleDelayInt, sampleDelayFrac);
+
+            samples[writeIndex] = input[i];
+            output[i] = interpolateAt (samples, readIndex + sampleDelayInt, sampleDelayFrac);
+
+            writeIndex = (writeIndex + mask) & mask;
+            readIndex  = (readIndex  + mask) & mask;
+        }
+
+        if (numSamples > 0)
+            setDelay (delaysInSamples[numSamples - 1]);
+    }
+
+    writePos[(size_t) channel] = writeIndex;
+    readPos[(size_t) channel]  = readIndex;
+}
+
+template <typename SampleType, typename InterpolationType>
+void DelayLine<SampleType, InterpolationType>::splitDelay (SampleType delayInSamples, int& integerPart,
+                                                           SampleType& fractionalPart) const noexcept
+{
+    auto upperLimit = (SampleType) (totalSize - 1);
+    jassert (isPositiveAndNotGreaterThan (delayInSamples, upperLimit));
+
+    auto clippedDelay = jlimit ((SampleType) 0, upperLimit, delayInSamples);
+    integerPart    = static_cast<int> (clippedDelay);
+    fractionalPart = clippedDelay - (SampleType) integerPart;
+
+    // matches the offset that updateInternalVariables applies, so that the
+    // interpolator has a sample on either side of the read position
+    if (std::is_same<InterpolationType, DelayLineInterpolationTypes::Lagrange3rd>::value && integerPart >= 1)
+    {
+        fractionalPart++;
+        integerPart--;
+    }
+}
+
 //==============================================================================
 template class DelayLine<float,  DelayLineInterpolationTypes::None>;
 template class DelayLine<double, DelayLineInterpolationTypes::None>;
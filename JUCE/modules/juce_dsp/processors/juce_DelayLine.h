@@ -86,6 +86,9 @@ namespace DelayLineInterpolationTypes
     Note: If you intend to change the delay in real time, you may want to smooth
     changes to the delay systematically using either a ramp or a low-pass filter.
 
+    The delay line's buffer is rounded up to a power of two, so the maximum delay
+    may be a little larger than the size you ask for.
+
     @see SmoothedValue, FirstOrderTPTFilter
 
     @tags{DSP}
@@ -145,6 +148,25 @@ public:
     */
     SampleType popSample (int channel, SampleType delayInSamples = -1, bool updateReadPointer = true);
 
+    /** Reads several taps from one channel of the delay line at once.
+
+        The taps are read from the same position as the next call to popSample would
+        use, and the read pointer isn't moved, so this is a cheap way to get many
+        outputs for each sample you push. Unlike popSample, this doesn't change the
+        delay set with setDelay.
+
+        Thiran interpolation needs to keep state for every tap, so with that
+        interpolation type the taps are interpolated linearly.
+
+        @param channel              the target channel for the delay line.
+        @param delaysInSamples      the fractional delay of each tap.
+        @param destination          receives one output sample for each tap.
+        @param numTaps              the number of taps to read.
+
+        @see popSample
+    */
+    void readTaps (int channel, const SampleType* delaysInSamples, SampleType* destination, int numTaps) const;
+
     //==============================================================================
     /** Processes the input and output samples supplied in the processing context.
 
@@ -172,98 +194,121 @@ public:
         }
 
         for (size_t channel = 0; channel < numChannels; ++channel)
+            processChannel ((int) channel, inputBlock.getChannelPointer (channel),
+                            outputBlock.getChannelPointer (channel), numSamples, nullptr);
+    }
+
+    /** Processes the context with a delay that can change on every sample.
+
+        This does the same as calling setDelay, pushSample and popSample for each
+        sample, but much more quickly.
+
+        @param context          the context to process.
+        @param delaysInSamples  the fractional delay to use for each sample. It must
+                                have as many samples as the context, and either a
+                                single channel whose delays are used for every
+                                channel, or one channel for each channel in the
+                                context.
+
+        After processing, the delay is left at the last value that was used.
+
+        @see setDelay
+    */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context, const AudioBlock<const SampleType>& delaysInSamples) noexcept
+    {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock      = context.getOutputBlock();
+        const auto numChannels = outputBlock.getNumChannels();
+        const auto numSamples  = outputBlock.getNumSamples();
+
+        jassert (inputBlock.getNumChannels() == numChannels);
+        jassert (inputBlock.getNumChannels() == writePos.size());
+        jassert (inputBlock.getNumSamples()  == numSamples);
+        jassert (delaysInSamples.getNumChannels() == 1 || delaysInSamples.getNumChannels() == numChannels);
+        jassert (delaysInSamples.getNumSamples() == numSamples);
+
+        if (context.isBypassed)
         {
-            auto* inputSamples = inputBlock.getChannelPointer (channel);
-            auto* outputSamples = outputBlock.getChannelPointer (channel);
-
-            for (size_t i = 0; i < numSamples; ++i)
-            {
-                pushSample ((int) channel, inputSamples[i]);
-                outputSamples[i] = popSample ((int) channel);
-            }
+            outputBlock.copyFrom (inputBlock);
+            return;
         }
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+            processChannel ((int) channel, inputBlock.getChannelPointer (channel),
+                            outputBlock.getChannelPointer (channel), numSamples,
+                            delaysInSamples.getChannelPointer (delaysInSamples.getNumChannels() == 1 ? 0 : channel));
     }
 
 private:
+    //==============================================================================
+    void processChannel (int channel, const SampleType* input, SampleType* output,
+                         size_t numSamples, const SampleType* delaysInSamples) noexcept;
+
+    void splitDelay (SampleType delayInSamples, int& integerPart, SampleType& fractionalPart) const noexcept;
+
     //==============================================================================
     template <typename T = InterpolationType>
     typename std::enable_if <std::is_same <T, DelayLineInterpolationTypes::None>::value, SampleType>::type
-    interpolateSample (int channel) const
+    interpolateAt (const SampleType* samples, int index, SampleType) const noexcept
     {
-        auto index = (readPos[(size_t) channel] + delayInt) % totalSize;
-        return bufferData.getSample (channel, index);
+        return samples[index & (totalSize - 1)];
     }
 
     template <typename T = InterpolationType>
-    typename std::enable_if <std::is_same <T, DelayLineInterpolationTypes::Linear>::value, SampleType>::type
-    interpolateSample (int channel) const
+    typename std::enable_if <std::is_same <T, DelayLineInterpolationTypes::Linear>::value
+                              || std::is_same <T, DelayLineInterpolationTypes::Thiran>::value, SampleType>::type
+    interpolateAt (const SampleType* samples, int index, SampleType frac) const noexcept
     {
-        auto index1 = readPos[(size_t) channel] + delayInt;
-        auto index2 = index1 + 1;
+        auto mask = totalSize - 1;
 
-        if (index2 >= totalSize)
-        {
-            index1 %= totalSize;
-            index2 %= totalSize;
-        }
+        auto value1 = samples[index & mask];
+        auto value2 = samples[(index + 1) & mask];
 
-        auto value1 = bufferData.getSample (channel, index1);
-        auto value2 = bufferData.getSample (channel, index2);
-
-        return value1 + delayFrac * (value2 - value1);
+        return value1 + frac * (value2 - value1);
     }
 
     template <typename T = InterpolationType>
     typename std::enable_if <std::is_same <T, DelayLineInterpolationTypes::Lagrange3rd>::value, SampleType>::type
-    interpolateSample (int channel) const
+    interpolateAt (const SampleType* samples, int index, SampleType frac) const noexcept
     {
-        auto index1 = readPos[(size_t) channel] + delayInt;
-        auto index2 = index1 + 1;
-        auto index3 = index2 + 1;
-        auto index4 = index3 + 1;
-
-        if (index4 >= totalSize)
-        {
-            index1 %= totalSize;
-            index2 %= totalSize;
-            index3 %= totalSize;
-            index4 %= totalSize;
-        }
-
-        auto* samples = bufferData.getReadPointer (channel);
+        auto mask = totalSize - 1;
 
-        auto value1 = samples[index1];
-        auto value2 = samples[index2];
-        auto value3 = samples[index3];
-        auto value4 = samples[index4];
+        auto value1 = samples[index & mask];
+        auto value2 = samples[(index + 1) & mask];
+        auto value3 = samples[(index + 2) & mask];
+        auto value4 = samples[(index + 3) & mask];
 
-        auto d1 = delayFrac - 1.f;
-        auto d2 = delayFrac - 2.f;
-        auto d3 = delayFrac - 3.f;
+        auto d1 = frac - 1.f;
+        auto d2 = frac - 2.f;
+        auto d3 = frac - 3.f;
 
         auto c1 = -d1 * d2 * d3 / 6.f;
         auto c2 = d2 * d3 * 0.5f;
         auto c3 = -d1 * d3 * 0.5f;
         auto c4 = d1 * d2 / 6.f;
 
-        return value1 * c1 + delayFrac * (value2 * c2 + value3 * c3 + value4 * c4);
+        return value1 * c1 + frac * (value2 * c2 + value3 * c3 + value4 * c4);
+    }
+
+    //==============================================================================
+    template <typename T = InterpolationType>
+    typename std::enable_if <! std::is_same <T, DelayLineInterpolationTypes::Thiran>::value, SampleType>::type
+    interpolateSample (int channel) const
+    {
+        return interpolateAt (bufferData.getReadPointer (channel), readPos[(size_t) channel] + delayInt, delayFrac);
     }
 
     template <typename T = InterpolationType>
     typename std::enable_if <std::is_same <T, DelayLineInterpolationTypes::Thiran>::value, SampleType>::type
     interpolateSample (int channel)
     {
-        auto index1 = readPos[(size_t) channel] + delayInt;
-        auto index2 = index1 + 1;
-
-        if (index2 >= totalSize)
-        {
-            index1 %= totalSize;
-            index2 %= totalSize;
-        }
+        auto* samples = bufferData.getReadPointer (channel);
+        auto index = readPos[(size_t) channel] + delayInt;
+        auto mask = totalSize - 1;
 
-        auto value1 = bufferData.getSample (channel, index1);
-        auto value2 = bufferData.getSample (channel, index2);
+        auto value1 = samples[index & mask];
+        auto value2 = samples[(index + 1) & mask];
 
         auto output = delayFrac == 0 ? value1 : value2 + alpha * (value1 - v[(size_t) channel]);
         v[(size_t) channel] = output;
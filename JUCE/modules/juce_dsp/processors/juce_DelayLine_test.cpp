@@ -0,0 +1,194 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+namespace juce
+{
+namespace dsp
+{
+
+class DelayLineTest : public UnitTest
+{
+    static void fillRandom (Random& random, AudioBuffer<float>& buffer)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+    }
+
+    static float getMaxDifference (const AudioBuffer<float>& a, const AudioBuffer<float>& b)
+    {
+        auto maxDifference = 0.0f;
+
+        for (int ch = 0; ch < a.getNumChannels(); ++ch)
+            for (int i = 0; i < a.getNumSamples(); ++i)
+                maxDifference = jmax (maxDifference, std::abs (a.getSample (ch, i) - b.getSample (ch, i)));
+
+        return maxDifference;
+    }
+
+    // processes the buffer with pushSample and popSample, one sample at a time
+    template <typename InterpolationType>
+    static void processSampleBySample (DelayLine<float, InterpolationType>& delayLine, AudioBuffer<float>& buffer,
+                                       const AudioBuffer<float>* delays)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                if (delays != nullptr)
+                    delayLine.setDelay (delays->getSample (delays->getNumChannels() == 1 ? 0 : ch, i));
+
+                delayLine.pushSample (ch, buffer.getSample (ch, i));
+                buffer.setSample (ch, i, delayLine.popSample (ch));
+            }
+        }
+    }
+
+    template <typename InterpolationType>
+    void runBlockTests (const String& interpolationName)
+    {
+        beginTest ("Block processing matches sample by sample processing: " + interpolationName);
+
+        constexpr int numChannels = 2;
+        constexpr int blockSize = 300;
+        const ProcessSpec spec { 44100.0, (uint32) blockSize, (uint32) numChannels };
+
+        Random random (4321);
+        AudioBuffer<float> input (numChannels, blockSize);
+
+        for (auto numDelayChannels : { 0, 1, numChannels })
+        {
+            DelayLine<float, InterpolationType> reference (200), delayLine (200);
+            reference.prepare (spec);
+            delayLine.prepare (spec);
+            reference.setDelay (37.3f);
+            delayLine.setDelay (37.3f);
+
+            AudioBuffer<float> delays (jmax (1, numDelayChannels), blockSize);
+
+            // enough blocks to wrap around the buffer several times
+            for (int block = 0; block < 5; ++block)
+            {
+                fillRandom (random, input);
+
+                for (int ch = 0; ch < delays.getNumChannels(); ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                        delays.setSample (ch, i, 1.0f + 150.0f * random.nextFloat());
+
+                AudioBuffer<float> referenceOutput (input), output (input);
+                processSampleBySample (reference, referenceOutput, numDelayChannels > 0 ? &delays : nullptr);
+
+                AudioBlock<float> outputBlock (output);
+
+                if (numDelayChannels > 0)
+                {
+                    AudioBlock<const float> delaysBlock (delays);
+
+                    if (block % 2 == 0)
+                    {
+                        delayLine.process (ProcessContextReplacing<float> (outputBlock), delaysBlock);
+                    }
+                    else
+                    {
+                        AudioBlock<const float> inputBlock (input);
+                        delayLine.process (ProcessContextNonReplacing<float> (inputBlock, outputBlock), delaysBlock);
+                    }
+
+                    expectEquals (delayLine.getDelay(), delays.getSample (delays.getNumChannels() - 1, blockSize - 1));
+                }
+                else
+                {
+                    delayLine.process (ProcessContextReplacing<float> (outputBlock));
+                }
+
+                expectLessThan (getMaxDifference (referenceOutput, output), 1.0e-6f);
+            }
+        }
+
+        beginTest ("Taps match popSample: " + interpolationName);
+        {
+            DelayLine<float, InterpolationType> delayLine (100);
+            delayLine.prepare ({ 44100.0, 512, 1 });
+            delayLine.setDelay (10.0f);
+
+            const float tapDelays[] = { 0.0f, 1.5f, 7.25f, 33.0f, 99.0f };
+            constexpr int numTaps = numElementsInArray (tapDelays);
+
+            for (int i = 0; i < 150; ++i)
+            {
+                delayLine.pushSample (0, random.nextFloat());
+
+                float taps[numTaps];
+                delayLine.readTaps (0, tapDelays, taps, numTaps);
+                expectEquals (delayLine.getDelay(), 10.0f);
+
+                // Thiran falls back to linear interpolation for taps
+                if (! std::is_same<InterpolationType, DelayLineInterpolationTypes::Thiran>::value)
+                    for (int tap = 0; tap < numTaps; ++tap)
+                        expectEquals (taps[tap], delayLine.popSample (0, tapDelays[tap], false));
+
+                delayLine.popSample (0, 10.0f);
+            }
+        }
+    }
+
+public:
+    DelayLineTest()
+        : UnitTest ("DelayLine", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Integer delays are exact");
+        {
+            for (auto maximumDelay : { 0, 3, 4, 100, 1000 })
+            {
+                DelayLine<float, DelayLineInterpolationTypes::None> delayLine (maximumDelay);
+                delayLine.prepare ({ 44100.0, 512, 1 });
+                delayLine.setDelay ((float) maximumDelay);
+
+                AudioBuffer<float> buffer (1, 3000);
+
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    buffer.setSample (0, i, (float) (i + 1));
+
+                AudioBlock<float> block (buffer);
+                delayLine.process (ProcessContextReplacing<float> (block));
+
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    expectEquals (buffer.getSample (0, i), (float) jmax (0, i + 1 - maximumDelay));
+            }
+        }
+
+        runBlockTests<DelayLineInterpolationTypes::None> ("None");
+        runBlockTests<DelayLineInterpolationTypes::Linear> ("Linear");
+        runBlockTests<DelayLineInterpolationTypes::Lagrange3rd> ("Lagrange3rd");
+        runBlockTests<DelayLineInterpolationTypes::Thiran> ("Thiran");
+    }
+};
+
+static DelayLineTest delayLineUnitTest;
+
+} // namespace dsp
+} // namespace juce
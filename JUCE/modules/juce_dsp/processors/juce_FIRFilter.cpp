@@ -153,6 +153,128 @@ void FIR::Coefficients<NumericType>::Coefficients::normalise() noexcept
     FloatVectorOperations::multiply (coefs, magnitudeInv, static_cast<int> (n));
 }
 
+//==============================================================================
+FIR::detail::FrequencyDomainProcessor::FrequencyDomainProcessor (size_t numCoefficients)
+    : size (numCoefficients)
+{
+    // The head, processed in the time domain, gets longer with the filter so that
+    // the number of partitions of the tail stays reasonable
+    partitionSize = static_cast<size_t> (jlimit (32, 512, nextPowerOfTwo ((int) size) / 8));
+    jassert (size > partitionSize);
+
+    numPartitions = (size - partitionSize + partitionSize - 1) / partitionSize;
+    spectrumSize  = 2 * partitionSize + 2;
+
+    fft.reset (new FFT (roundToInt (std::log2 (2 * partitionSize))));
+
+    headMemory.malloc (2 * partitionSize + AlignedCoefficients<float>::padding + AlignedCoefficients<float>::numLanes);
+    headState = snapPointerToAlignment (headMemory.getData(), sizeof (float) * AlignedCoefficients<float>::numLanes);
+
+    tailCoefficients.calloc (size);
+    tailSpectra     .calloc (numPartitions * spectrumSize);
+    inputSpectra    .malloc (numPartitions * spectrumSize);
+    fftBuffer       .malloc (4 * partitionSize);
+    inputBuffer     .malloc (2 * partitionSize);
+    tailOutput      .malloc (partitionSize);
+
+    reset();
+}
+
+FIR::detail::FrequencyDomainProcessor::~FrequencyDomainProcessor() = default;
+
+void FIR::detail::FrequencyDomainProcessor::reset() noexcept
+{
+    zeromem (headState,    sizeof (float) * (2 * partitionSize + AlignedCoefficients<float>::padding));
+    zeromem (inputSpectra, sizeof (float) * numPartitions * spectrumSize);
+    zeromem (inputBuffer,  sizeof (float) * 2 * partitionSize);
+    zeromem (tailOutput,   sizeof (float) * partitionSize);
+
+    headPosition = 0;
+    inputIndex = 0;
+    currentSegment = 0;
+}
+
+void FIR::detail::FrequencyDomainProcessor::process (const float* fir, const float* input, float* output,
+                                                     size_t numSamples, bool isBypassed) noexcept
+{
+    headCoefficients.update (fir, partitionSize);
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        auto sample = input[i];
+
+        // Head, in the time domain with a mirrored state
+        headState[headPosition] = headState[headPosition + partitionSize] = sample;
+        auto out = headCoefficients.dotProduct (headState, headPosition) + tailOutput[inputIndex];
+        headPosition = (headPosition == 0 ? partitionSize - 1 : headPosition - 1);
+
+        // Tail, computed one partition in advance
+        inputBuffer[partitionSize + inputIndex] = sample;
+        output[i] = isBypassed ? sample : out;
+
+        if (++inputIndex == partitionSize)
+        {
+            processTailBlock (fir);
+            inputIndex = 0;
+        }
+    }
+}
+
+void FIR::detail::FrequencyDomainProcessor::processTailBlock (const float* fir) noexcept
+{
+    updateTailCoefficients (fir);
+
+    // Spectrum of the last two input blocks
+    auto* spectrum = inputSpectra + currentSegment * spectrumSize;
+
+    FloatVectorOperations::copy (fftBuffer, inputBuffer, (int) (2 * partitionSize));
+    FloatVectorOperations::clear (fftBuffer + 2 * partitionSize, (int) (2 * partitionSize));
+    fft->performRealOnlyForwardTransform (fftBuffer, true);
+    FloatVectorOperations::copy (spectrum, fftBuffer, (int) spectrumSize);
+
+    // Frequency domain delay line multiplied by the spectra of the partitions
+    FloatVectorOperations::clear (fftBuffer, (int) (4 * partitionSize));
+
+    for (size_t q = 0; q < numPartitions; ++q)
+    {
+        auto segment = (currentSegment + numPartitions - q) % numPartitions;
+        auto* x = inputSpectra + segment * spectrumSize;
+        auto* h = tailSpectra + q * spectrumSize;
+
+        for (size_t k = 0; k < spectrumSize; k += 2)
+        {
+            fftBuffer[k]     += x[k] * h[k]     - x[k + 1] * h[k + 1];
+            fftBuffer[k + 1] += x[k] * h[k + 1] + x[k + 1] * h[k];
+        }
+    }
+
+    // Overlap-save, keeping the last half of the circular convolution
+    fft->performRealOnlyInverseTransform (fftBuffer);
+    FloatVectorOperations::copy (tailOutput, fftBuffer + partitionSize, (int) partitionSize);
+    FloatVectorOperations::copy (inputBuffer, inputBuffer + partitionSize, (int) partitionSize);
+
+    currentSegment = (currentSegment + 1) % numPartitions;
+}
+
+void FIR::detail::FrequencyDomainProcessor::updateTailCoefficients (const float* fir) noexcept
+{
+    if (std::equal (fir + partitionSize, fir + size, tailCoefficients.get() + partitionSize))
+        return;
+
+    FloatVectorOperations::copy (tailCoefficients + partitionSize, fir + partitionSize, (int) (size - partitionSize));
+
+    for (size_t q = 0; q < numPartitions; ++q)
+    {
+        auto start = partitionSize * (q + 1);
+        auto num = jmin (partitionSize, size - start);
+
+        FloatVectorOperations::clear (fftBuffer, (int) (4 * partitionSize));
+        FloatVectorOperations::copy (fftBuffer, fir + start, (int) num);
+        fft->performRealOnlyForwardTransform (fftBuffer, true);
+        FloatVectorOperations::copy (tailSpectra + q * spectrumSize, fftBuffer, (int) spectrumSize);
+    }
+}
+
 //==============================================================================
 template struct FIR::Coefficients<float>;
 template struct FIR::Coefficients<double>;
@@ -28,6 +28,8 @@ namespace juce
 namespace dsp
 {
 
+class FFT;
+
 /**
     Classes for FIR filter processing.
 */
@@ -36,15 +38,136 @@ namespace FIR
     template <typename NumericType>
     struct Coefficients;
 
+   #ifndef DOXYGEN
+    namespace detail
+    {
+        //==============================================================================
+        /*  Holds one shifted copy of a set of FIR coefficients for each position of a
+            sample inside a SIMD register, so that the dot product of the coefficients
+            with a mirrored state buffer can be computed using aligned loads only.
+        */
+        template <typename NumericType>
+        class AlignedCoefficients
+        {
+        public:
+           #if JUCE_USE_SIMD
+            using Vec = SIMDRegister<NumericType>;
+            static constexpr size_t numLanes = Vec::SIMDNumElements;
+           #else
+            static constexpr size_t numLanes = 1;
+           #endif
+
+            /* The number of samples which must be readable after the end of a mirrored
+               state buffer of 2 * size samples, aligned on a SIMD register boundary.
+            */
+            static constexpr size_t padding = 2 * numLanes;
+
+            /* Copies the coefficients, unless they haven't changed since the last call. */
+            void update (const NumericType* fir, size_t newSize)
+            {
+                if (newSize == size && std::equal (fir, fir + size, banks))
+                    return;
+
+                if (newSize != size)
+                {
+                    size = newSize;
+                    bankSize = (size + 2 * numLanes - 2) / numLanes * numLanes;
+                    memory.malloc (bankSize * numLanes + numLanes);
+                    banks = snapPointerToAlignment (memory.getData(), sizeof (NumericType) * numLanes);
+                }
+
+                zeromem (banks, sizeof (NumericType) * bankSize * numLanes);
+
+                for (size_t r = 0; r < numLanes; ++r)
+                    std::copy (fir, fir + size, banks + r * bankSize + r);
+            }
+
+            /* Returns the sum of the state[p + k] * fir[k] products. */
+            NumericType dotProduct (const NumericType* state, size_t p) const noexcept
+            {
+                auto r = p % numLanes;
+                auto* s = state + (p - r);
+                auto* c = banks + r * bankSize;
+
+               #if JUCE_USE_SIMD
+                auto acc1 = Vec::expand (static_cast<NumericType> (0));
+                auto acc2 = Vec::expand (static_cast<NumericType> (0));
+                size_t i = 0;
+
+                for (; i + 2 * numLanes <= bankSize; i += 2 * numLanes)
+                {
+                    acc1 += Vec::fromRawArray (s + i) * Vec::fromRawArray (c + i);
+                    acc2 += Vec::fromRawArray (s + i + numLanes) * Vec::fromRawArray (c + i + numLanes);
+                }
+
+                if (i < bankSize)
+                    acc1 += Vec::fromRawArray (s + i) * Vec::fromRawArray (c + i);
+
+                return (acc1 + acc2).sum();
+               #else
+                NumericType out (0);
+
+                for (size_t i = 0; i < bankSize; ++i)
+                    out += s[i] * c[i];
+
+                return out;
+               #endif
+            }
+
+        private:
+            HeapBlock<NumericType> memory;
+            NumericType* banks = nullptr;
+            size_t size = 0, bankSize = 0;
+        };
+
+        //==============================================================================
+        /*  Performs zero latency FIR filtering of float samples, computing the first
+            coefficients in the time domain, and the remaining ones with a uniformly
+            partitioned overlap-save convolution.
+        */
+        class JUCE_API  FrequencyDomainProcessor
+        {
+        public:
+            explicit FrequencyDomainProcessor (size_t numCoefficients);
+            ~FrequencyDomainProcessor();
+
+            size_t getSize() const noexcept     { return size; }
+
+            void reset() noexcept;
+            void process (const float* fir, const float* input, float* output,
+                          size_t numSamples, bool isBypassed) noexcept;
+
+        private:
+            void processTailBlock (const float* fir) noexcept;
+            void updateTailCoefficients (const float* fir) noexcept;
+
+            size_t size, partitionSize, numPartitions, spectrumSize;
+            std::unique_ptr<FFT> fft;
+
+            AlignedCoefficients<float> headCoefficients;
+            HeapBlock<float> headMemory, tailCoefficients, tailSpectra, inputSpectra,
+                             fftBuffer, inputBuffer, tailOutput;
+            float* headState = nullptr;
+            size_t headPosition = 0, inputIndex = 0, currentSegment = 0;
+
+            JUCE_DECLARE_NON_COPYABLE (FrequencyDomainProcessor)
+        };
+    }
+   #endif
+
     //==============================================================================
     /**
-        A processing class that can perform FIR filtering on an audio signal, in the
-        time domain.
+        A processing class that can perform FIR filtering on an audio signal.
+
+        Short filters are processed in the time domain, using SIMD instructions for
+        the float and double sample types. Filters using the float sample type with
+        more coefficients than the FFT threshold (512 by default) are processed
+        partly in the frequency domain instead, which keeps the processing free of
+        latency but makes its cost grow much more slowly with the filter size.
 
-        Using FIRFilter is fast enough for FIRCoefficients with a size lower than 128
-        samples. For longer filters, it might be more efficient to use the class
-        Convolution instead, which does the same processing in the frequency domain
-        thanks to FFT.
+        For very long filters such as reverb impulse responses, the class Convolution
+        is still the better choice, as it can load and resample the responses in a
+        background thread.
 
         @see FIRFilter::Coefficients, Convolution, FFT
 
@@ -98,17 +221,45 @@ namespace FIR
 
                 if (newSize != size)
                 {
-                    memory.malloc (1 + jmax (newSize, size, static_cast<size_t> (128)));
+                    auto maxSize = jmax (newSize, size, static_cast<size_t> (128));
+                    memory.malloc (2 * maxSize + padding + numLanes);
 
-                    fifo = snapPointerToAlignment (memory.getData(), sizeof (SampleType));
+                    fifo = snapPointerToAlignment (memory.getData(), sizeof (NumericType) * numLanes);
                     size = newSize;
                 }
 
-                for (size_t i = 0; i < size; ++i)
+                for (size_t i = 0; i < 2 * size + padding; ++i)
                     fifo[i] = SampleType {0};
+
+                pos = 0;
+                alignedCoefficients.update (coefficients->getRawCoefficients(), size);
+
+                if (std::is_same<SampleType, float>::value && size > jmax (fftThreshold, static_cast<size_t> (64)))
+                {
+                    if (fftProcessor == nullptr || fftProcessor->getSize() != size)
+                        fftProcessor.reset (new detail::FrequencyDomainProcessor (size));
+                    else
+                        fftProcessor->reset();
+                }
+                else
+                {
+                    fftProcessor.reset();
+                }
             }
         }
 
+        /** Sets the number of coefficients above which a filter using the float sample
+            type does most of its processing in the frequency domain. The new value is
+            taken into account at the next call to prepare or reset, and filters with
+            64 coefficients or less are always processed in the time domain.
+        */
+        void setFFTThreshold (size_t newThreshold) noexcept     { fftThreshold = newThreshold; }
+
+        /** Returns the number of coefficients above which a filter using the float
+            sample type does most of its processing in the frequency domain.
+        */
+        size_t getFFTThreshold() const noexcept                 { return fftThreshold; }
+
         //==============================================================================
         /** The coefficients of the FIR filter. It's up to the caller to ensure that
             these coefficients are modified in a thread-safe way.
@@ -139,6 +290,9 @@ namespace FIR
             auto* src = inputBlock .getChannelPointer (0);
             auto* dst = outputBlock.getChannelPointer (0);
 
+            if (processInFrequencyDomain (src, dst, numSamples, context.isBypassed))
+                return;
+
             auto* fir = coefficients->getRawCoefficients();
             size_t p = pos;
 
@@ -146,14 +300,13 @@ namespace FIR
             {
                 for (size_t i = 0; i < numSamples; ++i)
                 {
-                    fifo[p] = dst[i] = src[i];
+                    fifo[p] = fifo[p + size] = dst[i] = src[i];
                     p = (p == 0 ? size - 1 : p - 1);
                 }
             }
             else
             {
-                for (size_t i = 0; i < numSamples; ++i)
-                    dst[i] = processSingleSample (src[i], fifo, fir, size, p);
+                processInTimeDomain (src, dst, numSamples, fir, p);
             }
 
             pos = p;
@@ -166,14 +319,26 @@ namespace FIR
         SampleType JUCE_VECTOR_CALLTYPE processSample (SampleType sample) noexcept
         {
             check();
+
+            SampleType output;
+
+            if (processInFrequencyDomain (&sample, &output, 1, false))
+                return output;
+
             return processSingleSample (sample, fifo, coefficients->getRawCoefficients(), size, pos);
         }
 
     private:
         //==============================================================================
+        static constexpr size_t numLanes = detail::AlignedCoefficients<NumericType>::numLanes;
+        static constexpr size_t padding  = detail::AlignedCoefficients<NumericType>::padding;
+
         HeapBlock<SampleType> memory;
         SampleType* fifo = nullptr;
-        size_t pos = 0, size = 0;
+        size_t pos = 0, size = 0, fftThreshold = 512;
+
+        detail::AlignedCoefficients<NumericType> alignedCoefficients;
+        std::unique_ptr<detail::FrequencyDomainProcessor> fftProcessor;
 
         //==============================================================================
         void check()
@@ -184,19 +349,55 @@ namespace FIR
                 reset();
         }
 
+        bool processInFrequencyDomain (const float* src, float* dst, size_t numSamples, bool isBypassed) noexcept
+        {
+            if (fftProcessor == nullptr)
+                return false;
+
+            fftProcessor->process (coefficients->getRawCoefficients(), src, dst, numSamples, isBypassed);
+            return true;
+        }
+
+        template <typename OtherSampleType>
+        bool processInFrequencyDomain (const OtherSampleType*, OtherSampleType*, size_t, bool) noexcept
+        {
+            return false;
+        }
+
+        // float and double samples: SIMD dot products with shifted copies of the coefficients
+        template <typename Type = SampleType>
+        typename std::enable_if<std::is_same<Type, NumericType>::value>::type
+            processInTimeDomain (const Type* src, Type* dst, size_t numSamples, const NumericType* fir, size_t& p)
+        {
+            alignedCoefficients.update (fir, size);
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                fifo[p] = fifo[p + size] = src[i];
+                dst[i] = alignedCoefficients.dotProduct (fifo, p);
+                p = (p == 0 ? size - 1 : p - 1);
+            }
+        }
+
+        // SIMDRegister samples, which are already processing several signals at once
+        template <typename Type = SampleType>
+        typename std::enable_if<! std::is_same<Type, NumericType>::value>::type
+            processInTimeDomain (const Type* src, Type* dst, size_t numSamples, const NumericType* fir, size_t& p) noexcept
+        {
+            for (size_t i = 0; i < numSamples; ++i)
+                dst[i] = processSingleSample (src[i], fifo, fir, size, p);
+        }
+
         static SampleType JUCE_VECTOR_CALLTYPE processSingleSample (SampleType sample, SampleType* buf,
                                                                     const NumericType* fir, size_t m, size_t& p) noexcept
         {
             SampleType out (0);
 
-            buf[p] = sample;
-
-            size_t k;
-            for (k = 0; k < m - p; ++k)
-                out += buf[(p + k)] * fir[k];
+            // The state is stored twice, so that the last m samples are always contiguous
+            buf[p] = buf[p + m] = sample;
 
-            for (size_t j = 0; j < p; ++j)
-                out += buf[j] * fir[j + k];
+            for (size_t k = 0; k < m; ++k)
+                out += buf[p + k] * fir[k];
 
             p = (p == 0 ? m - 1 : p - 1);
 
@@ -203,6 +203,89 @@ class FIRFilterTest : public UnitTest
     }
 
 
+    //==============================================================================
+    static void referenceDouble (const float* fir, size_t numCoefficients,
+                                 const float* input, double* output, size_t n) noexcept
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            double sum = 0;
+
+            for (size_t j = 0; j < jmin (numCoefficients, i + 1); ++j)
+                sum += (double) fir[j] * (double) input[i - j];
+
+            output[i] = sum;
+        }
+    }
+
+    void runFrequencyDomainTest()
+    {
+        beginTest ("Frequency domain processing");
+
+        Random random (1234);
+
+        for (auto size : { 129, 500, 1000, 3000 })
+        {
+            constexpr size_t n = 6000;
+
+            HeapBlock<float> input (n), output (n);
+            HeapBlock<double> ref (n);
+            fillRandom (random, input.get(), n);
+
+            FIR::Coefficients<float>::Ptr coefficients (new FIR::Coefficients<float> ((size_t) size));
+            fillRandom (random, coefficients->getRawCoefficients(), (size_t) size);
+
+            FIR::Filter<float> filter (coefficients);
+            filter.setFFTThreshold (128);
+            filter.prepare ({ 0.0, (uint32) n, 1 });
+
+            // Random block sizes, with some sample by sample processing
+            for (size_t i = 0; i < n;)
+            {
+                if (random.nextInt (4) == 0)
+                {
+                    output[i] = filter.processSample (input[i]);
+                    ++i;
+                    continue;
+                }
+
+                auto len = jmin (n - i, (size_t) random.nextInt ({ 1, 700 }));
+                auto* src = input.get() + i;
+                auto* dst = output.get() + i;
+
+                AudioBlock<const float> inBlock (&src, 1, len);
+                AudioBlock<float> outBlock (&dst, 1, len);
+                filter.process (ProcessContextNonReplacing<float> (inBlock, outBlock));
+                i += len;
+            }
+
+            referenceDouble (coefficients->getRawCoefficients(), (size_t) size, input.get(), ref.get(), n);
+
+            auto maxError = 0.0;
+
+            for (size_t i = 0; i < n; ++i)
+                maxError = jmax (maxError, std::abs ((double) output[i] - ref[i]));
+
+            expectLessThan (maxError, 1.0e-4 * std::sqrt ((double) size));
+
+            // Changes of the coefficients must be taken into account without a reset
+            FloatVectorOperations::multiply (coefficients->getRawCoefficients(), -0.5f, size);
+
+            auto* outputData = output.get();
+            AudioBlock<float> block (&outputData, 1, n);
+            FloatVectorOperations::copy (output.get(), input.get(), (int) n);
+            filter.process (ProcessContextReplacing<float> (block));
+
+            maxError = 0.0;
+
+            // (once the previous input has left the history)
+            for (size_t i = (size_t) jmax (1024, size); i < n; ++i)
+                maxError = jmax (maxError, std::abs ((double) output[i] + 0.5 * ref[i]));
+
+            expectLessThan (maxError, 1.0e-4 * std::sqrt ((double) size));
+        }
+    }
+
 public:
     FIRFilterTest()
         : UnitTest ("FIR Filter", UnitTestCategories::dsp)
@@ -213,6 +296,7 @@ public:
         runTestForAllTypes<LargeBlockTest> ("Large Blocks");
         runTestForAllTypes<SampleBySampleTest> ("Sample by Sample");
         runTestForAllTypes<SplitBlockTest> ("Split Block");
+        runFrequencyDomainTest();
     }
 };
 
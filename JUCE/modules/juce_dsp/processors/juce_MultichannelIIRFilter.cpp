@@ -0,0 +1,197 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+namespace IIR
+{
+
+//==============================================================================
+template <typename SampleType>
+MultichannelFilter<SampleType>::MultichannelFilter (std::initializer_list<CoefficientsPtr> sectionsToUse)
+    : sections (sectionsToUse)
+{
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultichannelFilter<SampleType>::prepare (const ProcessSpec& spec)
+{
+    jassert (spec.numChannels > 0);
+    jassert (spec.maximumBlockSize > 0);
+
+    numGroups = (spec.numChannels + numLanes - 1) / numLanes;
+    maximumBlockSize = spec.maximumBlockSize;
+    numPreparedSections = static_cast<size_t> (sections.size());
+
+    interleavedData.malloc (maximumBlockSize * numLanes + numLanes);
+    interleaved = snapPointerToAlignment (interleavedData.getData(), sizeof (Vec));
+
+    stateData.malloc (numGroups * numPreparedSections * 2 * numLanes + numLanes);
+    state = snapPointerToAlignment (stateData.getData(), sizeof (Vec));
+
+    reset();
+}
+
+template <typename SampleType>
+void MultichannelFilter<SampleType>::reset() noexcept
+{
+    if (state != nullptr)
+        zeromem (state, sizeof (SampleType) * numGroups * numPreparedSections * 2 * numLanes);
+}
+
+template <typename SampleType>
+void MultichannelFilter<SampleType>::snapToZero() noexcept
+{
+    for (size_t i = 0; i < numGroups * numPreparedSections * 2 * numLanes; ++i)
+        util::snapToZero (state[i]);
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultichannelFilter<SampleType>::processInternal (const AudioBlock<const SampleType>& inputBlock,
+                                                      AudioBlock<SampleType>& outputBlock) noexcept
+{
+    // If you hit this assertion, then you have added or removed some sections
+    // without calling prepare afterwards
+    jassert (numPreparedSections == static_cast<size_t> (sections.size()));
+
+    const auto numChannels = outputBlock.getNumChannels();
+    const auto numSamples  = outputBlock.getNumSamples();
+
+    jassert (numChannels <= numGroups * numLanes);
+
+    if (numPreparedSections == 0)
+    {
+        outputBlock.copyFrom (inputBlock);
+        return;
+    }
+
+    for (size_t start = 0; start < numSamples; start += maximumBlockSize)
+    {
+        auto numToProcess = jmin (maximumBlockSize, numSamples - start);
+
+        for (size_t group = 0; group * numLanes < numChannels; ++group)
+        {
+            auto firstChannel = group * numLanes;
+            auto numGroupChannels = jmin (numLanes, numChannels - firstChannel);
+
+            // Interleaving, the unused lanes being fed with silence
+            if (numGroupChannels < numLanes)
+                zeromem (interleaved, sizeof (SampleType) * numToProcess * numLanes);
+
+            for (size_t lane = 0; lane < numGroupChannels; ++lane)
+            {
+                auto* src = inputBlock.getChannelPointer (firstChannel + lane) + start;
+
+                for (size_t i = 0; i < numToProcess; ++i)
+                    interleaved[i * numLanes + lane] = src[i];
+            }
+
+            processSections (group, numToProcess);
+
+            // Deinterleaving
+            for (size_t lane = 0; lane < numGroupChannels; ++lane)
+            {
+                auto* dst = outputBlock.getChannelPointer (firstChannel + lane) + start;
+
+                for (size_t i = 0; i < numToProcess; ++i)
+                    dst[i] = interleaved[i * numLanes + lane];
+            }
+        }
+    }
+}
+
+template <typename SampleType>
+void MultichannelFilter<SampleType>::processSections (size_t group, size_t numSamples) noexcept
+{
+    for (size_t section = 0; section < numPreparedSections; ++section)
+    {
+        auto& coefficients = *sections.getUnchecked (static_cast<int> (section));
+        auto* c = coefficients.getRawCoefficients();
+        auto order = coefficients.getFilterOrder();
+
+        // Only first and second order sections are supported
+        jassert (order == 1 || order == 2);
+
+        // First order sections are processed as biquads with b2 = a2 = 0
+        auto b0 = Vec (c[0]);
+        auto b1 = Vec (c[1]);
+        auto b2 = Vec (order == 2 ? c[2] : static_cast<SampleType> (0));
+        auto a1 = Vec (order == 2 ? c[3] : c[2]);
+        auto a2 = Vec (order == 2 ? c[4] : static_cast<SampleType> (0));
+
+        auto* sectionState = state + (group * numPreparedSections + section) * 2 * numLanes;
+        auto lv1 = load (sectionState);
+        auto lv2 = load (sectionState + numLanes);
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            auto* samples = interleaved + i * numLanes;
+
+            auto input = load (samples);
+            auto output = (input * b0) + lv1;
+
+            lv1 = (input * b1) - (output * a1) + lv2;
+            lv2 = (input * b2) - (output * a2);
+
+            store (samples, output);
+        }
+
+        store (sectionState, lv1);
+        store (sectionState + numLanes, lv2);
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+typename MultichannelFilter<SampleType>::Vec JUCE_VECTOR_CALLTYPE MultichannelFilter<SampleType>::load (const SampleType* src) noexcept
+{
+   #if JUCE_USE_SIMD
+    return Vec::fromRawArray (src);
+   #else
+    return *src;
+   #endif
+}
+
+template <typename SampleType>
+void JUCE_VECTOR_CALLTYPE MultichannelFilter<SampleType>::store (SampleType* dst, Vec value) noexcept
+{
+   #if JUCE_USE_SIMD
+    value.copyToRawArray (dst);
+   #else
+    *dst = value;
+   #endif
+}
+
+//==============================================================================
+template class MultichannelFilter<float>;
+template class MultichannelFilter<double>;
+
+} // namespace IIR
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,143 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+namespace IIR
+{
+
+/**
+    A processing class that applies a cascade of first and second order IIR
+    filters to a multi-channel audio signal, using the Transposed Direct Form II
+    digital structure.
+
+    Instead of running one recursion per channel like a ProcessorDuplicator of
+    IIR::Filter objects does, this class interleaves the channels into the lanes
+    of a SIMDRegister, so that SIMDRegister<SampleType>::size() channels are
+    filtered in a single recursion: 4 for float and 2 for double with SSE2 or NEON,
+    twice as many when compiling for AVX2, and 1 if JUCE_USE_SIMD is disabled.
+    This is most useful with a high number of channels sharing the same filter
+    settings, such as an equaliser on a multi-channel bus.
+
+    Every section of the cascade uses an IIR::Coefficients object, which must
+    have an order of 1 or 2, and the same coefficients are used for every
+    channel. It's up to the caller to ensure that the coefficients are modified
+    in a thread-safe way.
+
+    @see IIR::Filter, ProcessorDuplicator
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class MultichannelFilter
+{
+public:
+    /** A typedef for a ref-counted pointer to the coefficients object */
+    using CoefficientsPtr = typename Coefficients<SampleType>::Ptr;
+
+    //==============================================================================
+    /** Creates an empty cascade, which won't have any effect on the signal. */
+    MultichannelFilter() = default;
+
+    /** Creates a cascade from a list of sections. */
+    MultichannelFilter (std::initializer_list<CoefficientsPtr> sectionsToUse);
+
+    //==============================================================================
+    /** The coefficients of every section of the cascade, processed in order.
+
+        If you add or remove sections, you must call prepare again before the
+        next call to process.
+    */
+    Array<CoefficientsPtr> sections;
+
+    //==============================================================================
+    /** Initialises the processor. */
+    void prepare (const ProcessSpec& spec);
+
+    /** Resets the internal state variables of every section. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Processes the input and output samples supplied in the processing context. */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        static_assert (std::is_same<typename ProcessContext::SampleType, SampleType>::value,
+                       "The sample-type of the IIR filter must match the sample-type supplied to this process callback");
+
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock      = context.getOutputBlock();
+
+        jassert (inputBlock.getNumChannels() == outputBlock.getNumChannels());
+        jassert (inputBlock.getNumSamples()  == outputBlock.getNumSamples());
+
+        if (context.isBypassed)
+        {
+            outputBlock.copyFrom (inputBlock);
+            return;
+        }
+
+        processInternal (inputBlock, outputBlock);
+
+       #if JUCE_SNAP_TO_ZERO
+        snapToZero();
+       #endif
+    }
+
+    /** Ensure that the state variables are rounded to zero if the state
+        variables are denormals.
+    */
+    void snapToZero() noexcept;
+
+private:
+    //==============================================================================
+   #if JUCE_USE_SIMD
+    using Vec = SIMDRegister<SampleType>;
+    static constexpr size_t numLanes = Vec::SIMDNumElements;
+   #else
+    using Vec = SampleType;
+    static constexpr size_t numLanes = 1;
+   #endif
+
+    void processInternal (const AudioBlock<const SampleType>&, AudioBlock<SampleType>&) noexcept;
+    void processSections (size_t group, size_t numSamples) noexcept;
+
+    static Vec JUCE_VECTOR_CALLTYPE load (const SampleType*) noexcept;
+    static void JUCE_VECTOR_CALLTYPE store (SampleType*, Vec) noexcept;
+
+    //==============================================================================
+    HeapBlock<SampleType> interleavedData, stateData;
+    SampleType* interleaved = nullptr;
+    SampleType* state = nullptr;
+    size_t numGroups = 0, maximumBlockSize = 0, numPreparedSections = 0;
+
+    JUCE_LEAK_DETECTOR (MultichannelFilter)
+};
+
+} // namespace IIR
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class MultichannelIIRFilterTests  : public UnitTest
+{
+public:
+    MultichannelIIRFilterTests()
+        : UnitTest ("Multichannel IIR Filter", UnitTestCategories::dsp)
+    {}
+
+    template <typename SampleType>
+    using Duplicator = ProcessorDuplicator<IIR::Filter<SampleType>, IIR::Coefficients<SampleType>>;
+
+    template <typename SampleType>
+    static Array<typename IIR::Coefficients<SampleType>::Ptr> makeSections()
+    {
+        using Coefficients = IIR::Coefficients<SampleType>;
+        constexpr auto sampleRate = 48000.0;
+
+        return { Coefficients::makeHighPass   (sampleRate, static_cast<SampleType> (40.0)),
+                 Coefficients::makePeakFilter (sampleRate, static_cast<SampleType> (300.0),  static_cast<SampleType> (0.7), static_cast<SampleType> (2.0)),
+                 Coefficients::makePeakFilter (sampleRate, static_cast<SampleType> (2500.0), static_cast<SampleType> (3.0), static_cast<SampleType> (0.5)),
+                 Coefficients::makeFirstOrderLowPass (sampleRate, static_cast<SampleType> (12000.0)) };
+    }
+
+    static void fillRandom (Random& random, AudioBuffer<float>& buffer)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (channel, i, random.nextFloat() * 2.0f - 1.0f);
+    }
+
+    static void fillRandom (Random& random, AudioBuffer<double>& buffer)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (channel, i, random.nextDouble() * 2.0 - 1.0);
+    }
+
+    template <typename SampleType>
+    void runComparisonTest (uint32 numChannels)
+    {
+        constexpr uint32 maxBlockSize = 128;
+        constexpr int numSamples = 2000;
+        const ProcessSpec spec { 48000.0, maxBlockSize, numChannels };
+
+        auto sections = makeSections<SampleType>();
+
+        IIR::MultichannelFilter<SampleType> filter;
+        filter.sections = sections;
+        filter.prepare (spec);
+
+        OwnedArray<Duplicator<SampleType>> references;
+
+        for (auto& section : sections)
+            references.add (new Duplicator<SampleType> (section))->prepare (spec);
+
+        AudioBuffer<SampleType> input ((int) numChannels, numSamples), expected, output;
+        Random random (numChannels);
+        fillRandom (random, input);
+        expected.makeCopyOf (input);
+
+        AudioBlock<const SampleType> inputBlock (input);
+        AudioBlock<SampleType> expectedBlock (expected);
+        output.setSize ((int) numChannels, numSamples);
+        AudioBlock<SampleType> outputBlock (output);
+
+        for (size_t position = 0; position < (size_t) numSamples;)
+        {
+            auto blockSize = jmin ((size_t) random.nextInt ({ 1, (int) maxBlockSize + 1 }), (size_t) numSamples - position);
+
+            auto outputSubBlock = outputBlock.getSubBlock (position, blockSize);
+            filter.process (ProcessContextNonReplacing<SampleType> (inputBlock.getSubBlock (position, blockSize), outputSubBlock));
+
+            auto expectedSubBlock = expectedBlock.getSubBlock (position, blockSize);
+
+            for (auto* reference : references)
+                reference->process (ProcessContextReplacing<SampleType> (expectedSubBlock));
+
+            position += blockSize;
+        }
+
+        auto maxError = 0.0;
+
+        for (int channel = 0; channel < (int) numChannels; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                maxError = jmax (maxError, std::abs ((double) output.getSample (channel, i) - (double) expected.getSample (channel, i)));
+
+        expectLessThan (maxError, 1.0e-4);
+    }
+
+    void runTest() override
+    {
+        beginTest ("Multichannel IIR filter matches a ProcessorDuplicator of IIR filters");
+        {
+            for (auto numChannels : { 1u, 3u, 8u, 13u, 32u })
+            {
+                runComparisonTest<float>  (numChannels);
+                runComparisonTest<double> (numChannels);
+            }
+        }
+
+        beginTest ("Multichannel IIR filter can be reset and bypassed");
+        {
+            IIR::MultichannelFilter<float> filter { IIR::Coefficients<float>::makeLowPass (48000.0, 1000.0f) };
+            filter.prepare ({ 48000.0, 64, 6 });
+
+            AudioBuffer<float> buffer (6, 64);
+            AudioBlock<float> block (buffer);
+
+            block.fill (1.0f);
+            filter.process (ProcessContextReplacing<float> (block));
+            expect (block.getSample (0, 0) < 0.5f);
+
+            filter.reset();
+            block.fill (1.0f);
+            filter.process (ProcessContextReplacing<float> (block));
+
+            for (int channel = 1; channel < 6; ++channel)
+                expectEquals (block.getSample (channel, 63), block.getSample (0, 63));
+
+            block.fill (1.0f);
+            ProcessContextReplacing<float> context (block);
+            context.isBypassed = true;
+            filter.process (context);
+            expectEquals (block.getSample (5, 10), 1.0f);
+        }
+    }
+};
+
+static MultichannelIIRFilterTests multichannelIIRFilterTests;
+
+//==============================================================================
+class MultichannelIIRFilterBenchmark  : public UnitTest
+{
+public:
+    MultichannelIIRFilterBenchmark()
+        : UnitTest ("Multichannel IIR Filter benchmark", UnitTestCategories::benchmarks)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("MultichannelFilter against a ProcessorDuplicator of IIR::Filters");
+
+        constexpr uint32 numChannels = 32, blockSize = 512;
+        constexpr int numIterations = 200;
+        const ProcessSpec spec { 48000.0, blockSize, numChannels };
+
+        auto sections = MultichannelIIRFilterTests::makeSections<float>();
+
+        IIR::MultichannelFilter<float> filter;
+        filter.sections = sections;
+        filter.prepare (spec);
+
+        OwnedArray<MultichannelIIRFilterTests::Duplicator<float>> references;
+
+        for (auto& section : sections)
+            references.add (new MultichannelIIRFilterTests::Duplicator<float> (section))->prepare (spec);
+
+        AudioBuffer<float> buffer ((int) numChannels, (int) blockSize);
+        Random random (0);
+        MultichannelIIRFilterTests::fillRandom (random, buffer);
+        AudioBlock<float> block (buffer);
+
+        auto startTime = Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numIterations; ++i)
+            for (auto* reference : references)
+                reference->process (ProcessContextReplacing<float> (block));
+
+        auto duplicatorTime = Time::getHighResolutionTicks() - startTime;
+        startTime = Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numIterations; ++i)
+            filter.process (ProcessContextReplacing<float> (block));
+
+        auto multichannelTime = Time::getHighResolutionTicks() - startTime;
+
+        logMessage ("32 channels, 4 sections, " + String (numIterations) + " blocks of " + String (blockSize) + " samples: "
+                    + "ProcessorDuplicator " + String (Time::highResolutionTicksToSeconds (duplicatorTime) * 1000.0, 2) + " ms, "
+                    + "MultichannelFilter " + String (Time::highResolutionTicksToSeconds (multichannelTime) * 1000.0, 2) + " ms");
+    }
+};
+
+static MultichannelIIRFilterBenchmark multichannelIIRFilterBenchmark;
+
+} // namespace dsp
+} // namespace juce
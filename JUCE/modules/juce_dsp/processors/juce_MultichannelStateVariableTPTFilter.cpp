@@ -0,0 +1,271 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+//==============================================================================
+template <typename SampleType>
+void MultichannelStateVariableTPTFilter<SampleType>::setCutoffFrequency (size_t channel, SampleType newFrequencyHz) noexcept
+{
+    jassert (channel < getNumChannels());
+    jassert (isPositiveAndBelow (newFrequencyHz, static_cast<SampleType> (sampleRate * 0.5)));
+
+    cutoffFrequencies[channel] = newFrequencyHz;
+    update (channel);
+}
+
+template <typename SampleType>
+void MultichannelStateVariableTPTFilter<SampleType>::setResonance (size_t channel, SampleType newResonance) noexcept
+{
+    jassert (channel < getNumChannels());
+    jassert (newResonance > static_cast<SampleType> (0));
+
+    resonances[channel] = newResonance;
+    update (channel);
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultichannelStateVariableTPTFilter<SampleType>::prepare (const ProcessSpec& spec)
+{
+    jassert (spec.sampleRate > 0);
+    jassert (spec.numChannels > 0);
+
+    sampleRate = spec.sampleRate;
+    numGroups = (spec.numChannels + numLanes - 1) / numLanes;
+
+    cutoffFrequencies.assign (spec.numChannels, static_cast<SampleType> (1000.0));
+    resonances.assign (spec.numChannels, static_cast<SampleType> (1.0 / std::sqrt (2.0)));
+
+    // The lanes of the last group which aren't used by any channel keep
+    // null coefficients, so they stay silent
+    auto numGroupLanes = numGroups * numLanes;
+    memory.calloc (5 * numGroupLanes + 3 * chunkSize * numLanes + numLanes);
+
+    g  = snapPointerToAlignment (memory.getData(), sizeof (Vec));
+    R2 = g  + numGroupLanes;
+    h  = R2 + numGroupLanes;
+    s1 = h  + numGroupLanes;
+    s2 = s1 + numGroupLanes;
+
+    interleaved = s2 + numGroupLanes;
+    gChunk = interleaved + chunkSize * numLanes;
+    hChunk = gChunk + chunkSize * numLanes;
+
+    for (size_t channel = 0; channel < spec.numChannels; ++channel)
+        update (channel);
+
+    reset();
+}
+
+template <typename SampleType>
+void MultichannelStateVariableTPTFilter<SampleType>::reset() noexcept
+{
+    if (s1 != nullptr)
+        zeromem (s1, sizeof (SampleType) * 2 * numGroups * numLanes);
+}
+
+template <typename SampleType>
+void MultichannelStateVariableTPTFilter<SampleType>::snapToZero() noexcept
+{
+    for (size_t i = 0; i < 2 * numGroups * numLanes; ++i)
+        util::snapToZero (s1[i]);
+}
+
+template <typename SampleType>
+void MultichannelStateVariableTPTFilter<SampleType>::update (size_t channel) noexcept
+{
+    if (g == nullptr)
+        return;
+
+    // (the channels are interleaved by groups of numLanes, so the lane of a
+    // channel is at the same index as the channel)
+    g[channel]  = static_cast<SampleType> (std::tan (MathConstants<double>::pi * cutoffFrequencies[channel] / sampleRate));
+    R2[channel] = static_cast<SampleType> (1.0 / resonances[channel]);
+    h[channel]  = static_cast<SampleType> (1.0 / (1.0 + R2[channel] * g[channel] + g[channel] * g[channel]));
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultichannelStateVariableTPTFilter<SampleType>::processInternal (const AudioBlock<const SampleType>& inputBlock,
+                                                                      AudioBlock<SampleType>& outputBlock,
+                                                                      const SampleType* const* modulation) noexcept
+{
+    // If you hit this assertion, you forgot to call prepare
+    jassert (g != nullptr);
+
+    const auto numChannels = outputBlock.getNumChannels();
+    const auto numSamples  = outputBlock.getNumSamples();
+
+    for (size_t start = 0; start < numSamples; start += chunkSize)
+    {
+        auto numToProcess = jmin (chunkSize, numSamples - start);
+
+        for (size_t group = 0; group * numLanes < numChannels; ++group)
+        {
+            auto firstChannel = group * numLanes;
+            auto numGroupChannels = jmin (numLanes, numChannels - firstChannel);
+
+            // Interleaving, the unused lanes being fed with silence
+            if (numGroupChannels < numLanes)
+                zeromem (interleaved, sizeof (SampleType) * numToProcess * numLanes);
+
+            for (size_t lane = 0; lane < numGroupChannels; ++lane)
+            {
+                auto* src = inputBlock.getChannelPointer (firstChannel + lane) + start;
+
+                for (size_t i = 0; i < numToProcess; ++i)
+                    interleaved[i * numLanes + lane] = src[i];
+            }
+
+            if (modulation != nullptr)
+                computeCoefficients (group, numGroupChannels, start, numToProcess, modulation);
+
+            processGroup (group, numToProcess, modulation != nullptr);
+
+            // Deinterleaving
+            for (size_t lane = 0; lane < numGroupChannels; ++lane)
+            {
+                auto* dst = outputBlock.getChannelPointer (firstChannel + lane) + start;
+
+                for (size_t i = 0; i < numToProcess; ++i)
+                    dst[i] = interleaved[i * numLanes + lane];
+            }
+        }
+    }
+}
+
+template <typename SampleType>
+void MultichannelStateVariableTPTFilter<SampleType>::computeCoefficients (size_t group, size_t numGroupChannels,
+                                                                          size_t start, size_t numSamples,
+                                                                          const SampleType* const* modulation) noexcept
+{
+    const auto scale = static_cast<SampleType> (MathConstants<double>::pi / sampleRate);
+    const auto one = static_cast<SampleType> (1);
+
+    for (size_t lane = 0; lane < numLanes; ++lane)
+    {
+        auto channel = group * numLanes + lane;
+        auto* frequencies = lane < numGroupChannels ? modulation[channel] : nullptr;
+
+        if (frequencies == nullptr)
+        {
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                gChunk[i * numLanes + lane] = g[channel];
+                hChunk[i * numLanes + lane] = h[channel];
+            }
+
+            continue;
+        }
+
+        frequencies += start;
+        auto r2 = R2[channel];
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            jassert (isPositiveAndBelow (frequencies[i], static_cast<SampleType> (sampleRate * 0.5)));
+
+            auto gi = FastMathApproximations::tan (frequencies[i] * scale);
+
+            gChunk[i * numLanes + lane] = gi;
+            hChunk[i * numLanes + lane] = one / (one + r2 * gi + gi * gi);
+        }
+    }
+}
+
+template <typename SampleType>
+void MultichannelStateVariableTPTFilter<SampleType>::processGroup (size_t group, size_t numSamples, bool modulated) noexcept
+{
+    auto offset = group * numLanes;
+
+    auto gv  = load (g  + offset);
+    auto hv  = load (h  + offset);
+    auto r2  = load (R2 + offset);
+    auto ls1 = load (s1 + offset);
+    auto ls2 = load (s2 + offset);
+
+    // The outputs are mixed rather than selected, to keep a single loop
+    const auto zero = static_cast<SampleType> (0), one = static_cast<SampleType> (1);
+    const auto lowpassGain  = Vec (filterType == Type::lowpass  ? one : zero);
+    const auto bandpassGain = Vec (filterType == Type::bandpass ? one : zero);
+    const auto highpassGain = Vec (filterType == Type::highpass ? one : zero);
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        auto* samples = interleaved + i * numLanes;
+
+        if (modulated)
+        {
+            gv = load (gChunk + i * numLanes);
+            hv = load (hChunk + i * numLanes);
+        }
+
+        auto yHP = hv * (load (samples) - ls1 * (gv + r2) - ls2);
+
+        auto yBP = yHP * gv + ls1;
+        ls1      = yHP * gv + yBP;
+
+        auto yLP = yBP * gv + ls2;
+        ls2      = yBP * gv + yLP;
+
+        store (samples, yLP * lowpassGain + yBP * bandpassGain + yHP * highpassGain);
+    }
+
+    store (s1 + offset, ls1);
+    store (s2 + offset, ls2);
+}
+
+//==============================================================================
+template <typename SampleType>
+typename MultichannelStateVariableTPTFilter<SampleType>::Vec JUCE_VECTOR_CALLTYPE
+    MultichannelStateVariableTPTFilter<SampleType>::load (const SampleType* src) noexcept
+{
+   #if JUCE_USE_SIMD
+    return Vec::fromRawArray (src);
+   #else
+    return *src;
+   #endif
+}
+
+template <typename SampleType>
+void JUCE_VECTOR_CALLTYPE MultichannelStateVariableTPTFilter<SampleType>::store (SampleType* dst, Vec value) noexcept
+{
+   #if JUCE_USE_SIMD
+    value.copyToRawArray (dst);
+   #else
+    *dst = value;
+   #endif
+}
+
+//==============================================================================
+template class MultichannelStateVariableTPTFilter<float>;
+template class MultichannelStateVariableTPTFilter<double>;
+
+} // namespace dsp
+} // namespace juce
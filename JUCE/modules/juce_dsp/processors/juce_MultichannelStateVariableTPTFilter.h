@@ -0,0 +1,189 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+/**
+    A bank of StateVariableTPTFilter, typically one per voice of a polyphonic
+    synthesiser, processed together in the lanes of a SIMDRegister.
+
+    Every channel has its own cutoff frequency and resonance, and
+    SIMDRegister<SampleType>::size() channels are filtered in a single recursion,
+    as in IIR::MultichannelFilter. The filter type is shared by all the channels.
+
+    The cutoff frequencies can also be modulated on every sample, by passing one
+    buffer of frequencies per channel to process(). In that case, the coefficients
+    are computed for a whole chunk of samples at a time before running the recursion,
+    using FastMathApproximations::tan rather than std::tan.
+
+    @see StateVariableTPTFilter
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class MultichannelStateVariableTPTFilter
+{
+public:
+    //==============================================================================
+    using Type = StateVariableTPTFilterType;
+
+    //==============================================================================
+    /** Constructor. */
+    MultichannelStateVariableTPTFilter() = default;
+
+    //==============================================================================
+    /** Sets the type of every channel of the filter. */
+    void setType (Type newType) noexcept                    { filterType = newType; }
+
+    /** Returns the type of the filter. */
+    Type getType() const noexcept                           { return filterType; }
+
+    /** Sets the cutoff frequency of a channel, in Hz. */
+    void setCutoffFrequency (size_t channel, SampleType newFrequencyHz) noexcept;
+
+    /** Sets the resonance of a channel.
+
+        To have a standard 12 dB / octave filter, the value must be set at 1 / sqrt(2).
+    */
+    void setResonance (size_t channel, SampleType newResonance) noexcept;
+
+    /** Returns the cutoff frequency of a channel. */
+    SampleType getCutoffFrequency (size_t channel) const noexcept   { return cutoffFrequencies[channel]; }
+
+    /** Returns the resonance of a channel. */
+    SampleType getResonance (size_t channel) const noexcept         { return resonances[channel]; }
+
+    //==============================================================================
+    /** Initialises the filter. Every channel starts with a cutoff frequency of 1 kHz
+        and a resonance of 1 / sqrt(2).
+    */
+    void prepare (const ProcessSpec& spec);
+
+    /** Returns the current number of channels. */
+    size_t getNumChannels() const noexcept                  { return cutoffFrequencies.size(); }
+
+    /** Resets the internal state variables of the filter. */
+    void reset() noexcept;
+
+    /** Ensure that the state variables are rounded to zero if the state
+        variables are denormals.
+    */
+    void snapToZero() noexcept;
+
+    //==============================================================================
+    /** Processes the input and output samples supplied in the processing context,
+        using the cutoff frequencies set with setCutoffFrequency.
+    */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        process (context, nullptr);
+    }
+
+    /** Processes the input and output samples supplied in the processing context,
+        with a cutoff frequency in Hz for every sample of every channel.
+
+        @param context      the processing context
+        @param modulation   an array of one buffer of cutoff frequencies per channel,
+                            with as many samples as the context. Some of the buffers
+                            can be null, in which case the channel uses the frequency
+                            set with setCutoffFrequency.
+    */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context, const SampleType* const* modulation) noexcept
+    {
+        static_assert (std::is_same<typename ProcessContext::SampleType, SampleType>::value,
+                       "The sample-type of the filter must match the sample-type supplied to this process callback");
+
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock      = context.getOutputBlock();
+
+        jassert (inputBlock.getNumChannels() <= getNumChannels());
+        jassert (inputBlock.getNumChannels() == outputBlock.getNumChannels());
+        jassert (inputBlock.getNumSamples()  == outputBlock.getNumSamples());
+
+        if (context.isBypassed)
+        {
+            outputBlock.copyFrom (inputBlock);
+            return;
+        }
+
+        processInternal (inputBlock, outputBlock, modulation);
+
+       #if JUCE_SNAP_TO_ZERO
+        snapToZero();
+       #endif
+    }
+
+private:
+    //==============================================================================
+   #if JUCE_USE_SIMD
+    using Vec = SIMDRegister<SampleType>;
+    static constexpr size_t numLanes = Vec::SIMDNumElements;
+   #else
+    using Vec = SampleType;
+    static constexpr size_t numLanes = 1;
+   #endif
+
+    static constexpr size_t chunkSize = 64;
+
+    void processInternal (const AudioBlock<const SampleType>&, AudioBlock<SampleType>&,
+                          const SampleType* const*) noexcept;
+    void computeCoefficients (size_t group, size_t numGroupChannels, size_t start, size_t numSamples,
+                              const SampleType* const* modulation) noexcept;
+    void processGroup (size_t group, size_t numSamples, bool modulated) noexcept;
+    void update (size_t channel) noexcept;
+
+    static Vec JUCE_VECTOR_CALLTYPE load (const SampleType*) noexcept;
+    static void JUCE_VECTOR_CALLTYPE store (SampleType*, Vec) noexcept;
+
+    //==============================================================================
+    std::vector<SampleType> cutoffFrequencies, resonances;
+
+    // Interleaved by groups of numLanes channels
+    HeapBlock<SampleType> memory;
+    SampleType* g = nullptr;
+    SampleType* R2 = nullptr;
+    SampleType* h = nullptr;
+    SampleType* s1 = nullptr;
+    SampleType* s2 = nullptr;
+
+    // Scratch buffers for the samples and coefficients of a chunk
+    SampleType* interleaved = nullptr;
+    SampleType* gChunk = nullptr;
+    SampleType* hChunk = nullptr;
+
+    double sampleRate = 44100.0;
+    size_t numGroups = 0;
+    Type filterType = Type::lowpass;
+
+    JUCE_LEAK_DETECTOR (MultichannelStateVariableTPTFilter)
+};
+
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class MultichannelStateVariableTPTFilterTest : public UnitTest
+{
+public:
+    MultichannelStateVariableTPTFilterTest()
+        : UnitTest ("Multichannel StateVariableTPTFilter", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Matches StateVariableTPTFilter");
+        {
+            runComparisonTest<float> (false, 1.0e-4);
+            runComparisonTest<double> (false, 1.0e-10);
+        }
+
+        beginTest ("Per-sample cutoff modulation");
+        {
+            runComparisonTest<float> (true, 1.0e-3);
+            runComparisonTest<double> (true, 1.0e-5);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+
+    // A sweep for every channel, which the reference filters follow with setCutoffFrequency
+    template <typename SampleType>
+    static SampleType getCutoff (size_t channel, size_t sample)
+    {
+        return static_cast<SampleType> (300.0 * (double) (channel + 1) * (1.5 + std::sin (0.001 * (double) (sample * (channel + 1)))));
+    }
+
+    template <typename SampleType>
+    void runComparisonTest (bool modulated, double tolerance)
+    {
+        constexpr size_t numChannels = 11, numSamples = 3000, blockSize = 250;
+        using Type = StateVariableTPTFilterType;
+
+        for (auto type : { Type::lowpass, Type::bandpass, Type::highpass })
+        {
+            Random random (1234);
+            AudioBuffer<SampleType> input ((int) numChannels, (int) numSamples), output ((int) numChannels, (int) numSamples);
+
+            for (int ch = 0; ch < input.getNumChannels(); ++ch)
+                for (int i = 0; i < input.getNumSamples(); ++i)
+                    input.setSample (ch, i, static_cast<SampleType> (2.0f * random.nextFloat() - 1.0f));
+
+            AudioBuffer<SampleType> cutoffs ((int) numChannels, (int) numSamples);
+
+            for (size_t ch = 0; ch < numChannels; ++ch)
+                for (size_t i = 0; i < numSamples; ++i)
+                    cutoffs.setSample ((int) ch, (int) i, getCutoff<SampleType> (ch, i));
+
+            MultichannelStateVariableTPTFilter<SampleType> filter;
+            filter.prepare ({ sampleRate, (uint32) blockSize, (uint32) numChannels });
+            filter.setType (type);
+
+            std::vector<std::unique_ptr<StateVariableTPTFilter<SampleType>>> references;
+
+            for (size_t ch = 0; ch < numChannels; ++ch)
+            {
+                auto resonance = static_cast<SampleType> (0.5 + 0.3 * (double) ch);
+
+                filter.setCutoffFrequency (ch, getCutoff<SampleType> (ch, 0));
+                filter.setResonance (ch, resonance);
+
+                references.emplace_back (new StateVariableTPTFilter<SampleType>());
+                references.back()->prepare ({ sampleRate, (uint32) blockSize, 1 });
+                references.back()->setType (type);
+                references.back()->setCutoffFrequency (getCutoff<SampleType> (ch, 0));
+                references.back()->setResonance (resonance);
+            }
+
+            for (size_t start = 0; start < numSamples; start += blockSize)
+            {
+                AudioBlock<const SampleType> inBlock (input.getArrayOfReadPointers(), numChannels, start, blockSize);
+                AudioBlock<SampleType> outBlock (output.getArrayOfWritePointers(), numChannels, start, blockSize);
+                ProcessContextNonReplacing<SampleType> context (inBlock, outBlock);
+
+                if (modulated)
+                {
+                    // A few channels without modulation
+                    const SampleType* channelCutoffs[numChannels];
+
+                    for (size_t ch = 0; ch < numChannels; ++ch)
+                        channelCutoffs[ch] = ch % 4 == 3 ? nullptr : cutoffs.getReadPointer ((int) ch, (int) start);
+
+                    filter.process (context, channelCutoffs);
+                }
+                else
+                {
+                    filter.process (context);
+                }
+            }
+
+            auto maxError = 0.0;
+
+            for (size_t ch = 0; ch < numChannels; ++ch)
+            {
+                auto& reference = *references[ch];
+
+                for (size_t i = 0; i < numSamples; ++i)
+                {
+                    if (modulated && ch % 4 != 3)
+                        reference.setCutoffFrequency (getCutoff<SampleType> (ch, i));
+
+                    auto expected = reference.processSample (0, input.getSample ((int) ch, (int) i));
+                    maxError = jmax (maxError, (double) std::abs (output.getSample ((int) ch, (int) i) - expected));
+                }
+            }
+
+            expectLessThan (maxError, tolerance);
+        }
+    }
+};
+
+static MultichannelStateVariableTPTFilterTest multichannelStateVariableTPTFilterUnitTest;
+
+} // namespace dsp
+} // namespace juce
@@ -528,6 +528,295 @@ private:
 };
 
 
+//==============================================================================
+/** Oversampling stage class performing 2 ^ n times oversampling in a single
+    step, using the polyphase decomposition of linear phase FIR filters
+    designed with the Kaiser method. Only the non-zero input samples are used
+    when upsampling and only the kept output samples are computed when
+    downsampling, so no intermediate buffer is needed between the rates.
+
+    The filter orders are rounded up to a multiple of twice the oversampling
+    factor, which makes the latency of the stage an integer number of samples
+    at the original sample rate.
+*/
+template <typename SampleType>
+struct OversamplingPolyphaseFIR  : public Oversampling<SampleType>::OversamplingStage
+{
+    using ParentType = typename Oversampling<SampleType>::OversamplingStage;
+
+    OversamplingPolyphaseFIR (size_t numChans, size_t newFactor,
+                              SampleType normalisedTransitionWidthUp,
+                              SampleType stopbandAmplitudedBUp,
+                              SampleType normalisedTransitionWidthDown,
+                              SampleType stopbandAmplitudedBDown)
+        : ParentType (numChans, newFactor),
+          stride ((newFactor + vectorSize - 1) / vectorSize * vectorSize)
+    {
+        jassert (isPowerOfTwo (newFactor) && newFactor <= maxFactor);
+
+        auto firUp   = designFilter (newFactor, normalisedTransitionWidthUp,   stopbandAmplitudedBUp);
+        auto firDown = designFilter (newFactor, normalisedTransitionWidthDown, stopbandAmplitudedBDown);
+
+        orderUp   = firUp->getFilterOrder();
+        orderDown = firDown->getFilterOrder();
+
+        // Upsampling: row k holds the k-th coefficient of every phase
+        auto N = orderUp + 1;
+        numTapsUp = (N + newFactor - 1) / newFactor;
+        coefficientsUp = allocateAligned (coefficientsUpData, numTapsUp * stride);
+
+        for (size_t k = 0; k < numTapsUp; ++k)
+            for (size_t p = 0; p < newFactor && k * newFactor + p < N; ++p)
+                coefficientsUp[k * stride + p] = firUp->getRawCoefficients()[k * newFactor + p]
+                                                   * static_cast<SampleType> (newFactor);
+
+        // Downsampling: row d holds the coefficients applied to the frame of
+        // samples received d output samples ago
+        N = orderDown + 1;
+        numFramesDown = (N + newFactor - 2) / newFactor + 1;
+        coefficientsDown = allocateAligned (coefficientsDownData, numFramesDown * stride);
+
+        for (size_t d = 0; d < numFramesDown; ++d)
+        {
+            for (size_t e = 0; e < newFactor; ++e)
+            {
+                auto index = static_cast<int> (d * newFactor) - static_cast<int> (e);
+
+                if (isPositiveAndBelow (index, static_cast<int> (N)))
+                    coefficientsDown[d * stride + e] = firDown->getRawCoefficients()[index];
+            }
+        }
+
+        stateUp   = allocateAligned (stateUpData,   this->numChannels * 2 * numTapsUp);
+        stateDown = allocateAligned (stateDownData, this->numChannels * 2 * numFramesDown * stride);
+        frame     = allocateAligned (frameData,     stride);
+
+        positionUp  .resize (static_cast<int> (this->numChannels));
+        positionDown.resize (static_cast<int> (this->numChannels));
+    }
+
+    //==============================================================================
+    SampleType getLatencyInSamples() const override
+    {
+        return static_cast<SampleType> (orderUp + orderDown) * static_cast<SampleType> (0.5);
+    }
+
+    void reset() override
+    {
+        ParentType::reset();
+
+        zeromem (stateUp,   sizeof (SampleType) * this->numChannels * 2 * numTapsUp);
+        zeromem (stateDown, sizeof (SampleType) * this->numChannels * 2 * numFramesDown * stride);
+
+        positionUp  .fill (0);
+        positionDown.fill (0);
+    }
+
+    void processSamplesUp (const AudioBlock<const SampleType>& inputBlock) override
+    {
+        jassert (inputBlock.getNumChannels() <= static_cast<size_t> (ParentType::buffer.getNumChannels()));
+        jassert (inputBlock.getNumSamples() * ParentType::factor <= static_cast<size_t> (ParentType::buffer.getNumSamples()));
+
+        // Initialization
+        auto L = ParentType::factor;
+        auto K = numTapsUp;
+        auto numSamples = inputBlock.getNumSamples();
+
+        // Processing
+        for (size_t channel = 0; channel < inputBlock.getNumChannels(); ++channel)
+        {
+            auto bufferSamples = ParentType::buffer.getWritePointer (static_cast<int> (channel));
+            auto buf = stateUp + channel * 2 * K;
+            auto samples = inputBlock.getChannelPointer (channel);
+            auto pos = positionUp.getUnchecked (static_cast<int> (channel));
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                // Input, stored twice so that the history is always contiguous
+                pos = (pos == 0 ? K - 1 : pos - 1);
+                buf[pos] = buf[pos + K] = samples[i];
+
+                // Convolution, computing all the phases at once
+                processPhases (buf + pos);
+
+                // Outputs
+                for (size_t p = 0; p < L; ++p)
+                    bufferSamples[i * L + p] = frame[p];
+            }
+
+            positionUp.setUnchecked (static_cast<int> (channel), pos);
+        }
+    }
+
+    void processSamplesDown (AudioBlock<SampleType>& outputBlock) override
+    {
+        jassert (outputBlock.getNumChannels() <= static_cast<size_t> (ParentType::buffer.getNumChannels()));
+        jassert (outputBlock.getNumSamples() * ParentType::factor <= static_cast<size_t> (ParentType::buffer.getNumSamples()));
+
+        // Initialization
+        auto L = ParentType::factor;
+        auto F = numFramesDown;
+        auto numSamples = outputBlock.getNumSamples();
+
+        // Processing
+        for (size_t channel = 0; channel < outputBlock.getNumChannels(); ++channel)
+        {
+            auto bufferSamples = ParentType::buffer.getReadPointer (static_cast<int> (channel));
+            auto buf = stateDown + channel * 2 * F * stride;
+            auto samples = outputBlock.getChannelPointer (channel);
+            auto pos = positionDown.getUnchecked (static_cast<int> (channel));
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                // Input, one frame of oversampled samples stored twice
+                pos = (pos == 0 ? F - 1 : pos - 1);
+
+                for (size_t e = 0; e < L; ++e)
+                    buf[pos * stride + e] = buf[(pos + F) * stride + e] = bufferSamples[i * L + e];
+
+                // Convolution, only for the samples which are kept
+                samples[i] = dotProduct (buf + pos * stride, coefficientsDown, F * stride);
+            }
+
+            positionDown.setUnchecked (static_cast<int> (channel), pos);
+        }
+    }
+
+private:
+    //==============================================================================
+   #if JUCE_USE_SIMD
+    using Vec = SIMDRegister<SampleType>;
+    static constexpr size_t vectorSize = Vec::SIMDNumElements;
+   #else
+    static constexpr size_t vectorSize = 1;
+   #endif
+
+    static constexpr size_t maxFactor = 16;
+
+    /** Designs a Kaiser windowed low-pass filter for the oversampled rate, with
+        its transition band centred on the original Nyquist frequency. The order
+        is estimated like in FilterDesign::designFIRLowpassKaiserMethod, and then
+        rounded up so that the group delay is a whole number of input samples.
+    */
+    static typename FIR::Coefficients<SampleType>::Ptr designFilter (size_t factor,
+                                                                    SampleType normalisedTransitionWidth,
+                                                                    SampleType amplitudedB)
+    {
+        jassert (normalisedTransitionWidth > 0 && normalisedTransitionWidth <= 0.5);
+        jassert (amplitudedB >= -100 && amplitudedB <= 0);
+
+        auto attenuation = -static_cast<double> (amplitudedB);
+        auto transitionWidth = static_cast<double> (normalisedTransitionWidth) / static_cast<double> (factor);
+
+        auto beta = 0.0;
+
+        if (attenuation > 50)
+            beta = 0.1102 * (attenuation - 8.7);
+        else if (attenuation >= 21)
+            beta = 0.5842 * std::pow (attenuation - 21, 0.4) + 0.07886 * (attenuation - 21);
+
+        auto order = attenuation > 21 ? roundToInt (std::ceil ((attenuation - 7.95) / (2.285 * transitionWidth * MathConstants<double>::twoPi)))
+                                      : roundToInt (std::ceil (5.79 / (transitionWidth * MathConstants<double>::twoPi)));
+
+        auto multiple = 2 * factor;
+        auto roundedOrder = (static_cast<size_t> (jmax (1, order)) + multiple - 1) / multiple * multiple;
+
+        return FilterDesign<SampleType>::designFIRLowpassWindowMethod (static_cast<SampleType> (0.5), static_cast<double> (factor),
+                                                                      roundedOrder, WindowingFunction<SampleType>::kaiser,
+                                                                      static_cast<SampleType> (beta));
+    }
+
+    static SampleType* allocateAligned (HeapBlock<SampleType>& block, size_t numElements)
+    {
+        block.calloc (numElements + vectorSize);
+
+       #if JUCE_USE_SIMD
+        return Vec::getNextSIMDAlignedPtr (block.get());
+       #else
+        return block.get();
+       #endif
+    }
+
+    /** Computes the next factor output samples from the history of the input
+        signal, newest sample first, and stores them into the frame buffer.
+    */
+    void processPhases (const SampleType* history) noexcept
+    {
+       #if JUCE_USE_SIMD
+        Vec accumulators[maxFactor / vectorSize + 1];
+        auto numVectors = stride / vectorSize;
+
+        for (size_t v = 0; v < numVectors; ++v)
+            accumulators[v] = Vec::expand (static_cast<SampleType> (0));
+
+        for (size_t k = 0; k < numTapsUp; ++k)
+        {
+            auto input = Vec::expand (history[k]);
+            auto* row = coefficientsUp + k * stride;
+
+            for (size_t v = 0; v < numVectors; ++v)
+                accumulators[v] += input * Vec::fromRawArray (row + v * vectorSize);
+        }
+
+        for (size_t v = 0; v < numVectors; ++v)
+            accumulators[v].copyToRawArray (frame + v * vectorSize);
+       #else
+        for (size_t p = 0; p < stride; ++p)
+            frame[p] = 0;
+
+        for (size_t k = 0; k < numTapsUp; ++k)
+            for (size_t p = 0; p < stride; ++p)
+                frame[p] += history[k] * coefficientsUp[k * stride + p];
+       #endif
+    }
+
+    /** Returns the dot product of two aligned arrays whose size is a multiple
+        of the vector size.
+    */
+    static SampleType dotProduct (const SampleType* a, const SampleType* b, size_t num) noexcept
+    {
+       #if JUCE_USE_SIMD
+        auto acc1 = Vec::expand (static_cast<SampleType> (0));
+        auto acc2 = Vec::expand (static_cast<SampleType> (0));
+        size_t i = 0;
+
+        for (; i + 2 * vectorSize <= num; i += 2 * vectorSize)
+        {
+            acc1 += Vec::fromRawArray (a + i) * Vec::fromRawArray (b + i);
+            acc2 += Vec::fromRawArray (a + i + vectorSize) * Vec::fromRawArray (b + i + vectorSize);
+        }
+
+        for (; i < num; i += vectorSize)
+            acc1 += Vec::fromRawArray (a + i) * Vec::fromRawArray (b + i);
+
+        return (acc1 + acc2).sum();
+       #else
+        auto out = static_cast<SampleType> (0);
+
+        for (size_t i = 0; i < num; ++i)
+            out += a[i] * b[i];
+
+        return out;
+       #endif
+    }
+
+    //==============================================================================
+    size_t stride, orderUp = 0, orderDown = 0, numTapsUp = 0, numFramesDown = 0;
+
+    HeapBlock<SampleType> coefficientsUpData, coefficientsDownData, stateUpData, stateDownData, frameData;
+    SampleType* coefficientsUp = nullptr;
+    SampleType* coefficientsDown = nullptr;
+    SampleType* stateUp = nullptr;
+    SampleType* stateDown = nullptr;
+    SampleType* frame = nullptr;
+
+    Array<size_t> positionUp, positionDown;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OversamplingPolyphaseFIR)
+};
+
+
 //==============================================================================
 template <typename SampleType>
 Oversampling<SampleType>::Oversampling (size_t newNumChannels)
@@ -584,6 +873,16 @@ Oversampling<SampleType>::Oversampling (size_t newNumChannels, size_t newFactor,
                                   twDown, gaindBStartDown + gaindBFactorDown * (float) n);
         }
     }
+    else if (newType == FilterType::filterPolyphaseFIR)
+    {
+        auto twUp   = (isMaximumQuality ? 0.10f : 0.12f);
+        auto twDown = (isMaximumQuality ? 0.12f : 0.15f);
+
+        auto gaindBUp   = (isMaximumQuality ? -90.0f : -70.0f);
+        auto gaindBDown = (isMaximumQuality ? -75.0f : -60.0f);
+
+        addPolyphaseFIROversamplingStage (newFactor, twUp, gaindBUp, twDown, gaindBDown);
+    }
 }
 
 template <typename SampleType>
@@ -612,6 +911,12 @@ void Oversampling<SampleType>::addOversamplingStage (FilterType type,
                                                                     normalisedTransitionWidthUp,   stopbandAmplitudedBUp,
                                                                     normalisedTransitionWidthDown, stopbandAmplitudedBDown));
     }
+    else if (type == FilterType::filterPolyphaseFIR)
+    {
+        stages.add (new OversamplingPolyphaseFIR<SampleType> (numChannels, 2,
+                                                              normalisedTransitionWidthUp,   stopbandAmplitudedBUp,
+                                                              normalisedTransitionWidthDown, stopbandAmplitudedBDown));
+    }
     else
     {
         stages.add (new Oversampling2TimesEquirippleFIR<SampleType> (numChannels,
@@ -622,6 +927,24 @@ void Oversampling<SampleType>::addOversamplingStage (FilterType type,
     factorOversampling *= 2;
 }
 
+template <typename SampleType>
+void Oversampling<SampleType>::addPolyphaseFIROversamplingStage (size_t factor,
+                                                                 float normalisedTransitionWidthUp,
+                                                                 float stopbandAmplitudedBUp,
+                                                                 float normalisedTransitionWidthDown,
+                                                                 float stopbandAmplitudedBDown)
+{
+    jassert (factor > 0 && factor < 5);
+
+    auto stageFactor = static_cast<size_t> (1) << factor;
+
+    stages.add (new OversamplingPolyphaseFIR<SampleType> (numChannels, stageFactor,
+                                                          normalisedTransitionWidthUp,   stopbandAmplitudedBUp,
+                                                          normalisedTransitionWidthDown, stopbandAmplitudedBDown));
+
+    factorOversampling *= stageFactor;
+}
+
 template <typename SampleType>
 void Oversampling<SampleType>::clearOversamplingStages()
 {
@@ -643,6 +966,13 @@ SampleType Oversampling<SampleType>::getLatencyInSamples() const noexcept
     return shouldUseIntegerLatency ? latency + fractionalDelay : latency;
 }
 
+template <typename SampleType>
+SampleType Oversampling<SampleType>::getFractionalLatencyInSamples() const noexcept
+{
+    auto latency = getLatencyInSamples();
+    return latency - std::floor (latency);
+}
+
 template <typename SampleType>
 SampleType Oversampling<SampleType>::getUncompensatedLatency() const noexcept
 {
@@ -47,6 +47,11 @@ namespace dsp
     latency is maximised. With IIR filtering the phase is compromised around the
     Nyquist frequency but the latency is minimised.
 
+    The filterPolyphaseFIR type does the whole oversampling in a single stage,
+    with polyphase linear phase FIR filters running at the original and at the
+    oversampled rates only. This avoids the intermediate buffers of the cascaded
+    half-band stages, and its latency is always an integer number of samples.
+
     @see FilterDesign.
 
     @tags{DSP}
@@ -60,6 +65,7 @@ public:
     {
         filterHalfBandFIREquiripple = 0,
         filterHalfBandPolyphaseIIR,
+        filterPolyphaseFIR,
         numFilterTypes
     };
 
@@ -115,6 +121,16 @@ public:
     */
     SampleType getLatencyInSamples() const noexcept;
 
+    /** Returns the fractional part of the latency returned by getLatencyInSamples.
+
+        This is the part of the latency which can't be reported to the DAW, so it is
+        zero when the integer latency option is used, or when all the stages are
+        polyphase FIR stages, whose filter orders are chosen to give an integer latency.
+        Otherwise the DAW should be given the latency rounded down, with this remainder
+        compensated in your own processing code if needed.
+    */
+    SampleType getFractionalLatencyInSamples() const noexcept;
+
     /** Returns the current oversampling factor. */
     size_t getOversamplingFactor() const noexcept;
 
@@ -180,6 +196,35 @@ public:
     */
     void addDummyOversamplingStage();
 
+    /** Adds a new polyphase FIR oversampling stage to the Oversampling class,
+        multiplying the current oversampling factor by 2 ^ factor in a single step.
+        This is used with the default constructor to create custom oversampling
+        chains, requiring a call to the clearOversamplingStages before any addition.
+
+        The filters are linear phase, and their orders are rounded up so that the
+        latency of the stage is an integer number of samples at its input rate.
+
+        @param factor                          the stage will perform 2 ^ factor times
+                                               oversampling, between 1 and 4
+        @param normalisedTransitionWidthUp     a value between 0 and 0.5 which specifies how much
+                                               the transition between passband and stopband is
+                                               steep, relative to the input sample rate, for
+                                               upsampling filtering (the lower the better)
+        @param stopbandAmplitudedBUp           the amplitude in dB in the stopband for upsampling
+                                               filtering, between -100 and 0
+        @param normalisedTransitionWidthDown   a value between 0 and 0.5 which specifies how much
+                                               the transition between passband and stopband is
+                                               steep, relative to the input sample rate, for
+                                               downsampling filtering (the lower the better)
+        @param stopbandAmplitudedBDown         the amplitude in dB in the stopband for downsampling
+                                               filtering, between -100 and 0
+
+        @see clearOversamplingStages, addOversamplingStage
+    */
+    void addPolyphaseFIROversamplingStage (size_t factor,
+                                           float normalisedTransitionWidthUp,   float stopbandAmplitudedBUp,
+                                           float normalisedTransitionWidthDown, float stopbandAmplitudedBDown);
+
     /** Removes all the previously registered oversampling stages, so you can add
         your own from scratch.
 
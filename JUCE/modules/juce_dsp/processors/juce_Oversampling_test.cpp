@@ -0,0 +1,142 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class OversamplingTests  : public UnitTest
+{
+public:
+    OversamplingTests()
+        : UnitTest ("Oversampling", UnitTestCategories::dsp)
+    {}
+
+    template <typename SampleType>
+    void runPolyphaseFIRTest (size_t factor, bool isMaxQuality)
+    {
+        constexpr size_t numChannels = 2, maxBlockSize = 256;
+        constexpr int numSamples = 4096;
+        constexpr double frequency = 0.05;
+
+        Oversampling<SampleType> oversampling (numChannels, factor,
+                                               Oversampling<SampleType>::filterPolyphaseFIR,
+                                               isMaxQuality);
+
+        expectEquals ((int) oversampling.getOversamplingFactor(), 1 << factor);
+        expectEquals ((double) oversampling.getFractionalLatencyInSamples(), 0.0);
+
+        auto latency = roundToInt (oversampling.getLatencyInSamples());
+        expect (latency > 0 && latency < numSamples / 2);
+
+        oversampling.initProcessing (maxBlockSize);
+
+        AudioBuffer<SampleType> buffer ((int) numChannels, numSamples);
+
+        for (int channel = 0; channel < (int) numChannels; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (channel, i, static_cast<SampleType> (std::sin (MathConstants<double>::twoPi * frequency * (i + channel))));
+
+        AudioBlock<SampleType> block (buffer);
+        Random random ((int64) factor);
+        auto maxUpsampledValue = static_cast<SampleType> (0);
+
+        for (size_t position = 0; position < (size_t) numSamples;)
+        {
+            auto blockSize = jmin ((size_t) random.nextInt ({ 1, (int) maxBlockSize + 1 }), (size_t) numSamples - position);
+            auto subBlock = block.getSubBlock (position, blockSize);
+
+            auto upsampled = oversampling.processSamplesUp (subBlock);
+            expectEquals ((int) upsampled.getNumSamples(), (int) (blockSize << factor));
+
+            if (position > (size_t) latency)
+                for (size_t channel = 0; channel < numChannels; ++channel)
+                    for (size_t i = 0; i < upsampled.getNumSamples(); ++i)
+                        maxUpsampledValue = jmax (maxUpsampledValue, std::abs (upsampled.getSample ((int) channel, (int) i)));
+
+            oversampling.processSamplesDown (subBlock);
+            position += blockSize;
+        }
+
+        // No images should be left in the upsampled signal
+        expectWithinAbsoluteError ((double) maxUpsampledValue, 1.0, 1.0e-2);
+
+        // The round trip must be a pure delay of the reported latency
+        auto maxError = 0.0;
+
+        for (int channel = 0; channel < (int) numChannels; ++channel)
+        {
+            for (int i = 2 * latency; i < numSamples; ++i)
+            {
+                auto expected = std::sin (MathConstants<double>::twoPi * frequency * (i - latency + channel));
+                maxError = jmax (maxError, std::abs ((double) buffer.getSample (channel, i) - expected));
+            }
+        }
+
+        expectLessThan (maxError, 1.0e-3);
+    }
+
+    void runTest() override
+    {
+        beginTest ("Polyphase FIR oversampling has an integer latency");
+        {
+            for (size_t factor = 1; factor <= 4; ++factor)
+            {
+                runPolyphaseFIRTest<float>  (factor, true);
+                runPolyphaseFIRTest<double> (factor, false);
+            }
+        }
+
+        beginTest ("Custom polyphase FIR stages can be chained with other stages");
+        {
+            Oversampling<float> oversampling (1);
+            oversampling.clearOversamplingStages();
+            oversampling.addOversamplingStage (Oversampling<float>::filterHalfBandPolyphaseIIR, 0.05f, -90.0f, 0.06f, -75.0f);
+            oversampling.addPolyphaseFIROversamplingStage (2, 0.1f, -80.0f, 0.1f, -70.0f);
+
+            expectEquals ((int) oversampling.getOversamplingFactor(), 8);
+
+            auto latency = oversampling.getLatencyInSamples();
+            expectWithinAbsoluteError (oversampling.getFractionalLatencyInSamples(), latency - std::floor (latency), 1.0e-6f);
+
+            oversampling.setUsingIntegerLatency (true);
+            oversampling.initProcessing (64);
+            expectEquals (oversampling.getFractionalLatencyInSamples(), 0.0f);
+
+            AudioBuffer<float> buffer (1, 64);
+            buffer.clear();
+            AudioBlock<float> block (buffer);
+
+            expectEquals ((int) oversampling.processSamplesUp (block).getNumSamples(), 512);
+            oversampling.processSamplesDown (block);
+        }
+    }
+};
+
+static OversamplingTests oversamplingTests;
+
+} // namespace dsp
+} // namespace juce
@@ -57,6 +57,14 @@ namespace detail
 /** This variadically-templated class lets you join together any number of processor
     classes into a single processor which will call process() on them all in sequence.
 
+    By default, each processor works its way through the whole block before the next
+    one starts, so a long chain will stream a large block through memory several
+    times. If you call setTileSize(), the chain will instead pass each short run of
+    samples through all the processors before moving on, which keeps the samples in
+    the cache.
+
+    @see CompileTimeBypass
+
     @tags{DSP}
 */
 template <typename... Processors>
@@ -77,6 +85,23 @@ public:
     template <int Index>
     bool isBypassed() const noexcept    { return bypassed[(size_t) Index]; }
 
+    /** Makes process() pass blocks through the processors in tiles of this many samples.
+
+        Each tile goes through every processor in the chain before the next one is
+        started, so for long chains and large blocks, far less data has to travel
+        between the cache and main memory. Tiles of a few hundred samples are
+        usually a good choice.
+
+        This only gives the same results as processing the whole block at once if all
+        the processors produce the same output however a block is split up, which is
+        true of most of the processors in this module. Set this to 0, the default, to
+        process whole blocks.
+    */
+    void setTileSize (size_t numSamplesPerTile) noexcept    { tileSize = numSamplesPerTile; }
+
+    /** Returns the tile size that was set with setTileSize(). */
+    size_t getTileSize() const noexcept                     { return tileSize; }
+
     /** Prepare all inner processors with the provided `ProcessSpec`. */
     void prepare (const ProcessSpec& spec)
     {
@@ -92,6 +117,40 @@ public:
     /** Process `context` through all inner processors in sequence. */
     template <typename ProcessContext>
     void process (const ProcessContext& context) noexcept
+    {
+        auto numSamples = context.getOutputBlock().getNumSamples();
+
+        if (tileSize == 0 || numSamples <= tileSize)
+        {
+            processTile (context);
+            return;
+        }
+
+        using SampleType = typename ProcessContext::SampleType;
+
+        for (size_t start = 0; start < numSamples; start += tileSize)
+        {
+            auto numTileSamples = jmin (tileSize, numSamples - start);
+            auto outputTile = context.getOutputBlock().getSubBlock (start, numTileSamples);
+
+            if (context.usesSeparateInputAndOutputBlocks())
+            {
+                ProcessContextNonReplacing<SampleType> tileContext (context.getInputBlock().getSubBlock (start, numTileSamples), outputTile);
+                tileContext.isBypassed = context.isBypassed;
+                processTile (tileContext);
+            }
+            else
+            {
+                ProcessContextReplacing<SampleType> tileContext (outputTile);
+                tileContext.isBypassed = context.isBypassed;
+                processTile (tileContext);
+            }
+        }
+    }
+
+private:
+    template <typename ProcessContext>
+    void processTile (const ProcessContext& context) noexcept
     {
         detail::forEachInTuple ([&] (auto& proc, size_t index) noexcept
         {
@@ -113,9 +172,57 @@ public:
         }, processors);
     }
 
-private:
     std::tuple<Processors...> processors;
     std::array<bool, sizeof...(Processors)> bypassed { {} };
+    size_t tileSize = 0;
+};
+
+//==============================================================================
+/** Wraps a processor so that whether it's bypassed is fixed at compile time.
+
+    This is handy for chains whose configuration is known when they're built, e.g.
+    @code
+    ProcessorChain<Oscillator<float>, CompileTimeBypass<LadderFilter<float>, ! useFilter>, Gain<float>> chain;
+    @endcode
+    When `shouldBeBypassed` is true, process() does nothing except pass the input on
+    to the output, and the compiler can remove the wrapped processor's processing
+    code altogether. When it's false, the wrapper just forwards to the processor.
+    The processor is still prepared and reset, and you can still call all its other
+    methods.
+
+    @see ProcessorChain
+
+    @tags{DSP}
+*/
+template <typename Processor, bool shouldBeBypassed = true>
+class CompileTimeBypass  : public Processor
+{
+public:
+    using Processor::Processor;
+
+    /** True if this processor is always bypassed. */
+    static constexpr bool isAlwaysBypassed = shouldBeBypassed;
+
+    /** Processes the context, unless this processor is bypassed. */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        process (context, std::integral_constant<bool, shouldBeBypassed>());
+    }
+
+private:
+    template <typename ProcessContext>
+    void process (const ProcessContext& context, std::false_type) noexcept
+    {
+        Processor::process (context);
+    }
+
+    template <typename ProcessContext>
+    void process (const ProcessContext& context, std::true_type) noexcept
+    {
+        if (context.usesSeparateInputAndOutputBlocks())
+            context.getOutputBlock().copyFrom (context.getInputBlock());
+    }
 };
 
 /** Non-member equivalent of ProcessorChain::get which avoids awkward
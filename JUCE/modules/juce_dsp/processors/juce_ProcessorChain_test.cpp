@@ -40,6 +40,7 @@ class ProcessorChainTest : public UnitTest
         void process (const Context& context) noexcept
         {
             bufferWasClear = context.getInputBlock().getSample (0, 0) == 0;
+            ++numProcessCalls;
 
             if (! context.isBypassed)
                 context.getOutputBlock().add (AddValue);
@@ -48,8 +49,46 @@ class ProcessorChainTest : public UnitTest
         bool isPrepared     = false;
         bool isReset        = false;
         bool bufferWasClear = false;
+        int numProcessCalls = 0;
     };
 
+    using FilterChain = ProcessorChain<Gain<float>,
+                                       ProcessorDuplicator<IIR::Filter<float>, IIR::Coefficients<float>>,
+                                       Bias<float>,
+                                       ProcessorDuplicator<IIR::Filter<float>, IIR::Coefficients<float>>,
+                                       Gain<float>>;
+
+    static void prepareFilterChain (FilterChain& chain, const ProcessSpec& spec)
+    {
+        get<0> (chain).setRampDurationSeconds (0.01);
+        get<0> (chain).setGainLinear (0.5f);
+        *get<1> (chain).state = *IIR::Coefficients<float>::makeLowPass (spec.sampleRate, 2000.0f);
+        get<2> (chain).setRampDurationSeconds (0.01);
+        get<2> (chain).setBias (0.1f);
+        *get<3> (chain).state = *IIR::Coefficients<float>::makeHighPass (spec.sampleRate, 50.0f);
+        get<4> (chain).setGainDecibels (-3.0f);
+
+        chain.prepare (spec);
+    }
+
+    static void fillRandom (Random& random, AudioBuffer<float>& buffer)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+    }
+
+    static float getMaxDifference (const AudioBuffer<float>& a, const AudioBuffer<float>& b)
+    {
+        auto maxDifference = 0.0f;
+
+        for (int ch = 0; ch < a.getNumChannels(); ++ch)
+            for (int i = 0; i < a.getNumSamples(); ++i)
+                maxDifference = jmax (maxDifference, std::abs (a.getSample (ch, i) - b.getSample (ch, i)));
+
+        return maxDifference;
+    }
+
 public:
     ProcessorChainTest()
         : UnitTest ("ProcessorChain", UnitTestCategories::dsp) {}
@@ -132,6 +171,102 @@ public:
             expect (get<0> (chain).bufferWasClear);
             expect (! get<1> (chain).bufferWasClear);
         }
+
+        beginTest ("With a tile size, each processor is called once per tile");
+        {
+            ProcessorChain<MockProcessor<1>, MockProcessor<2>> chain;
+            chain.setTileSize (4);
+            expectEquals ((int) chain.getTileSize(), 4);
+
+            AudioBuffer<float> buffer (2, 10);
+            AudioBlock<float> block (buffer);
+            block.clear();
+            chain.process (ProcessContextReplacing<float> (block));
+
+            expectEquals (get<0> (chain).numProcessCalls, 3);
+            expectEquals (get<1> (chain).numProcessCalls, 3);
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    expectEquals (buffer.getSample (ch, i), 3.0f);
+
+            // blocks that fit into a single tile aren't split
+            auto subBlock = block.getSubBlock (0, 4);
+            chain.process (ProcessContextReplacing<float> (subBlock));
+            expectEquals (get<0> (chain).numProcessCalls, 4);
+        }
+
+        beginTest ("Tiled processing gives the same results as processing whole blocks");
+        {
+            constexpr int numSamples = 1000;
+            const ProcessSpec spec { 44100.0, (uint32) numSamples, 2 };
+
+            Random random (1234);
+            AudioBuffer<float> input (2, numSamples);
+            fillRandom (random, input);
+
+            for (auto replacing : { true, false })
+            {
+                for (auto tileSize : { 1, 7, 128, 999 })
+                {
+                    FilterChain reference, tiled;
+                    prepareFilterChain (reference, spec);
+                    prepareFilterChain (tiled, spec);
+                    tiled.setTileSize ((size_t) tileSize);
+
+                    AudioBuffer<float> referenceOutput (input), tiledOutput (input);
+                    AudioBlock<float> referenceBlock (referenceOutput), tiledBlock (tiledOutput);
+
+                    // a couple of blocks, so that the processors' state carries over
+                    for (int i = 0; i < 2; ++i)
+                    {
+                        if (replacing)
+                        {
+                            reference.process (ProcessContextReplacing<float> (referenceBlock));
+                            tiled.process (ProcessContextReplacing<float> (tiledBlock));
+                        }
+                        else
+                        {
+                            AudioBlock<const float> inputBlock (input);
+                            reference.process (ProcessContextNonReplacing<float> (inputBlock, referenceBlock));
+                            tiled.process (ProcessContextNonReplacing<float> (inputBlock, tiledBlock));
+                        }
+                    }
+
+                    expectLessThan (getMaxDifference (referenceOutput, tiledOutput), 1.0e-6f);
+                }
+            }
+        }
+
+        beginTest ("Processors bypassed at compile time are skipped");
+        {
+            ProcessorChain<MockProcessor<1>, CompileTimeBypass<MockProcessor<2>>, CompileTimeBypass<MockProcessor<4>, false>> chain;
+            static_assert (CompileTimeBypass<MockProcessor<2>>::isAlwaysBypassed, "");
+
+            chain.prepare (ProcessSpec{});
+            chain.reset();
+            expect (get<1> (chain).isPrepared);
+            expect (get<1> (chain).isReset);
+
+            AudioBuffer<float> buffer (1, 1);
+            AudioBlock<float> block (buffer);
+
+            block.clear();
+            chain.process (ProcessContextReplacing<float> (block));
+            expectEquals (buffer.getSample (0, 0), 5.0f);
+            expectEquals (get<1> (chain).numProcessCalls, 0);
+            expectEquals (get<2> (chain).numProcessCalls, 1);
+
+            // a bypassed processor must still pass its input on to a separate output
+            CompileTimeBypass<MockProcessor<2>> bypassed;
+            AudioBuffer<float> inputBuffer (1, 1);
+            inputBuffer.setSample (0, 0, 0.25f);
+            AudioBlock<const float> inputBlock (inputBuffer);
+
+            block.clear();
+            bypassed.process (ProcessContextNonReplacing<float> (inputBlock, block));
+            expectEquals (buffer.getSample (0, 0), 0.25f);
+        }
     }
 };
 
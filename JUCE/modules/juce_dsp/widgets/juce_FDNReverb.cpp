@@ -0,0 +1,306 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+//==============================================================================
+FDNReverb::FDNReverb (int numDelayLines)
+    : numLines (numDelayLines)
+{
+    // the number of delay lines must be a power of two between 4 and 64
+    jassert (isPowerOfTwo (numLines) && numLines >= 4 && numLines <= 64);
+
+    numGroups = ((size_t) numLines + numLanes - 1) / numLanes;
+    setParameters (parameters);
+}
+
+//==============================================================================
+void FDNReverb::setParameters (const Parameters& newParams)
+{
+    // These scaling factors match the ones of juce::Reverb
+    const float wetScaleFactor = 3.0f;
+    const float dryScaleFactor = 2.0f;
+
+    const auto wet = newParams.wetLevel * wetScaleFactor;
+    dryGain .setTargetValue (newParams.dryLevel * dryScaleFactor);
+    wetGain1.setTargetValue (0.5f * wet * (1.0f + newParams.width));
+    wetGain2.setTargetValue (0.5f * wet * (1.0f - newParams.width));
+
+    const auto isFrozen = newParams.freezeMode >= 0.5f;
+
+    // The room size is mapped to a decay time between 0.2 and 8 seconds
+    const auto rt60 = 0.2 * std::pow (40.0, (double) jlimit (0.0f, 1.0f, newParams.roomSize));
+
+    decayRate.setTargetValue (isFrozen ? 0.0f : (float) (-3.0 * std::log (10.0) / (rt60 * sampleRate)));
+    damping  .setTargetValue (isFrozen ? 0.0f : newParams.damping * 0.4f);
+    inputGain.setTargetValue (isFrozen ? 0.0f : 1.0f);
+
+    parameters = newParams;
+}
+
+//==============================================================================
+void FDNReverb::prepare (const ProcessSpec& spec)
+{
+    jassert (spec.sampleRate > 0);
+
+    sampleRate = spec.sampleRate;
+
+    // The delay lengths are distinct prime numbers of samples, spread
+    // exponentially between 20 and 70 ms
+    delayLengths.clear();
+
+    for (int i = 0; i < numLines; ++i)
+    {
+        auto length = roundToInt (sampleRate * 0.02 * std::pow (3.5, i / (double) (numLines - 1)));
+
+        for (;; ++length)
+        {
+            auto isPrime = true;
+
+            for (int d = 2; d * d <= length && isPrime; ++d)
+                isPrime = (length % d) != 0;
+
+            if (isPrime && std::find (delayLengths.begin(), delayLengths.end(), length) == delayLengths.end())
+                break;
+        }
+
+        delayLengths.push_back (length);
+    }
+
+    chunkSize = jmin (maximumChunkSize, (size_t) delayLengths.front());
+    bufferSize = (size_t) nextPowerOfTwo (delayLengths.back() + (int) chunkSize);
+    buffers.allocate (bufferSize * (size_t) numLines, false);
+
+    const auto numPaddedLines = numGroups * numLanes;
+    const auto numPerLineArrays = (size_t) 7;
+    memory.allocate (numPaddedLines * (numPerLineArrays + chunkSize) + 2 * maximumChunkSize + numLanes, true);
+
+    auto* ptr = snapPointerToAlignment (memory.getData(), sizeof (Vec));
+    for (auto* array : { &decayGains, &householderGains, &inputGainsLeft, &inputGainsRight,
+                         &outputGainsLeft, &outputGainsRight, &dampingStates })
+    {
+        *array = ptr;
+        ptr += numPaddedLines;
+    }
+
+    frame = ptr;
+    wetLeft = frame + numPaddedLines * chunkSize;
+    wetRight = wetLeft + maximumChunkSize;
+
+    // The inputs and outputs are connected to the lines with pseudo-random signs, so the
+    // left and right channels are decorrelated. The padding lines stay silent.
+    const auto scale = 1.0f / std::sqrt ((float) numLines);
+    Random random (0x7f4a7c15);
+
+    for (int i = 0; i < numLines; ++i)
+    {
+        householderGains[i] = 2.0f / (float) numLines;
+        inputGainsLeft[i]   = random.nextBool() ? scale : -scale;
+        inputGainsRight[i]  = random.nextBool() ? scale : -scale;
+        outputGainsLeft[i]  = random.nextBool() ? scale : -scale;
+        outputGainsRight[i] = random.nextBool() ? scale : -scale;
+    }
+
+    for (auto* value : { &decayRate, &damping, &inputGain, &dryGain, &wetGain1, &wetGain2 })
+        value->reset (sampleRate, 0.01);
+
+    setParameters (parameters);
+
+    for (auto* value : { &decayRate, &damping, &inputGain, &dryGain, &wetGain1, &wetGain2 })
+        value->setCurrentAndTargetValue (value->getTargetValue());
+
+    updateDecayGains();
+    reset();
+}
+
+void FDNReverb::reset() noexcept
+{
+    if (buffers != nullptr)
+        zeromem (buffers.getData(), sizeof (float) * bufferSize * (size_t) numLines);
+
+    if (dampingStates != nullptr)
+    {
+        zeromem (dampingStates, sizeof (float) * numGroups * numLanes);
+        zeromem (frame, sizeof (float) * numGroups * numLanes * chunkSize);
+    }
+
+    writePosition = 0;
+}
+
+//==============================================================================
+void FDNReverb::updateDecayGains() noexcept
+{
+    currentDecayRate = decayRate.getCurrentValue();
+
+    for (int i = 0; i < numLines; ++i)
+        decayGains[i] = std::exp (currentDecayRate * (float) delayLengths[(size_t) i]);
+}
+
+void FDNReverb::processInternal (float* left, float* right, size_t numSamples) noexcept
+{
+    // prepare() must be called before processing
+    jassert (buffers != nullptr);
+
+    for (size_t start = 0; start < numSamples;)
+    {
+        const auto numChunkSamples = jmin (chunkSize, numSamples - start);
+        const auto n = (int) numChunkSamples;
+
+        // The parameters of the network are only updated once per chunk
+        decayRate.skip (n);
+
+        if (decayRate.getCurrentValue() != currentDecayRate)
+            updateDecayGains();
+
+        const auto dampingValue = damping.skip (n);
+
+        const auto inputStart = inputGain.getCurrentValue();
+        const auto inputEnd = inputGain.skip (n);
+
+        processChunk (left + start, right != nullptr ? right + start : nullptr, numChunkSamples,
+                      dampingValue, inputStart, (inputEnd - inputStart) / (float) n);
+
+        // The gains of the mix are interpolated linearly over the chunk
+        const auto dryStart  = dryGain.getCurrentValue(),  dryStep  = (dryGain.skip (n)  - dryStart)  / (float) n;
+        const auto wet1Start = wetGain1.getCurrentValue(), wet1Step = (wetGain1.skip (n) - wet1Start) / (float) n;
+        const auto wet2Start = wetGain2.getCurrentValue(), wet2Step = (wetGain2.skip (n) - wet2Start) / (float) n;
+
+        for (size_t i = 0; i < numChunkSamples; ++i)
+        {
+            const auto dry  = dryStart  + dryStep  * (float) i;
+            const auto wet1 = wet1Start + wet1Step * (float) i;
+            const auto wet2 = wet2Start + wet2Step * (float) i;
+
+            if (right != nullptr)
+            {
+                left[start + i]  = left[start + i]  * dry + wetLeft[i]  * wet1 + wetRight[i] * wet2;
+                right[start + i] = right[start + i] * dry + wetRight[i] * wet1 + wetLeft[i]  * wet2;
+            }
+            else
+            {
+                left[start + i] = left[start + i] * dry + wetLeft[i] * wet1;
+            }
+        }
+
+        start += numChunkSamples;
+    }
+}
+
+void FDNReverb::processChunk (const float* left, const float* right, size_t numSamples,
+                              float dampingValue, float inputStart, float inputStep) noexcept
+{
+    const auto numPaddedLines = numGroups * numLanes;
+    const auto mask = bufferSize - 1;
+
+    // The outputs of the delay lines are gathered into frames of one sample per line
+    for (size_t line = 0; line < (size_t) numLines; ++line)
+    {
+        auto* buffer = buffers.getData() + line * bufferSize;
+        auto readPosition = writePosition + bufferSize - (size_t) delayLengths[line];
+
+        for (size_t i = 0; i < numSamples; ++i)
+            frame[i * numPaddedLines + line] = buffer[(readPosition + i) & mask];
+    }
+
+    const Vec dampingCoefficient (dampingValue);
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        auto* lines = frame + i * numPaddedLines;
+        Vec outLeft (0.0f), outRight (0.0f), feedbackSum (0.0f);
+
+        for (size_t g = 0; g < numPaddedLines; g += numLanes)
+        {
+            const auto x = load (lines + g);
+            outLeft  = outLeft  + x * load (outputGainsLeft + g);
+            outRight = outRight + x * load (outputGainsRight + g);
+
+            const auto damped = x + (load (dampingStates + g) - x) * dampingCoefficient;
+            store (dampingStates + g, damped);
+
+            const auto y = damped * load (decayGains + g);
+            store (lines + g, y);
+            feedbackSum = feedbackSum + y;
+        }
+
+        wetLeft[i]  = sum (outLeft);
+        wetRight[i] = sum (outRight);
+
+        // Householder feedback matrix, plus the inputs
+        const auto gain = inputStart + inputStep * (float) i;
+        const Vec feedback (sum (feedbackSum));
+        const Vec inLeft (left[i] * gain);
+        const Vec inRight (right != nullptr ? right[i] * gain : 0.0f);
+
+        for (size_t g = 0; g < numPaddedLines; g += numLanes)
+            store (lines + g, load (lines + g) - feedback * load (householderGains + g)
+                                + inLeft * load (inputGainsLeft + g) + inRight * load (inputGainsRight + g));
+    }
+
+    // ... and the new inputs are scattered back
+    for (size_t line = 0; line < (size_t) numLines; ++line)
+    {
+        auto* buffer = buffers.getData() + line * bufferSize;
+
+        for (size_t i = 0; i < numSamples; ++i)
+            buffer[(writePosition + i) & mask] = frame[i * numPaddedLines + line];
+    }
+
+    writePosition = (writePosition + numSamples) & mask;
+}
+
+//==============================================================================
+FDNReverb::Vec JUCE_VECTOR_CALLTYPE FDNReverb::load (const float* src) noexcept
+{
+   #if JUCE_USE_SIMD
+    return Vec::fromRawArray (src);
+   #else
+    return *src;
+   #endif
+}
+
+void JUCE_VECTOR_CALLTYPE FDNReverb::store (float* dst, Vec value) noexcept
+{
+   #if JUCE_USE_SIMD
+    value.copyToRawArray (dst);
+   #else
+    *dst = value;
+   #endif
+}
+
+float JUCE_VECTOR_CALLTYPE FDNReverb::sum (Vec value) noexcept
+{
+   #if JUCE_USE_SIMD
+    return value.sum();
+   #else
+    return value;
+   #endif
+}
+
+} // namespace dsp
+} // namespace juce
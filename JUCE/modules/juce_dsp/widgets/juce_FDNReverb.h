@@ -0,0 +1,179 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+/**
+    A reverb based on a feedback delay network.
+
+    The signal circulates through a set of delay lines (16 by default), each one
+    followed by a damping low-pass filter and a gain setting its decay time, and
+    the outputs of the lines are mixed back into their inputs with a Householder
+    matrix. The lines are processed together in the lanes of SIMDRegister objects,
+    so the cost grows slowly with the number of lines.
+
+    The parameters are the same as the ones of the Freeverb based Reverb, so this
+    class can be used as a drop-in replacement. The room size sets the decay time,
+    between 0.2 and 8 seconds. The parameters are smoothed once every block
+    of up to 64 samples rather than on every sample.
+
+    The delay lines are processed by blocks no longer than the shortest line, so
+    the reverb doesn't add any latency.
+
+    @see Reverb
+
+    @tags{DSP}
+*/
+class JUCE_API  FDNReverb
+{
+public:
+    //==============================================================================
+    /** Creates an uninitialised reverb. Call prepare() before first use.
+
+        @param numDelayLines    the number of delay lines, which must be a power of two
+                                between 4 and 64. More lines give a denser reverb.
+    */
+    explicit FDNReverb (int numDelayLines = 16);
+
+    //==============================================================================
+    using Parameters = juce::Reverb::Parameters;
+
+    /** Returns the reverb's current parameters. */
+    const Parameters& getParameters() const noexcept    { return parameters; }
+
+    /** Applies a new set of parameters to the reverb. The changes are smoothed.
+        Note that this doesn't attempt to lock the reverb, so if you call this in parallel with
+        the process method, you may get artifacts.
+    */
+    void setParameters (const Parameters& newParams);
+
+    /** Returns true if the reverb is enabled. */
+    bool isEnabled() const noexcept                     { return enabled; }
+
+    /** Enables/disables the reverb. */
+    void setEnabled (bool newValue) noexcept            { enabled = newValue; }
+
+    /** Returns the number of delay lines. */
+    int getNumDelayLines() const noexcept               { return numLines; }
+
+    //==============================================================================
+    /** Initialises the reverb. */
+    void prepare (const ProcessSpec& spec);
+
+    /** Resets the reverb's internal state. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Applies the reverb to a mono or stereo buffer. */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock = context.getOutputBlock();
+        const auto numInChannels = inputBlock.getNumChannels();
+        const auto numOutChannels = outputBlock.getNumChannels();
+        const auto numSamples = outputBlock.getNumSamples();
+
+        jassert (inputBlock.getNumSamples() == numSamples);
+
+        outputBlock.copyFrom (inputBlock);
+
+        if (! enabled || context.isBypassed)
+            return;
+
+        if (numInChannels == 1 && numOutChannels == 1)
+        {
+            processInternal (outputBlock.getChannelPointer (0), nullptr, numSamples);
+        }
+        else if (numInChannels == 2 && numOutChannels == 2)
+        {
+            processInternal (outputBlock.getChannelPointer (0),
+                             outputBlock.getChannelPointer (1),
+                             numSamples);
+        }
+        else
+        {
+            jassertfalse;   // invalid channel configuration
+        }
+    }
+
+private:
+    //==============================================================================
+   #if JUCE_USE_SIMD
+    using Vec = SIMDRegister<float>;
+    static constexpr size_t numLanes = Vec::SIMDNumElements;
+   #else
+    using Vec = float;
+    static constexpr size_t numLanes = 1;
+   #endif
+
+    static constexpr size_t maximumChunkSize = 64;
+
+    void processInternal (float* left, float* right, size_t numSamples) noexcept;
+    void processChunk (const float* left, const float* right, size_t numSamples,
+                       float dampingValue, float inputStart, float inputStep) noexcept;
+    void updateDecayGains() noexcept;
+
+    static Vec JUCE_VECTOR_CALLTYPE load (const float*) noexcept;
+    static void JUCE_VECTOR_CALLTYPE store (float*, Vec) noexcept;
+    static float JUCE_VECTOR_CALLTYPE sum (Vec) noexcept;
+
+    //==============================================================================
+    Parameters parameters;
+    double sampleRate = 44100.0;
+    bool enabled = true;
+
+    const int numLines;
+    size_t numGroups = 0, chunkSize = maximumChunkSize, bufferSize = 0, writePosition = 0;
+    std::vector<int> delayLengths;
+
+    // One circular buffer per delay line, each one of bufferSize samples
+    HeapBlock<float> buffers;
+
+    // Aligned per-line values, padded to a multiple of numLanes lines with
+    // lines which are never fed
+    HeapBlock<float> memory;
+    float* decayGains = nullptr;
+    float* householderGains = nullptr;
+    float* inputGainsLeft = nullptr;
+    float* inputGainsRight = nullptr;
+    float* outputGainsLeft = nullptr;
+    float* outputGainsRight = nullptr;
+    float* dampingStates = nullptr;
+    float* frame = nullptr;
+    float* wetLeft = nullptr;
+    float* wetRight = nullptr;
+
+    float currentDecayRate = 0.0f;
+    SmoothedValue<float> decayRate, damping, inputGain, dryGain, wetGain1, wetGain2;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FDNReverb)
+};
+
+} // namespace dsp
+} // namespace juce
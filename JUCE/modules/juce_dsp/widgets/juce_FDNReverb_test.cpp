@@ -0,0 +1,225 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class FDNReverbTest : public UnitTest
+{
+public:
+    FDNReverbTest()
+        : UnitTest ("FDNReverb", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr size_t blockSize = 512;
+
+        const auto wetOnly = []
+        {
+            FDNReverb::Parameters p;
+            p.wetLevel = 1.0f;
+            p.dryLevel = 0.0f;
+            p.damping = 0.0f;
+            p.width = 1.0f;
+            return p;
+        }();
+
+        // Processes a stereo impulse response with random block sizes
+        const auto getImpulseResponse = [&] (FDNReverb& reverb, size_t numSamples, int numInputs)
+        {
+            AudioBuffer<float> buffer (2, (int) numSamples);
+            buffer.clear();
+
+            for (int ch = 0; ch < numInputs; ++ch)
+                buffer.setSample (ch, 0, 1.0f);
+
+            AudioBlock<float> block (buffer);
+            Random random (42);
+
+            for (size_t start = 0; start < numSamples;)
+            {
+                auto len = jmin (numSamples - start, (size_t) random.nextInt ({ 1, (int) blockSize }));
+                auto subBlock = block.getSubBlock (start, len);
+                reverb.process (ProcessContextReplacing<float> (subBlock));
+                start += len;
+            }
+
+            return buffer;
+        };
+
+        const auto getEnergy = [] (const AudioBuffer<float>& buffer, int start, int num)
+        {
+            auto energy = 0.0;
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                for (int i = start; i < start + num; ++i)
+                    energy += (double) buffer.getSample (ch, i) * buffer.getSample (ch, i);
+
+            return energy;
+        };
+
+        beginTest ("No latency and no wet signal before the shortest delay");
+        {
+            FDNReverb reverb;
+            auto p = wetOnly;
+            p.dryLevel = 0.5f;
+            reverb.setParameters (p);
+            reverb.prepare ({ sampleRate, (uint32) blockSize, 2 });
+
+            auto ir = getImpulseResponse (reverb, 4096, 2);
+
+            expectWithinAbsoluteError (ir.getSample (0, 0), 1.0f, 1.0e-6f);
+            expectWithinAbsoluteError (ir.getSample (1, 0), 1.0f, 1.0e-6f);
+
+            // the shortest delay line is 20 ms long
+            const auto shortestDelay = (int) (0.02 * sampleRate);
+            expectEquals (getEnergy (ir, 1, shortestDelay - 1), 0.0);
+            expectGreaterThan (getEnergy (ir, shortestDelay, (int) ir.getNumSamples() - shortestDelay), 0.0);
+        }
+
+        beginTest ("Decay time");
+        {
+            for (auto roomSize : { 0.3f, 0.6f })
+            {
+                FDNReverb reverb;
+                auto p = wetOnly;
+                p.roomSize = roomSize;
+                reverb.setParameters (p);
+                reverb.prepare ({ sampleRate, (uint32) blockSize, 2 });
+
+                auto ir = getImpulseResponse (reverb, (size_t) (2.0 * sampleRate), 2);
+
+                // measures the level drop over one second, once the tail is dense
+                const auto window = (int) (0.1 * sampleRate);
+                const auto dB = 10.0 * std::log10 (getEnergy (ir, (int) (1.5 * sampleRate), window)
+                                                     / getEnergy (ir, (int) (0.5 * sampleRate), window));
+
+                const auto rt60 = 0.2 * std::pow (40.0, (double) roomSize);
+                expectWithinAbsoluteError (dB, -60.0 / rt60, 3.0);
+            }
+        }
+
+        beginTest ("Freeze mode");
+        {
+            FDNReverb reverb;
+            reverb.setParameters (wetOnly);
+            reverb.prepare ({ sampleRate, (uint32) blockSize, 2 });
+
+            getImpulseResponse (reverb, (size_t) (0.3 * sampleRate), 2);
+
+            auto p = wetOnly;
+            p.freezeMode = 1.0f;
+            reverb.setParameters (p);
+
+            auto tail = getImpulseResponse (reverb, (size_t) (3.0 * sampleRate), 2);
+
+            // the impulse at the start of the block is ignored in freeze mode
+            const auto window = (int) (0.5 * sampleRate);
+            const auto dB = 10.0 * std::log10 (getEnergy (tail, (int) (2.5 * sampleRate), window)
+                                                 / getEnergy (tail, (int) (0.5 * sampleRate), window));
+
+            expectWithinAbsoluteError (dB, 0.0, 0.5);
+        }
+
+        beginTest ("Stability and mono processing");
+        {
+            for (auto numLines : { 4, 8, 32, 64 })
+            {
+                FDNReverb reverb (numLines);
+                expectEquals (reverb.getNumDelayLines(), numLines);
+
+                auto p = wetOnly;
+                p.roomSize = 1.0f;
+                p.damping = 0.5f;
+                reverb.setParameters (p);
+                reverb.prepare ({ sampleRate, (uint32) blockSize, 1 });
+
+                AudioBuffer<float> buffer (1, (int) sampleRate);
+                Random random (numLines);
+
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    buffer.setSample (0, i, random.nextFloat() * 2.0f - 1.0f);
+
+                AudioBlock<float> block (buffer);
+
+                for (size_t start = 0; start < block.getNumSamples(); start += blockSize)
+                {
+                    auto subBlock = block.getSubBlock (start, jmin (blockSize, block.getNumSamples() - start));
+                    reverb.process (ProcessContextReplacing<float> (subBlock));
+                }
+
+                auto finite = true;
+
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    finite = finite && std::isfinite (buffer.getSample (0, i));
+
+                expect (finite);
+                expectLessThan (buffer.getMagnitude (0, 0, buffer.getNumSamples()), 10.0f);
+                expectGreaterThan (buffer.getRMSLevel (0, buffer.getNumSamples() / 2, buffer.getNumSamples() / 2), 0.01f);
+            }
+        }
+
+        beginTest ("Disabled and bypassed");
+        {
+            FDNReverb reverb;
+            reverb.prepare ({ sampleRate, (uint32) blockSize, 2 });
+
+            AudioBuffer<float> input (2, (int) blockSize), output (2, (int) blockSize);
+            Random random (1);
+
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < (int) blockSize; ++i)
+                    input.setSample (ch, i, random.nextFloat());
+
+            AudioBlock<float> inBlock (input), outBlock (output);
+
+            ProcessContextNonReplacing<float> context (inBlock, outBlock);
+            context.isBypassed = true;
+            reverb.process (context);
+
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < (int) blockSize; ++i)
+                    expectEquals (output.getSample (ch, i), input.getSample (ch, i));
+
+            reverb.setEnabled (false);
+            expect (! reverb.isEnabled());
+            output.clear();
+            reverb.process (ProcessContextNonReplacing<float> (inBlock, outBlock));
+
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < (int) blockSize; ++i)
+                    expectEquals (output.getSample (ch, i), input.getSample (ch, i));
+        }
+    }
+};
+
+static FDNReverbTest fdnReverbUnitTest;
+
+} // namespace dsp
+} // namespace juce
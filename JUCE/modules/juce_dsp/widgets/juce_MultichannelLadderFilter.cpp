@@ -0,0 +1,372 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+//==============================================================================
+template <typename SampleType>
+MultichannelLadderFilter<SampleType>::MultichannelLadderFilter()
+{
+    cutoffFreqScaler = SampleType (-2.0 * MathConstants<double>::pi / sampleRate);
+    setDrive (SampleType (1.2));
+
+    mode = Mode::LPF24;
+    setMode (Mode::LPF12);
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultichannelLadderFilter<SampleType>::setMode (Mode newMode) noexcept
+{
+    if (newMode == mode)
+        return;
+
+    switch (newMode)
+    {
+        case Mode::LPF12:   A = {{ SampleType (0), SampleType (0),  SampleType (1), SampleType (0),  SampleType (0) }}; comp = SampleType (0.5);  break;
+        case Mode::HPF12:   A = {{ SampleType (1), SampleType (-2), SampleType (1), SampleType (0),  SampleType (0) }}; comp = SampleType (0);    break;
+        case Mode::BPF12:   A = {{ SampleType (0), SampleType (0), SampleType (-1), SampleType (1),  SampleType (0) }}; comp = SampleType (0.5);  break;
+        case Mode::LPF24:   A = {{ SampleType (0), SampleType (0),  SampleType (0), SampleType (0),  SampleType (1) }}; comp = SampleType (0.5);  break;
+        case Mode::HPF24:   A = {{ SampleType (1), SampleType (-4), SampleType (6), SampleType (-4), SampleType (1) }}; comp = SampleType (0);    break;
+        case Mode::BPF24:   A = {{ SampleType (0), SampleType (0),  SampleType (1), SampleType (-2), SampleType (1) }}; comp = SampleType (0.5);  break;
+        default:            jassertfalse;                                                                                                         break;
+    }
+
+    static constexpr auto outputGain = SampleType (1.2);
+
+    for (auto& a : A)
+        a *= outputGain;
+
+    mode = newMode;
+    reset();
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultichannelLadderFilter<SampleType>::prepare (const ProcessSpec& spec)
+{
+    jassert (spec.sampleRate > 0);
+    jassert (spec.numChannels > 0);
+
+    sampleRate = spec.sampleRate;
+    cutoffFreqScaler = SampleType (-2.0 * MathConstants<double>::pi / sampleRate);
+    numGroups = (spec.numChannels + numLanes - 1) / numLanes;
+
+    cutoffFreqHz.assign (spec.numChannels, SampleType (200));
+    resonance.assign (spec.numChannels, SampleType (0));
+
+    cutoffTransformSmoothers.resize (spec.numChannels);
+    scaledResonanceSmoothers.resize (spec.numChannels);
+
+    static constexpr double smootherRampTimeSec = 0.05;
+
+    for (size_t channel = 0; channel < spec.numChannels; ++channel)
+    {
+        cutoffTransformSmoothers[channel].reset (sampleRate, smootherRampTimeSec);
+        scaledResonanceSmoothers[channel].reset (sampleRate, smootherRampTimeSec);
+        updateCutoffFreq (channel);
+        updateResonance (channel);
+    }
+
+    auto numGroupLanes = numGroups * numLanes;
+    memory.calloc (numStates * numGroupLanes + 3 * chunkSize * numLanes + numLanes);
+
+    state = snapPointerToAlignment (memory.getData(), sizeof (Vec));
+    interleaved = state + numStates * numGroupLanes;
+    cutoffChunk = interleaved + chunkSize * numLanes;
+    resonanceChunk = cutoffChunk + chunkSize * numLanes;
+
+    reset();
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultichannelLadderFilter<SampleType>::reset() noexcept
+{
+    if (state != nullptr)
+        zeromem (state, sizeof (SampleType) * numStates * numGroups * numLanes);
+
+    for (auto* smoothers : { &cutoffTransformSmoothers, &scaledResonanceSmoothers })
+        for (auto& smoother : *smoothers)
+            smoother.setCurrentAndTargetValue (smoother.getTargetValue());
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultichannelLadderFilter<SampleType>::setCutoffFrequencyHz (size_t channel, SampleType newCutoff) noexcept
+{
+    jassert (channel < getNumChannels());
+    jassert (newCutoff > SampleType (0));
+
+    cutoffFreqHz[channel] = newCutoff;
+    updateCutoffFreq (channel);
+}
+
+template <typename SampleType>
+void MultichannelLadderFilter<SampleType>::setResonance (size_t channel, SampleType newResonance) noexcept
+{
+    jassert (channel < getNumChannels());
+    jassert (newResonance >= SampleType (0) && newResonance <= SampleType (1));
+
+    resonance[channel] = newResonance;
+    updateResonance (channel);
+}
+
+template <typename SampleType>
+void MultichannelLadderFilter<SampleType>::setDrive (SampleType newDrive) noexcept
+{
+    jassert (newDrive >= SampleType (1));
+
+    drive = newDrive;
+    gain = std::pow (drive, SampleType (-2.642))   * SampleType (0.6103) + SampleType (0.3903);
+    drive2 = drive                                 * SampleType (0.04)   + SampleType (0.96);
+    gain2 = std::pow (drive2, SampleType (-2.642)) * SampleType (0.6103) + SampleType (0.3903);
+}
+
+template <typename SampleType>
+void MultichannelLadderFilter<SampleType>::updateCutoffFreq (size_t channel) noexcept
+{
+    cutoffTransformSmoothers[channel].setTargetValue (std::exp (cutoffFreqHz[channel] * cutoffFreqScaler));
+}
+
+template <typename SampleType>
+void MultichannelLadderFilter<SampleType>::updateResonance (size_t channel) noexcept
+{
+    scaledResonanceSmoothers[channel].setTargetValue (jmap (resonance[channel], SampleType (0.1), SampleType (1.0)));
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultichannelLadderFilter<SampleType>::processInternal (const AudioBlock<const SampleType>& inputBlock,
+                                                            AudioBlock<SampleType>& outputBlock,
+                                                            const SampleType* const* modulation) noexcept
+{
+    // If you hit this assertion, you forgot to call prepare
+    jassert (state != nullptr);
+
+    const auto numChannels = outputBlock.getNumChannels();
+    const auto numSamples  = outputBlock.getNumSamples();
+
+    for (size_t start = 0; start < numSamples; start += chunkSize)
+    {
+        auto numToProcess = jmin (chunkSize, numSamples - start);
+
+        for (size_t group = 0; group * numLanes < numChannels; ++group)
+        {
+            auto firstChannel = group * numLanes;
+            auto numGroupChannels = jmin (numLanes, numChannels - firstChannel);
+
+            // Interleaving, the unused lanes being fed with silence
+            if (numGroupChannels < numLanes)
+                zeromem (interleaved, sizeof (SampleType) * numToProcess * numLanes);
+
+            for (size_t lane = 0; lane < numGroupChannels; ++lane)
+            {
+                auto* src = inputBlock.getChannelPointer (firstChannel + lane) + start;
+
+                for (size_t i = 0; i < numToProcess; ++i)
+                    interleaved[i * numLanes + lane] = src[i];
+            }
+
+            computeCoefficients (group, numGroupChannels, start, numToProcess, modulation);
+            processGroup (group, numToProcess);
+
+            // Deinterleaving
+            for (size_t lane = 0; lane < numGroupChannels; ++lane)
+            {
+                auto* dst = outputBlock.getChannelPointer (firstChannel + lane) + start;
+
+                for (size_t i = 0; i < numToProcess; ++i)
+                    dst[i] = interleaved[i * numLanes + lane];
+            }
+        }
+    }
+}
+
+template <typename SampleType>
+void MultichannelLadderFilter<SampleType>::computeCoefficients (size_t group, size_t numGroupChannels,
+                                                                size_t start, size_t numSamples,
+                                                                const SampleType* const* modulation) noexcept
+{
+    auto fill = [numSamples] (SampleType* dst, size_t lane, SampleType value)
+    {
+        for (size_t i = 0; i < numSamples; ++i)
+            dst[i * numLanes + lane] = value;
+    };
+
+    auto smooth = [numSamples] (SampleType* dst, size_t lane, SmoothedValue<SampleType>& smoother)
+    {
+        for (size_t i = 0; i < numSamples; ++i)
+            dst[i * numLanes + lane] = smoother.getNextValue();
+    };
+
+    for (size_t lane = 0; lane < numLanes; ++lane)
+    {
+        auto channel = group * numLanes + lane;
+
+        if (lane >= numGroupChannels)
+        {
+            // Lanes without any input, which can be left silent
+            fill (cutoffChunk, lane, SampleType (0));
+            fill (resonanceChunk, lane, SampleType (0));
+            continue;
+        }
+
+        auto& resonanceSmoother = scaledResonanceSmoothers[channel];
+
+        if (resonanceSmoother.isSmoothing())
+            smooth (resonanceChunk, lane, resonanceSmoother);
+        else
+            fill (resonanceChunk, lane, resonanceSmoother.getCurrentValue());
+
+        auto* frequencies = modulation != nullptr ? modulation[channel] : nullptr;
+
+        if (frequencies != nullptr)
+        {
+            frequencies += start;
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                jassert (frequencies[i] > SampleType (0));
+                cutoffChunk[i * numLanes + lane] = FastMathApproximations::exp (frequencies[i] * cutoffFreqScaler);
+            }
+
+            continue;
+        }
+
+        auto& cutoffSmoother = cutoffTransformSmoothers[channel];
+
+        if (cutoffSmoother.isSmoothing())
+            smooth (cutoffChunk, lane, cutoffSmoother);
+        else
+            fill (cutoffChunk, lane, cutoffSmoother.getCurrentValue());
+    }
+}
+
+template <typename SampleType>
+void MultichannelLadderFilter<SampleType>::processGroup (size_t group, size_t numSamples) noexcept
+{
+    auto numGroupLanes = numGroups * numLanes;
+    auto* groupState = state + group * numLanes;
+
+    Vec s[numStates];
+
+    for (size_t n = 0; n < numStates; ++n)
+        s[n] = load (groupState + n * numGroupLanes);
+
+    const auto one     = Vec (SampleType (1));
+    const auto driveV  = Vec (drive);
+    const auto drive2V = Vec (drive2);
+    const auto gainV   = Vec (gain);
+    const auto gain2V  = Vec (gain2);
+    const auto compV   = Vec (comp);
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        auto* samples = interleaved + i * numLanes;
+
+        const auto a1 = load (cutoffChunk + i * numLanes);
+        const auto g  = one - a1;
+        const auto b0 = g * SampleType (0.76923076923);
+        const auto b1 = g * SampleType (0.23076923076);
+
+        const auto dx = gainV * saturate (driveV * load (samples));
+        const auto a  = dx + load (resonanceChunk + i * numLanes) * SampleType (-4) * (gain2V * saturate (drive2V * s[4]) - dx * compV);
+
+        const auto b = b1 * s[0] + a1 * s[1] + b0 * a;
+        const auto c = b1 * s[1] + a1 * s[2] + b0 * b;
+        const auto d = b1 * s[2] + a1 * s[3] + b0 * c;
+        const auto e = b1 * s[3] + a1 * s[4] + b0 * d;
+
+        s[0] = a;
+        s[1] = b;
+        s[2] = c;
+        s[3] = d;
+        s[4] = e;
+
+        store (samples, a * A[0] + b * A[1] + c * A[2] + d * A[3] + e * A[4]);
+    }
+
+    for (size_t n = 0; n < numStates; ++n)
+        store (groupState + n * numGroupLanes, s[n]);
+}
+
+//==============================================================================
+template <typename SampleType>
+typename MultichannelLadderFilter<SampleType>::Vec JUCE_VECTOR_CALLTYPE
+    MultichannelLadderFilter<SampleType>::saturate (Vec x) noexcept
+{
+    // FastMathApproximations::tanh, limited to the range where it's accurate
+   #if JUCE_USE_SIMD
+    x = Vec::max (Vec (SampleType (-5)), Vec::min (Vec (SampleType (5)), x));
+
+    auto x2 = x * x;
+    auto numerator   = x * (Vec (SampleType (1)) + x2 * (Vec (SampleType (17325.0 / 135135.0)) + x2 * (Vec (SampleType (378.0 / 135135.0)) + x2 * SampleType (1.0 / 135135.0))));
+    auto denominator = Vec (SampleType (1)) + x2 * (Vec (SampleType (62370.0 / 135135.0)) + x2 * (Vec (SampleType (3150.0 / 135135.0)) + x2 * SampleType (28.0 / 135135.0)));
+
+    // SIMDRegister has no division, so the reciprocal of the denominator (between 1 and
+    // about 30 here) starts from a cubic fit in x2, within 43% of it, and is refined with
+    // four Newton-Raphson steps, which leave a relative error below 2e-6
+    auto reciprocal = Vec (SampleType (0.57166191)) + x2 * (Vec (SampleType (-0.075763721)) + x2 * (Vec (SampleType (0.0037749848)) + x2 * SampleType (-6.4628949e-5)));
+
+    for (int i = 0; i < 4; ++i)
+        reciprocal = reciprocal * (Vec (SampleType (2)) - denominator * reciprocal);
+
+    return numerator * reciprocal;
+   #else
+    return FastMathApproximations::tanh (jlimit (SampleType (-5), SampleType (5), x));
+   #endif
+}
+
+template <typename SampleType>
+typename MultichannelLadderFilter<SampleType>::Vec JUCE_VECTOR_CALLTYPE
+    MultichannelLadderFilter<SampleType>::load (const SampleType* src) noexcept
+{
+   #if JUCE_USE_SIMD
+    return Vec::fromRawArray (src);
+   #else
+    return *src;
+   #endif
+}
+
+template <typename SampleType>
+void JUCE_VECTOR_CALLTYPE MultichannelLadderFilter<SampleType>::store (SampleType* dst, Vec value) noexcept
+{
+   #if JUCE_USE_SIMD
+    value.copyToRawArray (dst);
+   #else
+    *dst = value;
+   #endif
+}
+
+//==============================================================================
+template class MultichannelLadderFilter<float>;
+template class MultichannelLadderFilter<double>;
+
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,192 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+/**
+    A bank of LadderFilter, typically one per voice of a polyphonic synthesiser,
+    processed together in the lanes of a SIMDRegister.
+
+    Every channel has its own cutoff frequency and resonance, smoothed the same way
+    as in LadderFilter, and SIMDRegister<SampleType>::size() channels are filtered in
+    a single recursion, as in IIR::MultichannelFilter. The mode and the drive are shared
+    by all the channels. The saturation uses the rational approximation from
+    FastMathApproximations::tanh, computed on all the lanes at once.
+
+    The cutoff frequencies can also be modulated on every sample, by passing one
+    buffer of frequencies per channel to process(). In that case the frequencies
+    aren't smoothed, and the coefficients are computed for a whole chunk of samples
+    at a time before running the recursion.
+
+    @see LadderFilter
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class MultichannelLadderFilter
+{
+public:
+    //==============================================================================
+    using Mode = LadderFilterMode;
+
+    //==============================================================================
+    /** Creates an uninitialised filter. Call prepare() before first use. */
+    MultichannelLadderFilter();
+
+    /** Enables or disables the filter. If disabled it will simply pass through the input signal. */
+    void setEnabled (bool isEnabled) noexcept    { enabled = isEnabled; }
+
+    /** Sets the mode of every channel of the filter. */
+    void setMode (Mode newMode) noexcept;
+
+    /** Initialises the filter. Every channel starts with a cutoff frequency of 200 Hz
+        and no resonance.
+    */
+    void prepare (const ProcessSpec& spec);
+
+    /** Returns the current number of channels. */
+    size_t getNumChannels() const noexcept       { return cutoffFreqHz.size(); }
+
+    /** Resets the internal state variables of the filter. */
+    void reset() noexcept;
+
+    /** Sets the cutoff frequency of a channel.
+
+        @param channel      the channel to modify
+        @param newCutoff    cutoff frequency in Hz
+    */
+    void setCutoffFrequencyHz (size_t channel, SampleType newCutoff) noexcept;
+
+    /** Sets the resonance of a channel.
+
+        @param channel          the channel to modify
+        @param newResonance     a value between 0 and 1; higher values increase the resonance and can result in self oscillation!
+    */
+    void setResonance (size_t channel, SampleType newResonance) noexcept;
+
+    /** Sets the amount of saturation of every channel of the filter.
+
+        @param newDrive saturation amount; it can be any number greater than or equal to one. Higher values result in more distortion.
+    */
+    void setDrive (SampleType newDrive) noexcept;
+
+    //==============================================================================
+    /** Processes the input and output samples supplied in the processing context,
+        using the cutoff frequencies set with setCutoffFrequencyHz.
+    */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        process (context, nullptr);
+    }
+
+    /** Processes the input and output samples supplied in the processing context,
+        with a cutoff frequency in Hz for every sample of every channel.
+
+        @param context              the processing context
+        @param cutoffFrequencies    an array of one buffer of frequencies per channel,
+                                    with as many samples as the context. Some of the
+                                    buffers can be null, in which case the channel
+                                    uses the frequency set with setCutoffFrequencyHz.
+    */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context, const SampleType* const* cutoffFrequencies) noexcept
+    {
+        static_assert (std::is_same<typename ProcessContext::SampleType, SampleType>::value,
+                       "The sample-type of the filter must match the sample-type supplied to this process callback");
+
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock      = context.getOutputBlock();
+
+        jassert (inputBlock.getNumChannels() <= getNumChannels());
+        jassert (inputBlock.getNumChannels() == outputBlock.getNumChannels());
+        jassert (inputBlock.getNumSamples()  == outputBlock.getNumSamples());
+
+        if (! enabled || context.isBypassed)
+        {
+            outputBlock.copyFrom (inputBlock);
+            return;
+        }
+
+        processInternal (inputBlock, outputBlock, cutoffFrequencies);
+    }
+
+private:
+    //==============================================================================
+   #if JUCE_USE_SIMD
+    using Vec = SIMDRegister<SampleType>;
+    static constexpr size_t numLanes = Vec::SIMDNumElements;
+   #else
+    using Vec = SampleType;
+    static constexpr size_t numLanes = 1;
+   #endif
+
+    static constexpr size_t chunkSize = 64;
+    static constexpr size_t numStates = 5;
+
+    void processInternal (const AudioBlock<const SampleType>&, AudioBlock<SampleType>&,
+                          const SampleType* const*) noexcept;
+    void computeCoefficients (size_t group, size_t numGroupChannels, size_t start, size_t numSamples,
+                              const SampleType* const* cutoffFrequencies) noexcept;
+    void processGroup (size_t group, size_t numSamples) noexcept;
+
+    void updateCutoffFreq (size_t channel) noexcept;
+    void updateResonance (size_t channel) noexcept;
+
+    static Vec JUCE_VECTOR_CALLTYPE saturate (Vec) noexcept;
+    static Vec JUCE_VECTOR_CALLTYPE load (const SampleType*) noexcept;
+    static void JUCE_VECTOR_CALLTYPE store (SampleType*, Vec) noexcept;
+
+    //==============================================================================
+    SampleType drive, drive2, gain, gain2, comp;
+    std::array<SampleType, numStates> A;
+
+    std::vector<SampleType> cutoffFreqHz, resonance;
+    std::vector<SmoothedValue<SampleType>> cutoffTransformSmoothers, scaledResonanceSmoothers;
+
+    // Interleaved by groups of numLanes channels
+    HeapBlock<SampleType> memory;
+    SampleType* state = nullptr;
+
+    // Scratch buffers for the samples and coefficients of a chunk
+    SampleType* interleaved = nullptr;
+    SampleType* cutoffChunk = nullptr;
+    SampleType* resonanceChunk = nullptr;
+
+    double sampleRate = 44100.0;
+    SampleType cutoffFreqScaler;
+    size_t numGroups = 0;
+
+    Mode mode;
+    bool enabled = true;
+
+    JUCE_LEAK_DETECTOR (MultichannelLadderFilter)
+};
+
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,200 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class MultichannelLadderFilterTest : public UnitTest
+{
+public:
+    MultichannelLadderFilterTest()
+        : UnitTest ("Multichannel LadderFilter", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Matches LadderFilter");
+        {
+            runComparisonTest<float>();
+            runComparisonTest<double>();
+        }
+
+        beginTest ("Per-sample cutoff modulation");
+        {
+            runModulationTest();
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr size_t numChannels = 11;
+
+    template <typename SampleType>
+    static void fillRandom (AudioBuffer<SampleType>& buffer)
+    {
+        Random random (1234);
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (ch, i, static_cast<SampleType> (random.nextFloat() - 0.5f));
+    }
+
+    template <typename SampleType>
+    void runComparisonTest()
+    {
+        constexpr size_t numSamples = 6000, blockSize = 300;
+        using Mode = LadderFilterMode;
+
+        AudioBuffer<SampleType> input ((int) numChannels, (int) numSamples), output ((int) numChannels, (int) numSamples);
+        fillRandom (input);
+
+        for (auto mode : { Mode::LPF12, Mode::HPF12, Mode::BPF12, Mode::LPF24, Mode::HPF24, Mode::BPF24 })
+        {
+            MultichannelLadderFilter<SampleType> filter;
+            filter.setMode (mode);
+            filter.setDrive (SampleType (2));
+            filter.prepare ({ sampleRate, (uint32) blockSize, (uint32) numChannels });
+
+            std::vector<std::unique_ptr<LadderFilter<SampleType>>> references;
+
+            for (size_t ch = 0; ch < numChannels; ++ch)
+            {
+                references.emplace_back (new LadderFilter<SampleType>());
+                references.back()->setMode (mode);
+                references.back()->setDrive (SampleType (2));
+                references.back()->prepare ({ sampleRate, (uint32) blockSize, 1 });
+            }
+
+            auto setParameters = [&] (size_t ch, double cutoff, double resonance)
+            {
+                filter.setCutoffFrequencyHz (ch, static_cast<SampleType> (cutoff));
+                filter.setResonance (ch, static_cast<SampleType> (resonance));
+                references[ch]->setCutoffFrequencyHz (static_cast<SampleType> (cutoff));
+                references[ch]->setResonance (static_cast<SampleType> (resonance));
+            };
+
+            for (size_t ch = 0; ch < numChannels; ++ch)
+                setParameters (ch, 200.0 * (double) (ch + 1), 0.05 * (double) ch);
+
+            filter.reset();
+
+            for (auto& reference : references)
+                reference->reset();
+
+            for (size_t start = 0; start < numSamples; start += blockSize)
+            {
+                // Changing the parameters of some channels, which are then smoothed
+                if (start == numSamples / 2)
+                {
+                    for (size_t ch = 0; ch < numChannels; ch += 2)
+                    {
+                        filter.setCutoffFrequencyHz (ch, static_cast<SampleType> (3000.0 / (double) (ch + 1)));
+                        filter.setResonance (ch, static_cast<SampleType> (0.6 - 0.05 * (double) ch));
+                    }
+                }
+
+                AudioBlock<const SampleType> inBlock (input.getArrayOfReadPointers(), numChannels, start, blockSize);
+                AudioBlock<SampleType> outBlock (output.getArrayOfWritePointers(), numChannels, start, blockSize);
+                filter.process (ProcessContextNonReplacing<SampleType> (inBlock, outBlock));
+            }
+
+            AudioBuffer<SampleType> expected ((int) numChannels, (int) numSamples);
+            auto maxError = 0.0;
+
+            for (size_t ch = 0; ch < numChannels; ++ch)
+            {
+                for (size_t start = 0; start < numSamples; start += blockSize)
+                {
+                    if (start == numSamples / 2 && ch % 2 == 0)
+                    {
+                        references[ch]->setCutoffFrequencyHz (static_cast<SampleType> (3000.0 / (double) (ch + 1)));
+                        references[ch]->setResonance (static_cast<SampleType> (0.6 - 0.05 * (double) ch));
+                    }
+
+                    auto* src = input.getReadPointer ((int) ch, (int) start);
+                    auto* dst = expected.getWritePointer ((int) ch, (int) start);
+                    AudioBlock<const SampleType> inBlock (&src, 1, blockSize);
+                    AudioBlock<SampleType> outBlock (&dst, 1, blockSize);
+                    references[ch]->process (ProcessContextNonReplacing<SampleType> (inBlock, outBlock));
+                }
+
+                for (int i = 0; i < (int) numSamples; ++i)
+                    maxError = jmax (maxError, (double) std::abs (output.getSample ((int) ch, i) - expected.getSample ((int) ch, i)));
+            }
+
+            // (the saturation of LadderFilter uses a lookup table)
+            expectLessThan (maxError, 2.0e-3);
+        }
+    }
+
+    void runModulationTest()
+    {
+        constexpr size_t numSamples = 2048;
+
+        AudioBuffer<float> input ((int) numChannels, (int) numSamples), output ((int) numChannels, (int) numSamples),
+                           expected ((int) numChannels, (int) numSamples), cutoffs ((int) numChannels, (int) numSamples);
+        fillRandom (input);
+
+        MultichannelLadderFilter<float> filter, reference;
+
+        for (auto* f : { &filter, &reference })
+        {
+            f->setMode (LadderFilterMode::LPF24);
+            f->prepare ({ sampleRate, (uint32) numSamples, (uint32) numChannels });
+
+            for (size_t ch = 0; ch < numChannels; ++ch)
+            {
+                f->setCutoffFrequencyHz (ch, 500.0f * (float) (ch + 1));
+                f->setResonance (ch, 0.5f);
+            }
+
+            f->reset();
+        }
+
+        // Constant buffers of frequencies must give the same result as the static cutoffs
+        for (size_t ch = 0; ch < numChannels; ++ch)
+            FloatVectorOperations::fill (cutoffs.getWritePointer ((int) ch), 500.0f * (float) (ch + 1), (int) numSamples);
+
+        AudioBlock<const float> inBlock (input);
+        AudioBlock<float> outBlock (output), expectedBlock (expected);
+        filter.process (ProcessContextNonReplacing<float> (inBlock, outBlock), cutoffs.getArrayOfReadPointers());
+        reference.process (ProcessContextNonReplacing<float> (inBlock, expectedBlock));
+
+        auto maxError = 0.0f;
+
+        for (int ch = 0; ch < (int) numChannels; ++ch)
+            for (int i = 0; i < (int) numSamples; ++i)
+                maxError = jmax (maxError, std::abs (output.getSample (ch, i) - expected.getSample (ch, i)));
+
+        expectLessThan (maxError, 1.0e-3f);
+    }
+};
+
+static MultichannelLadderFilterTest multichannelLadderFilterUnitTest;
+
+} // namespace dsp
+} // namespace juce
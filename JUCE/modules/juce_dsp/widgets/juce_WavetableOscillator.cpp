@@ -0,0 +1,337 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+//==============================================================================
+template <typename SampleType>
+WavetableOscillator<SampleType>::Wavetable::Wavetable (const SampleType* cycleSamples, size_t numSamples)
+    : tableSize (numSamples)
+{
+    build (cycleSamples);
+}
+
+template <typename SampleType>
+WavetableOscillator<SampleType>::Wavetable::Wavetable (const std::function<SampleType (SampleType)>& function,
+                                                       size_t newTableSize)
+    : tableSize (newTableSize)
+{
+    HeapBlock<SampleType> cycle (tableSize);
+
+    for (size_t i = 0; i < tableSize; ++i)
+        cycle[i] = function (static_cast<SampleType> (MathConstants<double>::twoPi * (double) i / (double) tableSize
+                                                       - MathConstants<double>::pi));
+
+    build (cycle);
+}
+
+template <typename SampleType>
+void WavetableOscillator<SampleType>::Wavetable::build (const SampleType* cycleSamples)
+{
+    jassert (isPowerOfTwo (tableSize) && tableSize >= 8);
+
+    auto order = roundToInt (std::log2 ((double) tableSize));
+    FFT fft (order);
+
+    // Every table keeps half the harmonics of the previous one, down to a sine
+    numTables = static_cast<size_t> (order);
+    tables.malloc (numTables * (tableSize + 4));
+
+    HeapBlock<float> spectrum (2 * tableSize, true), buffer (2 * tableSize);
+
+    for (size_t i = 0; i < tableSize; ++i)
+        spectrum[i] = static_cast<float> (cycleSamples[i]);
+
+    fft.performRealOnlyForwardTransform (spectrum, true);
+
+    for (size_t n = 0; n < numTables; ++n)
+    {
+        auto maxHarmonic = (tableSize / 2) >> n;
+
+        FloatVectorOperations::copy (buffer, spectrum, (int) (2 * (maxHarmonic + 1)));
+        FloatVectorOperations::clear (buffer + 2 * (maxHarmonic + 1), (int) (2 * (tableSize - maxHarmonic - 1)));
+        fft.performRealOnlyInverseTransform (buffer);
+
+        auto* table = tables + n * (tableSize + 4) + 1;
+
+        for (size_t i = 0; i < tableSize; ++i)
+            table[i] = static_cast<SampleType> (buffer[i]);
+
+        // Wrapped samples for the interpolation
+        table[-1]            = table[tableSize - 1];
+        table[tableSize]     = table[0];
+        table[tableSize + 1] = table[1];
+        table[tableSize + 2] = 0;
+    }
+}
+
+template <typename SampleType>
+size_t WavetableOscillator<SampleType>::Wavetable::getTableIndexForIncrement (SampleType cyclesPerSample) const noexcept
+{
+    size_t n = 0;
+
+    while (n + 1 < numTables && static_cast<SampleType> ((tableSize / 2) >> n) * cyclesPerSample > static_cast<SampleType> (0.5))
+        ++n;
+
+    return n;
+}
+
+template <typename SampleType>
+const SampleType* WavetableOscillator<SampleType>::Wavetable::getTable (size_t tableIndex) const noexcept
+{
+    jassert (tableIndex < numTables);
+    return tables + tableIndex * (tableSize + 4) + 1;
+}
+
+//==============================================================================
+template <typename SampleType>
+WavetableOscillator<SampleType>::WavetableOscillator (typename Wavetable::Ptr wavetableToUse, size_t numVoices)
+    : wavetable (std::move (wavetableToUse))
+{
+    setNumVoices (numVoices);
+}
+
+template <typename SampleType>
+void WavetableOscillator<SampleType>::setWavetable (typename Wavetable::Ptr newWavetable) noexcept
+{
+    auto oldSize = wavetable != nullptr ? wavetable->getTableSize() : 0;
+    wavetable = std::move (newWavetable);
+
+    if (wavetable == nullptr)
+        return;
+
+    auto ratio = oldSize > 0 ? static_cast<SampleType> (wavetable->getTableSize()) / static_cast<SampleType> (oldSize)
+                             : static_cast<SampleType> (0);
+
+    for (size_t voice = 0; voice < getNumVoices(); ++voice)
+    {
+        positions[voice] *= ratio;
+        updateIncrement (voice);
+    }
+}
+
+template <typename SampleType>
+void WavetableOscillator<SampleType>::setNumVoices (size_t newNumVoices)
+{
+    frequencies .resize (newNumVoices, static_cast<SampleType> (440.0));
+    gains       .resize (newNumVoices, static_cast<SampleType> (1.0));
+    positions   .resize (newNumVoices, static_cast<SampleType> (0.0));
+    increments  .resize (newNumVoices, static_cast<SampleType> (0.0));
+    tableIndices.resize (newNumVoices, 0);
+
+    for (size_t voice = 0; voice < newNumVoices; ++voice)
+        updateIncrement (voice);
+}
+
+template <typename SampleType>
+void WavetableOscillator<SampleType>::setFrequency (size_t voice, SampleType newFrequencyHz) noexcept
+{
+    jassert (newFrequencyHz >= 0 && newFrequencyHz < static_cast<SampleType> (sampleRate * 0.5));
+
+    frequencies[voice] = newFrequencyHz;
+    updateIncrement (voice);
+}
+
+template <typename SampleType>
+void WavetableOscillator<SampleType>::setPhase (size_t voice, SampleType newPhase) noexcept
+{
+    jassert (newPhase >= 0 && newPhase < 1);
+
+    if (wavetable != nullptr)
+        positions[voice] = newPhase * static_cast<SampleType> (wavetable->getTableSize());
+}
+
+template <typename SampleType>
+void WavetableOscillator<SampleType>::updateIncrement (size_t voice) noexcept
+{
+    if (wavetable == nullptr)
+        return;
+
+    auto cyclesPerSample = static_cast<SampleType> (frequencies[voice] / sampleRate);
+
+    increments[voice]   = cyclesPerSample * static_cast<SampleType> (wavetable->getTableSize());
+    tableIndices[voice] = wavetable->getTableIndexForIncrement (cyclesPerSample);
+}
+
+//==============================================================================
+template <typename SampleType>
+void WavetableOscillator<SampleType>::prepare (const ProcessSpec& spec)
+{
+    jassert (spec.sampleRate > 0);
+
+    sampleRate = spec.sampleRate;
+    mixBuffer.resize ((int) spec.maximumBlockSize);
+
+    // 6 aligned arrays of chunkSize samples: the four neighbours, the fractional
+    // positions and the interpolated output
+    scratchMemory.calloc (6 * chunkSize + 16);
+    scratch = snapPointerToAlignment (scratchMemory.getData(), static_cast<size_t> (16 * sizeof (SampleType)));
+
+    for (size_t voice = 0; voice < getNumVoices(); ++voice)
+        updateIncrement (voice);
+
+    reset();
+}
+
+template <typename SampleType>
+void WavetableOscillator<SampleType>::reset() noexcept
+{
+    std::fill (positions.begin(), positions.end(), static_cast<SampleType> (0));
+}
+
+//==============================================================================
+template <typename SampleType>
+void WavetableOscillator<SampleType>::renderVoices (SampleType* const* voiceOutputs, size_t numSamples) noexcept
+{
+    for (size_t voice = 0; voice < getNumVoices(); ++voice)
+    {
+        if (wavetable == nullptr)
+            FloatVectorOperations::clear (voiceOutputs[voice], (int) numSamples);
+        else
+            renderVoice (voice, voiceOutputs[voice], numSamples, false);
+    }
+}
+
+template <typename SampleType>
+void WavetableOscillator<SampleType>::renderMix (SampleType* output, size_t numSamples) noexcept
+{
+    FloatVectorOperations::clear (output, (int) numSamples);
+
+    if (wavetable == nullptr)
+        return;
+
+    for (size_t voice = 0; voice < getNumVoices(); ++voice)
+        if (gains[voice] != static_cast<SampleType> (0))
+            renderVoice (voice, output, numSamples, true);
+        else
+            positions[voice] = std::fmod (positions[voice] + increments[voice] * static_cast<SampleType> (numSamples),
+                                          static_cast<SampleType> (wavetable->getTableSize()));
+}
+
+template <typename SampleType>
+void WavetableOscillator<SampleType>::advance (size_t numSamples) noexcept
+{
+    if (wavetable == nullptr)
+        return;
+
+    for (size_t voice = 0; voice < getNumVoices(); ++voice)
+        positions[voice] = std::fmod (positions[voice] + increments[voice] * static_cast<SampleType> (numSamples),
+                                      static_cast<SampleType> (wavetable->getTableSize()));
+}
+
+template <typename SampleType>
+void WavetableOscillator<SampleType>::renderVoice (size_t voice, SampleType* output,
+                                                   size_t numSamples, bool addToOutput) noexcept
+{
+    // If you hit this assertion, you forgot to call prepare
+    jassert (scratch != nullptr);
+
+    auto* table = wavetable->getTable (tableIndices[voice]);
+    auto size = static_cast<SampleType> (wavetable->getTableSize());
+    auto position = positions[voice];
+    auto increment = increments[voice];
+    auto gain = gains[voice];
+
+    auto* y0 = scratch;
+    auto* y1 = y0 + chunkSize;
+    auto* y2 = y1 + chunkSize;
+    auto* y3 = y2 + chunkSize;
+    auto* t  = y3 + chunkSize;
+    auto* out = t + chunkSize;
+
+    for (size_t start = 0; start < numSamples; start += chunkSize)
+    {
+        auto num = jmin (chunkSize, numSamples - start);
+
+        // Gathering the neighbours of every reading position
+        for (size_t i = 0; i < num; ++i)
+        {
+            auto index = static_cast<int> (position);
+
+            t[i]  = position - static_cast<SampleType> (index);
+            y0[i] = table[index - 1];
+            y1[i] = table[index];
+            y2[i] = table[index + 1];
+            y3[i] = table[index + 2];
+
+            position += increment;
+
+            if (position >= size)
+                position -= size;
+        }
+
+        // Cubic (Catmull-Rom) interpolation
+       #if JUCE_USE_SIMD
+        using Vec = SIMDRegister<SampleType>;
+
+        const auto half     = Vec::expand (static_cast<SampleType> (0.5));
+        const auto oneHalf  = Vec::expand (static_cast<SampleType> (1.5));
+        const auto two      = Vec::expand (static_cast<SampleType> (2.0));
+        const auto twoHalf  = Vec::expand (static_cast<SampleType> (2.5));
+        const auto gainVec  = Vec::expand (gain);
+
+        for (size_t i = 0; i < num; i += Vec::SIMDNumElements)
+        {
+            auto a = Vec::fromRawArray (y0 + i);
+            auto b = Vec::fromRawArray (y1 + i);
+            auto c = Vec::fromRawArray (y2 + i);
+            auto d = Vec::fromRawArray (y3 + i);
+            auto x = Vec::fromRawArray (t  + i);
+
+            auto c1 = (c - a) * half;
+            auto c2 = a - b * twoHalf + c * two - d * half;
+            auto c3 = (d - a) * half + (b - c) * oneHalf;
+
+            ((((c3 * x + c2) * x + c1) * x + b) * gainVec).copyToRawArray (out + i);
+        }
+       #else
+        for (size_t i = 0; i < num; ++i)
+        {
+            auto c1 = (y2[i] - y0[i]) * static_cast<SampleType> (0.5);
+            auto c2 = y0[i] - y1[i] * static_cast<SampleType> (2.5) + y2[i] * static_cast<SampleType> (2.0) - y3[i] * static_cast<SampleType> (0.5);
+            auto c3 = (y3[i] - y0[i]) * static_cast<SampleType> (0.5) + (y1[i] - y2[i]) * static_cast<SampleType> (1.5);
+
+            out[i] = (((c3 * t[i] + c2) * t[i] + c1) * t[i] + y1[i]) * gain;
+        }
+       #endif
+
+        if (addToOutput)
+            FloatVectorOperations::add (output + start, out, (int) num);
+        else
+            FloatVectorOperations::copy (output + start, out, (int) num);
+    }
+
+    positions[voice] = position;
+}
+
+//==============================================================================
+template class WavetableOscillator<float>;
+template class WavetableOscillator<double>;
+
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,223 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+/**
+    A bank of oscillators reading a band-limited wavetable.
+
+    The wavetable holds one cycle of a waveform, along with a band-limited version
+    of it for every octave (a mip-map), computed with FFT by removing the harmonics
+    which would alias at higher frequencies. Every voice of the bank picks the table
+    matching its frequency, and reads it with cubic interpolation, which is computed
+    with SIMD instructions on blocks of samples.
+
+    The voices can be rendered into separate buffers with renderVoices, for example
+    to apply an envelope to each note of a polyphonic synthesiser, or mixed together
+    with their gains using process.
+
+    @see Oscillator
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class WavetableOscillator
+{
+public:
+    //==============================================================================
+    /** One cycle of a waveform, stored along with its band-limited versions.
+
+        Wavetables are ref-counted, so the same one can be shared by several
+        oscillators. The tables are computed with single precision FFTs, whatever
+        the sample type is.
+    */
+    class Wavetable  : public ReferenceCountedObject
+    {
+    public:
+        /** A handy typedef for a ref-counted pointer to a wavetable. */
+        using Ptr = ReferenceCountedObjectPtr<Wavetable>;
+
+        /** Creates a wavetable from one cycle of a waveform. The number of samples
+            must be a power of two, and at least 8.
+        */
+        Wavetable (const SampleType* cycleSamples, size_t numSamples);
+
+        /** Creates a wavetable by sampling a periodic function over -pi..pi, the same
+            way Oscillator does. The table size must be a power of two, and at least 8.
+        */
+        Wavetable (const std::function<SampleType (SampleType)>& function, size_t tableSize = 2048);
+
+        /** Returns the number of samples in one cycle of the waveform. */
+        size_t getTableSize() const noexcept        { return tableSize; }
+
+        /** Returns the number of band-limited tables, one per octave. */
+        size_t getNumTables() const noexcept        { return numTables; }
+
+        /** Returns the index of the table which can be played without aliasing at the
+            given phase increment, in cycles per sample.
+        */
+        size_t getTableIndexForIncrement (SampleType cyclesPerSample) const noexcept;
+
+        /** Returns the samples of a table. The samples at indexes -1, getTableSize()
+            and getTableSize() + 1 are also valid, and wrap around the cycle.
+        */
+        const SampleType* getTable (size_t tableIndex) const noexcept;
+
+    private:
+        void build (const SampleType* cycleSamples);
+
+        size_t tableSize = 0, numTables = 0;
+        HeapBlock<SampleType> tables;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Wavetable)
+    };
+
+    //==============================================================================
+    /** Creates an oscillator bank without any wavetable, which produces silence. */
+    WavetableOscillator() = default;
+
+    /** Creates an oscillator bank using a wavetable. */
+    explicit WavetableOscillator (typename Wavetable::Ptr wavetableToUse, size_t numVoices = 1);
+
+    //==============================================================================
+    /** Sets the wavetable used by all the voices, keeping their current phases. */
+    void setWavetable (typename Wavetable::Ptr newWavetable) noexcept;
+
+    /** Returns the wavetable used by the voices. */
+    typename Wavetable::Ptr getWavetable() const noexcept       { return wavetable; }
+
+    /** Sets the number of voices. This allocates memory, so shouldn't be called
+        from the audio thread.
+    */
+    void setNumVoices (size_t newNumVoices);
+
+    /** Returns the number of voices. */
+    size_t getNumVoices() const noexcept                        { return frequencies.size(); }
+
+    //==============================================================================
+    /** Sets the frequency of a voice in Hz, which must be lower than half the
+        sample rate.
+    */
+    void setFrequency (size_t voice, SampleType newFrequencyHz) noexcept;
+
+    /** Returns the frequency of a voice in Hz. */
+    SampleType getFrequency (size_t voice) const noexcept       { return frequencies[voice]; }
+
+    /** Sets the gain of a voice, used when mixing the voices together and when
+        rendering them separately. The default gain is 1.
+    */
+    void setGain (size_t voice, SampleType newGain) noexcept    { gains[voice] = newGain; }
+
+    /** Returns the gain of a voice. */
+    SampleType getGain (size_t voice) const noexcept            { return gains[voice]; }
+
+    /** Sets the phase of a voice, in cycles between 0 and 1. */
+    void setPhase (size_t voice, SampleType newPhase) noexcept;
+
+    //==============================================================================
+    /** Called before processing starts. */
+    void prepare (const ProcessSpec& spec);
+
+    /** Resets the phase of every voice. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Returns the input sample plus the next sample of all the voices mixed together. */
+    SampleType processSample (SampleType input) noexcept
+    {
+        SampleType output;
+        renderMix (&output, 1);
+        return input + output;
+    }
+
+    /** Processes the input and output buffers supplied in the processing context,
+        adding the mix of all the voices to every output channel.
+    */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        auto&& outBlock = context.getOutputBlock();
+        auto&& inBlock  = context.getInputBlock();
+
+        auto len           = outBlock.getNumSamples();
+        auto numChannels   = outBlock.getNumChannels();
+        auto inputChannels = inBlock.getNumChannels();
+
+        jassert (len <= static_cast<size_t> (mixBuffer.size()));
+
+        if (context.isBypassed)
+        {
+            outBlock.clear();
+            advance (len);
+            return;
+        }
+
+        auto* mix = mixBuffer.getRawDataPointer();
+        renderMix (mix, len);
+
+        for (size_t ch = 0; ch < numChannels; ++ch)
+        {
+            auto* dst = outBlock.getChannelPointer (ch);
+
+            if (ch < inputChannels)
+                FloatVectorOperations::add (dst, inBlock.getChannelPointer (ch), mix, (int) len);
+            else
+                FloatVectorOperations::copy (dst, mix, (int) len);
+        }
+    }
+
+    /** Renders every voice into its own buffer, replacing the content of the buffers.
+
+        @param voiceOutputs     an array of getNumVoices() pointers to the destination buffers
+        @param numSamples       the number of samples to render
+    */
+    void renderVoices (SampleType* const* voiceOutputs, size_t numSamples) noexcept;
+
+private:
+    //==============================================================================
+    static constexpr size_t chunkSize = 64;
+
+    void renderMix (SampleType* output, size_t numSamples) noexcept;
+    void renderVoice (size_t voice, SampleType* output, size_t numSamples, bool addToOutput) noexcept;
+    void advance (size_t numSamples) noexcept;
+    void updateIncrement (size_t voice) noexcept;
+
+    //==============================================================================
+    typename Wavetable::Ptr wavetable;
+    double sampleRate = 44100.0;
+
+    std::vector<SampleType> frequencies, gains, positions, increments;
+    std::vector<size_t> tableIndices;
+    Array<SampleType> mixBuffer;
+
+    HeapBlock<SampleType> scratchMemory;
+    SampleType* scratch = nullptr;
+};
+
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 6 End-User License
+   Agreement and JUCE Privacy Policy (both effective as of the 16th June 2020).
+
+   End User License Agreement: www.juce.com/juce-6-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class WavetableOscillatorTest : public UnitTest
+{
+public:
+    WavetableOscillatorTest()
+        : UnitTest ("Wavetable Oscillator", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr size_t blockSize = 512;
+
+        beginTest ("Sine wavetable");
+        {
+            using Osc = WavetableOscillator<float>;
+            Osc osc (new Osc::Wavetable ([] (float x) { return std::sin (x); }), 1);
+            osc.prepare ({ sampleRate, (uint32) blockSize, 1 });
+            osc.setFrequency (0, 1000.0f);
+
+            auto maxError = 0.0;
+
+            // The function is sampled over -pi..pi, so the first sample is sin (-pi)
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto expected = std::sin (-MathConstants<double>::pi + MathConstants<double>::twoPi * 1000.0 * i / sampleRate);
+                maxError = jmax (maxError, std::abs ((double) osc.processSample (0.0f) - expected));
+            }
+
+            expectLessThan (maxError, 1.0e-3);
+        }
+
+        beginTest ("Band-limited tables");
+        {
+            constexpr int fftOrder = 12;
+            constexpr int fftSize = 1 << fftOrder;
+            constexpr int bin = 427;
+
+            using Osc = WavetableOscillator<float>;
+            Osc osc (new Osc::Wavetable ([] (float x) { return x / MathConstants<float>::pi; }), 1);
+            osc.prepare ({ sampleRate, (uint32) fftSize, 1 });
+            osc.setFrequency (0, (float) (bin * sampleRate / fftSize));
+
+            // The harmonics above Nyquist of a naive sawtooth would alias between the
+            // multiples of the fundamental bin
+            HeapBlock<float> buffer (2 * fftSize, true);
+            auto* data = buffer.get();
+            AudioBlock<float> block (&data, 1, (size_t) fftSize);
+            osc.process (ProcessContextReplacing<float> (block));
+
+            FFT fft (fftOrder);
+            fft.performFrequencyOnlyForwardTransform (buffer);
+
+            auto fundamental = buffer[bin];
+            auto maxOther = 0.0f;
+
+            for (int i = 1; i < fftSize / 2; ++i)
+                if (i % bin != 0)
+                    maxOther = jmax (maxOther, buffer[i]);
+
+            expectGreaterThan (fundamental, 0.0f);
+            expectLessThan (Decibels::gainToDecibels (maxOther / fundamental), -60.0f);
+        }
+
+        beginTest ("Separate voices and mix");
+        {
+            constexpr size_t numVoices = 5;
+
+            using Osc = WavetableOscillator<double>;
+            Osc::Wavetable::Ptr wavetable (new Osc::Wavetable ([] (double x) { return x < 0 ? -1.0 : 1.0; }, 1024));
+
+            Osc voices (wavetable, numVoices), mix (wavetable, numVoices);
+
+            for (auto* osc : { &voices, &mix })
+            {
+                osc->prepare ({ sampleRate, (uint32) blockSize, 2 });
+
+                for (size_t v = 0; v < numVoices; ++v)
+                {
+                    osc->setFrequency (v, 110.0 * (double) (v + 1) + 3.0);
+                    osc->setGain (v, 1.0 / (double) (v + 1));
+                }
+            }
+
+            AudioBuffer<double> voiceBuffers ((int) numVoices, (int) blockSize), mixBuffer (2, (int) blockSize);
+            mixBuffer.clear();
+
+            for (int i = 0; i < 3; ++i)
+            {
+                voices.renderVoices (voiceBuffers.getArrayOfWritePointers(), blockSize);
+
+                AudioBlock<double> block (mixBuffer);
+                block.fill (0.25);
+                mix.process (ProcessContextReplacing<double> (block));
+
+                auto maxError = 0.0;
+
+                for (size_t s = 0; s < blockSize; ++s)
+                {
+                    auto sum = 0.25;
+
+                    for (size_t v = 0; v < numVoices; ++v)
+                        sum += voiceBuffers.getSample ((int) v, (int) s);
+
+                    for (int ch = 0; ch < 2; ++ch)
+                        maxError = jmax (maxError, std::abs (mixBuffer.getSample (ch, (int) s) - sum));
+                }
+
+                expectLessThan (maxError, 1.0e-9);
+            }
+        }
+    }
+};
+
+static WavetableOscillatorTest wavetableOscillatorUnitTest;
+
+} // namespace dsp
+} // namespace juce